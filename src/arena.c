@@ -0,0 +1,60 @@
+#include <arena.h>
+#include <stdio.h>
+
+#define CHUNK_SIZE (1 << 20)
+#define ALIGNMENT 16
+
+struct Arena arena_create()
+{
+	return (struct Arena){0};
+}
+
+void arena_destroy(struct Arena arena)
+{
+	struct ArenaChunk *chunk = arena.chunks;
+
+	while (chunk != NULL) {
+		struct ArenaChunk *next = chunk->next;
+
+		free(chunk);
+
+		chunk = next;
+	}
+}
+
+void *arena_alloc(struct Arena *arena, size_t size)
+{
+	size = (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+
+	struct ArenaChunk *chunk = arena->chunks;
+
+	if (chunk == NULL || chunk->capacity - chunk->size < size) {
+		// Oversized requests get a chunk of their own
+
+		size_t capacity = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+
+		chunk = malloc(sizeof(*chunk) + capacity);
+
+		if (chunk == NULL) {
+			goto fatal_error;
+		}
+
+		chunk->size = 0;
+		chunk->capacity = capacity;
+		chunk->next = arena->chunks;
+
+		arena->chunks = chunk;
+	}
+
+	void *memory = chunk->data + chunk->size;
+
+	chunk->size += size;
+	arena->allocated += size;
+
+	return memory;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function arena_alloc().\n");
+	exit(1);
+}
\ No newline at end of file
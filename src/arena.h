@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdlib.h>
+
+// A bump allocator for short-lived evaluation data
+// Memory is carved out of large chunks and only ever released all at once by arena_destroy()
+
+struct ArenaChunk {
+	struct ArenaChunk *next;
+
+	size_t size;
+	size_t capacity;
+
+	_Alignas(16) unsigned char data[];
+};
+
+struct Arena {
+	struct ArenaChunk *chunks;
+
+	size_t allocated;	// Total number of bytes handed out by arena_alloc()
+};
+
+struct Arena arena_create();				// Create an empty arena; no memory is reserved until the first allocation
+void arena_destroy(struct Arena arena);			// Release every chunk of the arena at once
+
+void *arena_alloc(struct Arena *arena, size_t size);	// Allocate size bytes aligned to 16 bytes. Never returns NULL
\ No newline at end of file
@@ -0,0 +1,559 @@
+#include <blc.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 64
+
+// Enclosing binders of a term being encoded, innermost first
+
+struct BlcScope {
+	const struct Identifier *binder;
+	const struct BlcScope *next;
+};
+
+// Definitions being expanded, innermost first, so that a recursive one is caught instead of expanded forever
+
+struct BlcExpansion {
+	const struct Identifier *name;
+	const struct BlcExpansion *next;
+};
+
+static void reader_refill(struct BitReader *reader);
+static void reader_skip(struct BitReader *reader, unsigned int size);
+static unsigned int leading_ones(uint64_t window);
+static void frame_push(struct LambdaTerm ***frames, size_t *size, size_t *capacity, struct LambdaTerm *term);
+
+static int term_write(
+	struct BitWriter *writer, const struct LambdaTerm *term, const struct BlcScope *scope,
+	const struct HashMap *definitions, const struct BlcExpansion *expansion, struct Identifier *unresolved
+);
+static void bit_write(struct BitWriter *writer, int bit);
+static void bits_truncate(struct BitWriter *writer, size_t size);
+
+static int name_equal(const struct Identifier *left, const struct Identifier *right);
+
+struct BitReader bit_reader_create(FILE *stream)
+{
+	struct BitReader reader = {0};
+
+	reader.stream = stream;
+	reader.buffer = malloc(BLC_BUFFER_SIZE);
+
+	if (reader.buffer == NULL) {
+		goto fatal_error;
+	}
+
+	return reader;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function bit_reader_create().\n");
+	exit(1);
+}
+
+void bit_reader_destroy(struct BitReader reader)
+{
+	free(reader.buffer);
+	free(reader.frames);
+	free(reader.binders);
+}
+
+int blc_read(struct BitReader *reader, struct LambdaHandle *lambda)
+{
+	// Terms are built top down: abstractions and applications wait on the frames until their subterms are complete,
+	// and every variable completes as many frames as it ends
+
+	*lambda = (struct LambdaHandle){0};
+
+	reader->frames_size = 0;
+	reader->binders_size = 0;
+
+	reader_refill(reader);
+
+	// The padding of the last byte, if any, is all that remains at the end
+
+	if (reader->ended && reader->count < 8 && reader->window == 0) {
+		reader->count = 0;
+		return 0;
+	}
+
+	while (1) {
+		if (reader->count < 2) {
+			reader_refill(reader);
+		}
+
+		if (reader->count == 0) {
+			goto malformed;
+		}
+
+		struct LambdaTerm *term;
+
+		if ((reader->window >> 63) == 0) {
+			if (reader->count < 2) {
+				goto malformed;
+			}
+
+			int application = (reader->window >> 62) & 1;
+
+			reader_skip(reader, 2);
+
+			term = malloc(sizeof(*term));
+
+			if (term == NULL) {
+				goto fatal_error;
+			}
+
+			if (application) {
+				term->type = APPLICATION;
+				term->expression.application.function = NULL;
+				term->expression.application.argument = NULL;
+			} else {
+				term->type = ABSTRACTION;
+				term->expression.abstraction.bound_variable.name = malloc(2);
+				term->expression.abstraction.bound_variable.subscript = (int)reader->binders_size;
+				term->expression.abstraction.body = NULL;
+
+				if (term->expression.abstraction.bound_variable.name == NULL) {
+					goto fatal_error;
+				}
+
+				strcpy(term->expression.abstraction.bound_variable.name, "x");
+
+				frame_push(&reader->binders, &reader->binders_size, &reader->binders_capacity, term);
+			}
+
+			frame_push(&reader->frames, &reader->frames_size, &reader->frames_capacity, term);
+
+			continue;
+		}
+
+		// A variable: its index is the length of the run of ones ended by a zero
+
+		size_t index = 0;
+
+		while (1) {
+			if (reader->count == 0) {
+				reader_refill(reader);
+
+				if (reader->count == 0) {
+					goto malformed;
+				}
+			}
+
+			unsigned int ones = leading_ones(reader->window);
+
+			if (ones < reader->count) {
+				index += ones;
+				reader_skip(reader, ones + 1);
+
+				break;
+			}
+
+			index += reader->count;
+			reader_skip(reader, reader->count);
+
+			if (index > reader->binders_size) {
+				goto malformed;
+			}
+		}
+
+		if (index > reader->binders_size) {
+			goto malformed;
+		}
+
+		term = malloc(sizeof(*term));
+
+		if (term == NULL) {
+			goto fatal_error;
+		}
+
+		term->type = BOUND_VARIABLE;
+		term->expression.variable = reader->binders[reader->binders_size - index]->expression.abstraction.bound_variable;
+
+		// Completing the frames the variable ends
+
+		while (1) {
+			if (reader->frames_size == 0) {
+				lambda->term = term;
+				return 1;
+			}
+
+			struct LambdaTerm *parent = reader->frames[reader->frames_size - 1];
+
+			if (parent->type == ABSTRACTION) {
+				parent->expression.abstraction.body = term;
+				reader->binders_size--;
+			} else if (parent->expression.application.function == NULL) {
+				parent->expression.application.function = term;
+				break;
+			} else {
+				parent->expression.application.argument = term;
+			}
+
+			reader->frames_size--;
+
+			term = parent;
+		}
+	}
+
+	malformed:
+
+	// Every frame holds the part of the term decoded under it, with its missing subterms left NULL
+
+	for (size_t i = 0; i < reader->frames_size; i++) {
+		lambda_free((struct LambdaHandle){.term = reader->frames[i]});
+	}
+
+	reader->frames_size = 0;
+	reader->binders_size = 0;
+
+	return -1;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function blc_read().\n");
+	exit(1);
+}
+
+void reader_refill(struct BitReader *reader)
+{
+	// Tops the window up a byte at a time, reading the stream once the buffer is exhausted
+
+	while (reader->count <= 56) {
+		if (reader->position == reader->size) {
+			if (reader->ended) {
+				return;
+			}
+
+			reader->size = fread(reader->buffer, 1, BLC_BUFFER_SIZE, reader->stream);
+			reader->position = 0;
+
+			if (reader->size == 0) {
+				reader->ended = 1;
+				return;
+			}
+		}
+
+		reader->window |= (uint64_t)reader->buffer[reader->position++] << (56 - reader->count);
+		reader->count += 8;
+	}
+}
+
+void reader_skip(struct BitReader *reader, unsigned int size)
+{
+	reader->window = size < 64 ? reader->window << size : 0;
+	reader->count -= size;
+}
+
+unsigned int leading_ones(uint64_t window)
+{
+#ifdef __GNUC__
+	return ~window == 0 ? 64 : (unsigned int)__builtin_clzll(~window);
+#else
+	unsigned int ones = 0;
+
+	while (ones < 64 && (window >> (63 - ones) & 1)) {
+		ones++;
+	}
+
+	return ones;
+#endif
+}
+
+void frame_push(struct LambdaTerm ***frames, size_t *size, size_t *capacity, struct LambdaTerm *term)
+{
+	if (*size == *capacity) {
+		// Scaling factor of 2
+
+		*capacity = *capacity == 0 ? INITIAL_CAPACITY : *capacity * 2;
+		*frames = realloc(*frames, sizeof(**frames) * *capacity);
+
+		if (*frames == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	(*frames)[(*size)++] = term;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function frame_push().\n");
+	exit(1);
+}
+
+struct BitWriter bit_writer_create()
+{
+	struct BitWriter writer = {0};
+
+	return writer;
+}
+
+void bit_writer_destroy(struct BitWriter writer)
+{
+	free(writer.data);
+}
+
+void bit_writer_fprint(FILE *stream, const struct BitWriter *writer)
+{
+	for (size_t i = 0; i < writer->size; i++) {
+		fputc('0' + (writer->data[i >> 3] >> (7 - (i & 7)) & 1), stream);
+	}
+}
+
+int blc_write(struct BitWriter *writer, struct LambdaHandle lambda, const struct HashMap *definitions, struct Identifier *unresolved)
+{
+	size_t size = writer->size;
+
+	if (lambda.term == NULL || !term_write(writer, lambda.term, NULL, definitions, NULL, unresolved)) {
+		bits_truncate(writer, size);
+		return 0;
+	}
+
+	return 1;
+}
+
+int term_write(
+	struct BitWriter *writer, const struct LambdaTerm *term, const struct BlcScope *scope,
+	const struct HashMap *definitions, const struct BlcExpansion *expansion, struct Identifier *unresolved
+)
+{
+	switch (term->type) {
+	case CHURCH_NUMERAL:
+		// λf.λx.f (f ... (f x)), f being the variable of the second binder and x of the first
+
+		bit_write(writer, 0);
+		bit_write(writer, 0);
+		bit_write(writer, 0);
+		bit_write(writer, 0);
+
+		for (int i = 0; i < term->expression.church_numeral; i++) {
+			bit_write(writer, 0);
+			bit_write(writer, 1);
+			bit_write(writer, 1);
+			bit_write(writer, 1);
+			bit_write(writer, 0);
+		}
+
+		bit_write(writer, 1);
+		bit_write(writer, 0);
+
+		return 1;
+
+	case BOUND_VARIABLE:
+		// Variables share the name string of their binder
+
+		for (; scope != NULL; scope = scope->next) {
+			bit_write(writer, 1);
+
+			if (scope->binder->name == term->expression.variable.name) {
+				bit_write(writer, 0);
+				return 1;
+			}
+		}
+
+		*unresolved = term->expression.variable;
+		return 0;
+
+	case FREE_VARIABLE: {
+		// Definitions are closed once expanded, so they are encoded out of any scope
+
+		struct LambdaHandle definition = {0};
+
+		if (definitions != NULL) {
+			definition = hashmap_get_original(definitions, term->expression.variable);
+		}
+
+		for (const struct BlcExpansion *outer = expansion; outer != NULL && definition.term != NULL; outer = outer->next) {
+			if (name_equal(outer->name, &term->expression.variable)) {
+				definition.term = NULL;
+			}
+		}
+
+		if (definition.term == NULL) {
+			*unresolved = term->expression.variable;
+			return 0;
+		}
+
+		struct BlcExpansion inner = {&term->expression.variable, expansion};
+
+		return term_write(writer, definition.term, NULL, definitions, &inner, unresolved);
+	}
+
+	case ABSTRACTION: {
+		struct BlcScope inner = {&term->expression.abstraction.bound_variable, scope};
+
+		bit_write(writer, 0);
+		bit_write(writer, 0);
+
+		return term_write(writer, term->expression.abstraction.body, &inner, definitions, expansion, unresolved);
+	}
+
+	case APPLICATION:
+		bit_write(writer, 0);
+		bit_write(writer, 1);
+
+		return term_write(writer, term->expression.application.function, scope, definitions, expansion, unresolved) &&
+			term_write(writer, term->expression.application.argument, scope, definitions, expansion, unresolved);
+
+	default:
+		return 0;
+	}
+}
+
+void bit_write(struct BitWriter *writer, int bit)
+{
+	if (writer->size == writer->capacity * 8) {
+		// Scaling factor of 2, new bytes being cleared so that bits only need to be set
+
+		size_t capacity = writer->capacity == 0 ? INITIAL_CAPACITY : writer->capacity * 2;
+
+		unsigned char *data = realloc(writer->data, capacity);
+
+		if (data == NULL) {
+			goto fatal_error;
+		}
+
+		memset(data + writer->capacity, 0, capacity - writer->capacity);
+
+		writer->data = data;
+		writer->capacity = capacity;
+	}
+
+	writer->data[writer->size >> 3] |= (unsigned char)(bit << (7 - (writer->size & 7)));
+	writer->size++;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function bit_write().\n");
+	exit(1);
+}
+
+void bits_truncate(struct BitWriter *writer, size_t size)
+{
+	// Clearing the bits dropped, which later writes only set
+
+	size_t bytes = (writer->size + 7) >> 3;
+
+	if (size & 7) {
+		writer->data[size >> 3] &= (unsigned char)(0XFF << (8 - (size & 7)));
+	}
+
+	for (size_t i = (size + 7) >> 3; i < bytes; i++) {
+		writer->data[i] = 0;
+	}
+
+	writer->size = size;
+}
+
+int blc_load(struct HashMap *hashmap, const char *path, const char *name, size_t *count)
+{
+	FILE *file = fopen(path, "rb");
+
+	*count = 0;
+
+	if (file == NULL) {
+		printf("ERROR: could not open %s.\n", path);
+		return 0;
+	}
+
+	struct BitReader reader = bit_reader_create(file);
+	struct LambdaHandle lambda;
+
+	int status;
+
+	while ((status = blc_read(&reader, &lambda)) == 1) {
+		lambda.identifier.name = malloc(strlen(name) + 1);
+		lambda.identifier.subscript = (int)*count;
+
+		if (lambda.identifier.name == NULL) {
+			goto fatal_error;
+		}
+
+		strcpy(lambda.identifier.name, name);
+
+		hashmap_set(hashmap, lambda);
+
+		++*count;
+	}
+
+	bit_reader_destroy(reader);
+	fclose(file);
+
+	if (status == -1) {
+		printf("ERROR: %s is malformed after %zu terms.\n", path, *count);
+		return 0;
+	}
+
+	return 1;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function blc_load().\n");
+	exit(1);
+}
+
+int blc_save(const struct HashMap *hashmap, const char *path, const char *name, size_t *count)
+{
+	// The whole file is encoded before anything gets written
+
+	struct BitWriter writer = bit_writer_create();
+
+	*count = 0;
+
+	while (1) {
+		struct Identifier identifier = {(char *)name, (int)*count};
+		struct Identifier unresolved;
+
+		struct LambdaHandle lambda = hashmap_get_original(hashmap, identifier);
+
+		if (lambda.term == NULL) {
+			break;
+		}
+
+		if (!blc_write(&writer, lambda, hashmap, &unresolved)) {
+			printf("ERROR: %s%zu has no binary encoding, %s", name, *count, unresolved.name);
+
+			if (unresolved.subscript >= 0) {
+				printf("%d", unresolved.subscript);
+			}
+
+			printf(" is undefined or recursive.\n");
+
+			bit_writer_destroy(writer);
+
+			return 0;
+		}
+
+		++*count;
+	}
+
+	FILE *file = fopen(path, "wb");
+
+	if (file == NULL) {
+		printf("ERROR: could not open %s.\n", path);
+		bit_writer_destroy(writer);
+
+		return 0;
+	}
+
+	size_t bytes = (writer.size + 7) >> 3;
+	int written = fwrite(writer.data, 1, bytes, file) == bytes;
+
+	written = fclose(file) == 0 && written;
+
+	if (!written) {
+		printf("ERROR: could not write %s.\n", path);
+	}
+
+	bit_writer_destroy(writer);
+
+	return written;
+}
+
+int name_equal(const struct Identifier *left, const struct Identifier *right)
+{
+	return left->subscript == right->subscript && strcmp(left->name, right->name) == 0;
+}
\ No newline at end of file
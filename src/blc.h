@@ -0,0 +1,61 @@
+#pragma once
+
+#include <hashmap.h>
+#include <lambda.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Binary lambda calculus
+// Terms are encoded as in Tromp's binary lambda calculus, straight from their de Bruijn form: 00 M for an abstraction,
+// 01 M N for an application and 1^n 0 for the variable of the n-th enclosing binder. Codes are prefix free, so the terms
+// of a file follow each other bit after bit, packed from the most significant bit of each byte, and the last byte is
+// padded with zeros.
+// Only closed terms have an encoding: Church numerals are written out, and stored definitions are expanded where they
+// are used, which fails for undefined free variables and recursive definitions. Decoding involves no names at all, the
+// binders of a decoded term being named after their depth, x0 for the outermost one.
+
+#define BLC_BUFFER_SIZE 65536	// Bytes read from the stream at a time
+
+// Streaming decoder, which shifts bits out of a 64 bit window topped up from a buffer, so that a run of ones is
+// counted in one go
+
+struct BitReader {
+	FILE *stream;
+	int ended;			// The stream has no more bytes to give
+
+	unsigned char *buffer;
+	size_t size;
+	size_t position;
+
+	uint64_t window;		// Bits not consumed yet, from the most significant one, zero past count
+	unsigned int count;
+
+	// Terms being decoded, kept from one term to the next
+
+	struct LambdaTerm **frames;	// Abstractions waiting for their body and applications for their function or argument
+	size_t frames_size;
+	size_t frames_capacity;
+
+	struct LambdaTerm **binders;	// Enclosing abstractions, outermost first
+	size_t binders_size;
+	size_t binders_capacity;
+};
+
+struct BitWriter {
+	unsigned char *data;
+	size_t size;			// In bits
+	size_t capacity;		// In bytes
+};
+
+struct BitReader bit_reader_create(FILE *stream);	// Create a reader decoding terms out of stream
+void bit_reader_destroy(struct BitReader reader);	// Release a reader, leaving its stream open
+
+struct BitWriter bit_writer_create();				// Create an empty writer
+void bit_writer_destroy(struct BitWriter writer);		// Release the bits of a writer
+void bit_writer_fprint(FILE *stream, const struct BitWriter *writer);	// Print the bits written as 0 and 1 characters
+
+int blc_read(struct BitReader *reader, struct LambdaHandle *lambda);	// Decode the next term of the stream into lambda. Returns 1 upon success, 0 at the end of the stream and -1 upon malformed input
+int blc_write(struct BitWriter *writer, struct LambdaHandle lambda, const struct HashMap *definitions, struct Identifier *unresolved);	// Encode lambda, expanding the definitions it uses. Returns 0 with nothing written and unresolved set to the free variable at fault if it has no encoding
+
+int blc_load(struct HashMap *hashmap, const char *path, const char *name, size_t *count);		// Store the terms of a file as the definitions name0, name1 and so on, counting them in count. Returns 0 upon failure
+int blc_save(const struct HashMap *hashmap, const char *path, const char *name, size_t *count);	// Write the definitions name0, name1 and so on up to the first missing one to a file, counting them in count. Returns 0 upon failure
\ No newline at end of file
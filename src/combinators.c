@@ -0,0 +1,986 @@
+#include <combinators.h>
+#include <reclaimer.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+static const char *combinator_names[] = {"S", "K", "I", "B", "C", "S'", "B*", "C'"};
+static const int combinator_arities[] = {3, 2, 1, 3, 3, 4, 4, 4};
+
+// Result of abstracting a variable out of a graph
+// A constant result means the variable doesn't occur, hence the abstraction is K applied to node
+
+struct Bracket {
+	struct CombinatorNode *node;
+	int constant;
+};
+
+// Compilation and readback both keep the enclosing binders, indexed by level
+
+struct Scope {
+	const struct Identifier **identifiers;
+	struct LambdaTerm **abstractions;
+
+	size_t size;
+	size_t capacity;
+};
+
+struct CombinatorReadback {
+	struct LambdaHandle lambda;
+	struct Scope scope;
+
+	int subscript;		// Next subscript for a fresh binder
+	size_t visited;		// Nodes printed raw, evaluation_control being polled every EVALUATION_POLL_INTERVAL
+
+	// Pending steps and the terms read back so far, see machine_readback()
+
+	struct CombinatorReadbackTask *tasks;
+	size_t tasks_size;
+	size_t tasks_capacity;
+
+	struct LambdaTerm **results;
+	size_t results_size;
+	size_t results_capacity;
+};
+
+// Steps of a readback, taken off a stack
+
+enum CombinatorReadbackTaskType {
+	COMBINATOR_READBACK_NODE,		// Reduce a node and read it back onto the results
+	COMBINATOR_READBACK_RAW,		// Read a node back onto the results as it stands
+	COMBINATOR_READBACK_APPLICATION,	// Apply the function below the top of the results to the argument on top
+	COMBINATOR_READBACK_ABSTRACTION,	// Close the abstraction term over the body on top of the results
+	COMBINATOR_READBACK_UNVISIT		// Leave an application whose subterms have been read back raw
+};
+
+struct CombinatorReadbackTask {
+	enum CombinatorReadbackTaskType type;
+
+	struct CombinatorNode *node;
+	struct LambdaTerm *term;	// Abstraction waiting for its body
+};
+
+static struct CombinatorNode *node_create(struct CombinatorMachine *machine, enum CombinatorNodeType type);
+static struct CombinatorNode *constant_create(struct CombinatorMachine *machine, enum Combinator combinator);
+static struct CombinatorNode *application_create(struct CombinatorMachine *machine, struct CombinatorNode *function, struct CombinatorNode *argument);
+static struct CombinatorNode *combinator_forward(struct CombinatorNode *node);
+
+static struct CombinatorNode *term_compile(struct CombinatorMachine *machine, struct Scope *scope, const struct LambdaTerm *term, struct Linkage *linkage);
+static struct Bracket bracket_abstract(struct CombinatorMachine *machine, struct CombinatorNode *node, size_t level);
+static int node_is_composition(struct CombinatorNode *node);
+
+static struct CombinatorNode *machine_whnf(struct CombinatorMachine *machine, struct CombinatorNode *node);
+static int machine_contract(struct CombinatorMachine *machine, struct CombinatorNode *head, size_t arity);
+static struct CombinatorNode *reference_unfold(struct CombinatorMachine *machine, struct CombinatorNode *node);
+
+static struct LambdaTerm *machine_readback(struct CombinatorMachine *machine, struct CombinatorReadback *readback, struct CombinatorNode *node);
+static int node_step(struct CombinatorMachine *machine, struct CombinatorReadback *readback, struct CombinatorNode *node, struct LambdaTerm **term);
+static int raw_step(struct CombinatorMachine *machine, struct CombinatorReadback *readback, struct CombinatorNode *node, struct LambdaTerm **term);
+static void task_push(struct CombinatorReadback *readback, enum CombinatorReadbackTaskType type, struct CombinatorNode *node, struct LambdaTerm *term);
+static struct LambdaTerm *free_variable_readback(struct CombinatorReadback *readback, const char *name, int subscript);
+
+static void scope_push(struct Scope *scope, const struct Identifier *identifier, struct LambdaTerm *abstraction);
+static void stack_push(struct CombinatorMachine *machine, struct CombinatorNode *node);
+static struct LambdaTerm *term_create(enum ExpressionType type);
+static void *array_push(void *array, size_t *size, size_t *capacity, size_t element_size, const void *element);
+
+struct CombinatorMachine combinators_create(struct LambdaHandle lambda, const struct HashMap *definitions)
+{
+	struct CombinatorMachine machine = {0};
+
+	machine.arena = arena_create();
+	machine.step_limit = DEFAULT_STEP_LIMIT;
+	machine.stats.status = EVALUATION_PENDING;
+
+	if (lambda.term == NULL) {
+		return machine;
+	}
+
+	machine.linker = linker_create(&machine.arena);
+
+	struct Linkage *root = linker_link(&machine.linker, lambda, definitions);
+
+	struct Scope scope = {0};
+
+	machine.root = term_compile(&machine, &scope, lambda.term, root);
+
+	free(scope.identifiers);
+	free(scope.abstractions);
+
+	return machine;
+}
+
+void combinators_destroy(struct CombinatorMachine machine)
+{
+	linker_destroy(machine.linker);
+
+	free(machine.stack);
+
+	arena_destroy(machine.arena);
+}
+
+struct LambdaHandle combinators_evaluate(struct LambdaHandle lambda, const struct HashMap *definitions, struct EvaluationStats *stats)
+{
+	struct CombinatorMachine machine = combinators_create(lambda, definitions);
+
+	struct LambdaHandle result = combinators_readback(&machine);
+
+	// Numerals and definitions are folded back as lambda_evaluate() does
+
+	if (machine.stats.status == EVALUATION_CANCELLED) {
+		lambda_free_deferred(result);
+
+		result = (struct LambdaHandle){0};
+	} else {
+		result = lambda_fold(result, definitions);
+	}
+
+	if (stats != NULL) {
+		*stats = machine.stats;
+	}
+
+	combinators_destroy(machine);
+
+	return result;
+}
+
+// Compilation
+
+struct CombinatorNode *term_compile(struct CombinatorMachine *machine, struct Scope *scope, const struct LambdaTerm *term, struct Linkage *linkage)
+{
+	struct CombinatorNode *node;
+
+	switch (term->type) {
+	case CHURCH_NUMERAL:
+		node = node_create(machine, COMBINATOR_CHURCH_NUMERAL);
+		node->church_numeral = term->expression.church_numeral;
+
+		return node;
+
+	case BOUND_VARIABLE:
+		// Innermost binders shadow outer ones
+
+		for (size_t level = scope->size; level > 0; level--) {
+			const struct Identifier *identifier = scope->identifiers[level - 1];
+
+			if (identifier->subscript != term->expression.variable.subscript) {
+				continue;
+			}
+
+			if (identifier->name != term->expression.variable.name && strcmp(identifier->name, term->expression.variable.name) != 0) {
+				continue;
+			}
+
+			node = node_create(machine, COMBINATOR_VARIABLE);
+			node->level = level - 1;
+
+			return node;
+		}
+
+		node = node_create(machine, COMBINATOR_FREE_VARIABLE);
+		node->free_variable = &term->expression.variable;
+
+		return node;
+
+	case FREE_VARIABLE:
+		const struct Identifier *free_variable;
+
+		struct Linkage *target = linkage_target(linkage, &term->expression.variable, &free_variable);
+
+		if (target == NULL) {
+			node = node_create(machine, COMBINATOR_FREE_VARIABLE);
+			node->free_variable = free_variable;
+
+			return node;
+		}
+
+		if (target->combinator == NULL) {
+			target->combinator = node_create(machine, COMBINATOR_REFERENCE);
+			target->combinator->reference = target;
+		}
+
+		return target->combinator;
+
+	case ABSTRACTION:
+		scope_push(scope, &term->expression.abstraction.bound_variable, NULL);
+
+		struct CombinatorNode *body = term_compile(machine, scope, term->expression.abstraction.body, linkage);
+
+		scope->size--;
+
+		struct Bracket bracket = bracket_abstract(machine, body, scope->size);
+
+		if (bracket.constant) {
+			return application_create(machine, constant_create(machine, COMBINATOR_K), bracket.node);
+		}
+
+		return bracket.node;
+
+	case APPLICATION:
+		struct CombinatorNode *function = term_compile(machine, scope, term->expression.application.function, linkage);
+		struct CombinatorNode *argument = term_compile(machine, scope, term->expression.application.argument, linkage);
+
+		return application_create(machine, function, argument);
+
+	default:
+		return NULL;
+	}
+}
+
+struct Bracket bracket_abstract(struct CombinatorMachine *machine, struct CombinatorNode *node, size_t level)
+{
+	// Turner's bracket abstraction, optimizing S as soon as both of its arguments are known:
+	//	S (K p) (K q) = K (p q)		S (K p) I = p			S (K p) (B q r) = B* p q r
+	//	S (K p) q = B p q		S (B p q) (K r) = C' p q r	S p (K q) = C p q
+	//	S (B p q) r = S' p q r
+
+	if (node->type == COMBINATOR_VARIABLE && node->level == level) {
+		return (struct Bracket){constant_create(machine, COMBINATOR_I), 0};
+	}
+
+	if (node->type != COMBINATOR_APPLICATION) {
+		return (struct Bracket){node, 1};
+	}
+
+	struct Bracket function = bracket_abstract(machine, node->application.function, level);
+	struct Bracket argument = bracket_abstract(machine, node->application.argument, level);
+
+	struct CombinatorNode *p = function.node;
+	struct CombinatorNode *q = argument.node;
+
+	enum Combinator combinator;
+
+	if (function.constant && argument.constant) {
+		return (struct Bracket){node, 1};
+	}
+
+	if (function.constant) {
+		// Eta reduction: the only non constant I is the abstracted variable itself
+
+		if (q->type == COMBINATOR_CONSTANT && q->combinator == COMBINATOR_I) {
+			return (struct Bracket){p, 0};
+		}
+
+		if (node_is_composition(q)) {
+			struct CombinatorNode *b_star = application_create(machine, constant_create(machine, COMBINATOR_B_STAR), p);
+
+			b_star = application_create(machine, b_star, q->application.function->application.argument);
+
+			return (struct Bracket){application_create(machine, b_star, q->application.argument), 0};
+		}
+
+		combinator = COMBINATOR_B;
+	} else if (argument.constant) {
+		if (node_is_composition(p)) {
+			struct CombinatorNode *c_prime = application_create(machine, constant_create(machine, COMBINATOR_C_PRIME), p->application.function->application.argument);
+
+			c_prime = application_create(machine, c_prime, p->application.argument);
+
+			return (struct Bracket){application_create(machine, c_prime, q), 0};
+		}
+
+		combinator = COMBINATOR_C;
+	} else {
+		if (node_is_composition(p)) {
+			struct CombinatorNode *s_prime = application_create(machine, constant_create(machine, COMBINATOR_S_PRIME), p->application.function->application.argument);
+
+			s_prime = application_create(machine, s_prime, p->application.argument);
+
+			return (struct Bracket){application_create(machine, s_prime, q), 0};
+		}
+
+		combinator = COMBINATOR_S;
+	}
+
+	struct CombinatorNode *result = application_create(machine, constant_create(machine, combinator), p);
+
+	return (struct Bracket){application_create(machine, result, q), 0};
+}
+
+int node_is_composition(struct CombinatorNode *node)
+{
+	// Matches B p q
+
+	if (node->type != COMBINATOR_APPLICATION) {
+		return 0;
+	}
+
+	struct CombinatorNode *function = node->application.function;
+
+	if (function->type != COMBINATOR_APPLICATION) {
+		return 0;
+	}
+
+	function = function->application.function;
+
+	return function->type == COMBINATOR_CONSTANT && function->combinator == COMBINATOR_B;
+}
+
+// Reduction
+
+struct CombinatorNode *machine_whnf(struct CombinatorMachine *machine, struct CombinatorNode *node)
+{
+	// Unwinds the spine onto the stack and contracts combinator redexes until the head lacks arguments or is a variable
+
+	size_t base = machine->stack_size;
+
+	struct CombinatorNode *head = combinator_forward(node);
+
+	while (1) {
+		switch (head->type) {
+		case COMBINATOR_APPLICATION:
+			stack_push(machine, head);
+
+			head = combinator_forward(head->application.function);
+
+			continue;
+
+		case COMBINATOR_REFERENCE:
+			head = reference_unfold(machine, head);
+
+			continue;
+
+		case COMBINATOR_CONSTANT:
+		case COMBINATOR_CHURCH_NUMERAL:
+			size_t arity = head->type == COMBINATOR_CONSTANT ? (size_t)combinator_arities[head->combinator] : 2;
+
+			if (machine->stack_size - base < arity) {
+				goto end;
+			}
+
+			if (machine->step_limit != 0 && machine->stats.beta_steps >= machine->step_limit) {
+				machine->stats.status = EVALUATION_STEP_LIMIT;
+				goto end;
+			}
+
+			if ((machine->stats.beta_steps & (EVALUATION_POLL_INTERVAL - 1)) == 0 && !evaluation_poll(&machine->stats)) {
+				goto end;
+			}
+
+			if (!machine_contract(machine, head, arity)) {
+				goto end;
+			}
+
+			head = combinator_forward(machine->stack[machine->stack_size]);
+
+			continue;
+
+		default:
+			goto end;
+		}
+	}
+
+	end:
+
+	machine->stack_size = base;
+
+	return combinator_forward(node);
+}
+
+int machine_contract(struct CombinatorMachine *machine, struct CombinatorNode *head, size_t arity)
+{
+	// Rewrites the root of the redex in place and pops its arguments, leaving the root right above the stack top
+	// Returns 0 upon a black hole: a term reducing to itself through an indirection
+
+	struct CombinatorNode **spine = machine->stack + machine->stack_size - 1;
+
+	struct CombinatorNode *x = spine[0]->application.argument;
+	struct CombinatorNode *y = arity > 1 ? spine[-1]->application.argument : NULL;
+	struct CombinatorNode *z = arity > 2 ? spine[-2]->application.argument : NULL;
+	struct CombinatorNode *w = arity > 3 ? spine[-3]->application.argument : NULL;
+
+	struct CombinatorNode *root = spine[1 - (long)arity];
+
+	struct CombinatorNode *function;
+	struct CombinatorNode *argument;
+
+	machine->stack_size -= arity;
+	machine->stack[machine->stack_size] = root;
+
+	machine->stats.beta_steps++;
+
+	if (head->type == COMBINATOR_CHURCH_NUMERAL) {
+		// n f x = f (f ... (f x))
+
+		struct CombinatorNode *body = y;
+
+		for (int i = 1; i < head->church_numeral; i++) {
+			body = application_create(machine, x, body);
+		}
+
+		if (head->church_numeral == 0) {
+			goto indirection;
+		}
+
+		function = x;
+		argument = body;
+
+		goto rewrite;
+	}
+
+	switch (head->combinator) {
+	case COMBINATOR_I:
+		y = x;
+		goto indirection;
+
+	case COMBINATOR_K:
+		y = x;
+		goto indirection;
+
+	case COMBINATOR_S:
+		function = application_create(machine, x, z);
+		argument = application_create(machine, y, z);
+		break;
+
+	case COMBINATOR_B:
+		function = x;
+		argument = application_create(machine, y, z);
+		break;
+
+	case COMBINATOR_C:
+		function = application_create(machine, x, z);
+		argument = y;
+		break;
+
+	case COMBINATOR_S_PRIME:
+		function = application_create(machine, x, application_create(machine, y, w));
+		argument = application_create(machine, z, w);
+		break;
+
+	case COMBINATOR_B_STAR:
+		function = x;
+		argument = application_create(machine, y, application_create(machine, z, w));
+		break;
+
+	case COMBINATOR_C_PRIME:
+		function = application_create(machine, x, application_create(machine, y, w));
+		argument = z;
+		break;
+	}
+
+	rewrite:
+
+	root->application.function = function;
+	root->application.argument = argument;
+
+	return 1;
+
+	indirection:
+
+	// The result is shared through an indirection; y holds it
+
+	if (combinator_forward(y) == root) {
+		machine->stats.status = EVALUATION_STEP_LIMIT;
+		return 0;
+	}
+
+	root->type = COMBINATOR_INDIRECTION;
+	root->indirection = y;
+
+	return 1;
+}
+
+struct CombinatorNode *reference_unfold(struct CombinatorMachine *machine, struct CombinatorNode *node)
+{
+	struct Linkage *linkage = node->reference;
+
+	struct Scope scope = {0};
+
+	struct CombinatorNode *compiled = term_compile(machine, &scope, linkage->definition.term, linkage);
+
+	free(scope.identifiers);
+	free(scope.abstractions);
+
+	machine->stats.delta_steps++;
+
+	// Every occurrence shares the compiled graph, and recursive definitions become cycles
+
+	node->type = COMBINATOR_INDIRECTION;
+	node->indirection = compiled;
+
+	return combinator_forward(compiled);
+}
+
+// Readback
+
+struct LambdaHandle combinators_readback(struct CombinatorMachine *machine)
+{
+	struct CombinatorReadback readback = {0};
+
+	if (machine->root == NULL) {
+		return readback.lambda;
+	}
+
+	// Fresh binders are all named x, with subscripts past any x the result could refer to freely
+
+	readback.subscript = -1;
+
+	const struct Linker *linker = &machine->linker;
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		const struct Linkage *linkage = linker->linkages[i];
+
+		if (linkage == NULL) {
+			continue;
+		}
+
+		for (size_t j = 0; j <= linkage->definition.free_variables_size; j++) {
+			const struct Identifier *identifier = j < linkage->definition.free_variables_size ? linkage->definition.free_variables + j : &linkage->definition.identifier;
+
+			if (identifier->name != NULL && strcmp(identifier->name, "x") == 0 && identifier->subscript >= readback.subscript) {
+				readback.subscript = identifier->subscript < 0 ? 1 : identifier->subscript + 1;
+			}
+		}
+	}
+
+	readback.lambda.free_variables_capacity = INITIAL_CAPACITY;
+	readback.lambda.free_variables = malloc(sizeof(*readback.lambda.free_variables) * readback.lambda.free_variables_capacity);
+
+	if (readback.lambda.free_variables == NULL) {
+		goto fatal_error;
+	}
+
+	readback.lambda.term = machine_readback(machine, &readback, machine->root);
+
+	if (machine->stats.status == EVALUATION_PENDING) {
+		machine->stats.status = EVALUATION_NORMAL_FORM;
+	}
+
+	free(readback.scope.identifiers);
+	free(readback.scope.abstractions);
+	free(readback.tasks);
+	free(readback.results);
+
+	return readback.lambda;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function combinators_readback().\n");
+	exit(1);
+}
+
+struct LambdaTerm *machine_readback(struct CombinatorMachine *machine, struct CombinatorReadback *readback, struct CombinatorNode *node)
+{
+	// Subterms are read back off a stack of tasks, and their terms wait on a stack of results until the term enclosing
+	// them is complete, so deep results don't deepen the C stack. Functions are read back before their arguments, as
+	// they would be recursively, so arguments are reduced and binders named in the same order
+
+	task_push(readback, COMBINATOR_READBACK_NODE, node, NULL);
+
+	while (readback->tasks_size > 0) {
+		struct CombinatorReadbackTask task = readback->tasks[--readback->tasks_size];
+
+		struct LambdaTerm *term;
+
+		switch (task.type) {
+		case COMBINATOR_READBACK_NODE:
+			if (!node_step(machine, readback, task.node, &term)) {
+				continue;
+			}
+
+			break;
+
+		case COMBINATOR_READBACK_RAW:
+			if (!raw_step(machine, readback, task.node, &term)) {
+				continue;
+			}
+
+			break;
+
+		case COMBINATOR_READBACK_APPLICATION:
+			term = term_create(APPLICATION);
+
+			term->expression.application.argument = readback->results[--readback->results_size];
+			term->expression.application.function = readback->results[--readback->results_size];
+
+			break;
+
+		case COMBINATOR_READBACK_ABSTRACTION:
+			readback->scope.size--;
+
+			term = task.term;
+			term->expression.abstraction.body = readback->results[--readback->results_size];
+
+			break;
+
+		case COMBINATOR_READBACK_UNVISIT:
+			task.node->flags = 0;
+
+			continue;
+		}
+
+		readback->results = array_push(readback->results, &readback->results_size, &readback->results_capacity, sizeof(term), &term);
+	}
+
+	return readback->results[--readback->results_size];
+}
+
+int node_step(struct CombinatorMachine *machine, struct CombinatorReadback *readback, struct CombinatorNode *node, struct LambdaTerm **term)
+{
+	// Normal order readback: the head is reduced first, then every argument is read back from left to right. Reads the
+	// head back into term and returns 1, or pushes the tasks reading back the whole node and returns 0
+
+	node = machine_whnf(machine, node);
+
+	if (machine->stats.status != EVALUATION_PENDING) {
+		return raw_step(machine, readback, node, term);
+	}
+
+	// Finding the head
+
+	struct CombinatorNode *head = node;
+
+	while (head->type == COMBINATOR_APPLICATION) {
+		head = combinator_forward(head->application.function);
+	}
+
+	switch (head->type) {
+	case COMBINATOR_VARIABLE:
+		*term = term_create(BOUND_VARIABLE);
+		(*term)->expression.variable = readback->scope.abstractions[head->level]->expression.abstraction.bound_variable;
+
+		break;
+
+	case COMBINATOR_FREE_VARIABLE:
+		*term = free_variable_readback(readback, head->free_variable->name, head->free_variable->subscript);
+
+		break;
+
+	case COMBINATOR_CHURCH_NUMERAL:
+		if (head == node) {
+			*term = term_create(CHURCH_NUMERAL);
+			(*term)->expression.church_numeral = head->church_numeral;
+
+			return 1;
+		}
+
+		// Falls through
+
+	default: {
+		// A partial application is a function: applying it to a fresh variable yields the body of its abstraction
+
+		struct LambdaTerm *abstraction = term_create(ABSTRACTION);
+
+		abstraction->expression.abstraction.bound_variable.name = malloc(2);
+		abstraction->expression.abstraction.bound_variable.subscript = readback->subscript;
+
+		if (abstraction->expression.abstraction.bound_variable.name == NULL) {
+			goto fatal_error;
+		}
+
+		strcpy(abstraction->expression.abstraction.bound_variable.name, "x");
+
+		readback->subscript = readback->subscript < 0 ? 1 : readback->subscript + 1;
+
+		struct CombinatorNode *variable = node_create(machine, COMBINATOR_VARIABLE);
+
+		variable->level = readback->scope.size;
+
+		scope_push(&readback->scope, NULL, abstraction);
+
+		task_push(readback, COMBINATOR_READBACK_ABSTRACTION, NULL, abstraction);
+		task_push(readback, COMBINATOR_READBACK_NODE, application_create(machine, node, variable), NULL);
+
+		return 0;
+	}
+	}
+
+	// Stuck application: the head goes onto the results as soon as this step returns, so the tasks applying it to the
+	// arguments from left to right are pushed from the last argument to the first
+
+	struct CombinatorNode *spine = node;
+
+	while (spine->type == COMBINATOR_APPLICATION) {
+		task_push(readback, COMBINATOR_READBACK_APPLICATION, NULL, NULL);
+		task_push(readback, COMBINATOR_READBACK_NODE, spine->application.argument, NULL);
+
+		spine = combinator_forward(spine->application.function);
+	}
+
+	return 1;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function node_step().\n");
+	exit(1);
+}
+
+int raw_step(struct CombinatorMachine *machine, struct CombinatorReadback *readback, struct CombinatorNode *node, struct LambdaTerm **term)
+{
+	// Once a limit has been hit, the graph is printed as it stands with the combinators named
+	// Cycles are cut with an ellipsis
+
+	node = combinator_forward(node);
+
+	// Once cancelled, the remaining subterms are replaced by placeholders so the partial term can be released
+
+	if (machine->stats.status != EVALUATION_CANCELLED && (++readback->visited & (EVALUATION_POLL_INTERVAL - 1)) == 0) {
+		evaluation_poll(&machine->stats);
+	}
+
+	if (machine->stats.status == EVALUATION_CANCELLED) {
+		*term = term_create(CHURCH_NUMERAL);
+		(*term)->expression.church_numeral = 0;
+
+		return 1;
+	}
+
+	switch (node->type) {
+	case COMBINATOR_APPLICATION:
+		if (node->flags) {
+			*term = free_variable_readback(readback, "...", -1);
+
+			return 1;
+		}
+
+		node->flags = 1;
+
+		task_push(readback, COMBINATOR_READBACK_UNVISIT, node, NULL);
+		task_push(readback, COMBINATOR_READBACK_APPLICATION, NULL, NULL);
+		task_push(readback, COMBINATOR_READBACK_RAW, node->application.argument, NULL);
+		task_push(readback, COMBINATOR_READBACK_RAW, node->application.function, NULL);
+
+		return 0;
+
+	case COMBINATOR_CONSTANT:
+		*term = free_variable_readback(readback, combinator_names[node->combinator], -1);
+
+		return 1;
+
+	case COMBINATOR_CHURCH_NUMERAL:
+		*term = term_create(CHURCH_NUMERAL);
+		(*term)->expression.church_numeral = node->church_numeral;
+
+		return 1;
+
+	case COMBINATOR_VARIABLE:
+		if (node->level < readback->scope.size) {
+			*term = term_create(BOUND_VARIABLE);
+			(*term)->expression.variable = readback->scope.abstractions[node->level]->expression.abstraction.bound_variable;
+
+			return 1;
+		}
+
+		*term = free_variable_readback(readback, "x", (int)node->level);
+
+		return 1;
+
+	case COMBINATOR_FREE_VARIABLE:
+		*term = free_variable_readback(readback, node->free_variable->name, node->free_variable->subscript);
+
+		return 1;
+
+	case COMBINATOR_REFERENCE:
+		*term = free_variable_readback(readback, node->reference->definition.identifier.name, node->reference->definition.identifier.subscript);
+
+		return 1;
+
+	default:
+		*term = NULL;
+
+		return 1;
+	}
+}
+
+void task_push(struct CombinatorReadback *readback, enum CombinatorReadbackTaskType type, struct CombinatorNode *node, struct LambdaTerm *term)
+{
+	struct CombinatorReadbackTask task = {type, node, term};
+
+	readback->tasks = array_push(readback->tasks, &readback->tasks_size, &readback->tasks_capacity, sizeof(task), &task);
+}
+
+struct LambdaTerm *free_variable_readback(struct CombinatorReadback *readback, const char *name, int subscript)
+{
+	struct LambdaHandle *lambda = &readback->lambda;
+
+	struct LambdaTerm *term = term_create(FREE_VARIABLE);
+
+	for (size_t i = 0; i < lambda->free_variables_size; i++) {
+		struct Identifier free_variable = lambda->free_variables[i];
+
+		if (free_variable.subscript == subscript && strcmp(free_variable.name, name) == 0) {
+			term->expression.variable = free_variable;
+
+			return term;
+		}
+	}
+
+	if (lambda->free_variables_capacity == lambda->free_variables_size) {
+		// Scaling factor of 2
+
+		lambda->free_variables_capacity <<= 1;
+		lambda->free_variables = realloc(lambda->free_variables, sizeof(*lambda->free_variables) * lambda->free_variables_capacity);
+
+		if (lambda->free_variables == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	struct Identifier free_variable;
+
+	free_variable.name = malloc(strlen(name) + 1);
+	free_variable.subscript = subscript;
+
+	if (free_variable.name == NULL) {
+		goto fatal_error;
+	}
+
+	strcpy(free_variable.name, name);
+
+	lambda->free_variables[lambda->free_variables_size++] = free_variable;
+
+	term->expression.variable = free_variable;
+
+	return term;
+
+	fatal_error:
+
+	printf("Fatal error: memory allocation failed in function free_variable_readback().\n");
+	exit(1);
+}
+
+// Helpers
+
+struct CombinatorNode *node_create(struct CombinatorMachine *machine, enum CombinatorNodeType type)
+{
+	struct CombinatorNode *node = arena_alloc(&machine->arena, sizeof(*node));
+
+	node->type = type;
+	node->flags = 0;
+
+	machine->stats.nodes++;
+
+	return node;
+}
+
+struct CombinatorNode *constant_create(struct CombinatorMachine *machine, enum Combinator combinator)
+{
+	struct CombinatorNode *node = node_create(machine, COMBINATOR_CONSTANT);
+
+	node->combinator = combinator;
+
+	return node;
+}
+
+struct CombinatorNode *application_create(struct CombinatorMachine *machine, struct CombinatorNode *function, struct CombinatorNode *argument)
+{
+	struct CombinatorNode *node = node_create(machine, COMBINATOR_APPLICATION);
+
+	node->application.function = function;
+	node->application.argument = argument;
+
+	return node;
+}
+
+struct CombinatorNode *combinator_forward(struct CombinatorNode *node)
+{
+	// Follows indirections, halving the path on the way
+
+	while (node->type == COMBINATOR_INDIRECTION) {
+		struct CombinatorNode *target = node->indirection;
+
+		if (target->type == COMBINATOR_INDIRECTION) {
+			node->indirection = target->indirection;
+		}
+
+		node = target;
+	}
+
+	return node;
+}
+
+void scope_push(struct Scope *scope, const struct Identifier *identifier, struct LambdaTerm *abstraction)
+{
+	if (scope->size == scope->capacity) {
+		// Scaling factor of 2
+
+		scope->capacity = scope->capacity == 0 ? INITIAL_CAPACITY : scope->capacity << 1;
+
+		scope->identifiers = realloc(scope->identifiers, sizeof(*scope->identifiers) * scope->capacity);
+		scope->abstractions = realloc(scope->abstractions, sizeof(*scope->abstractions) * scope->capacity);
+
+		if (scope->identifiers == NULL || scope->abstractions == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	scope->identifiers[scope->size] = identifier;
+	scope->abstractions[scope->size] = abstraction;
+	scope->size++;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function scope_push().\n");
+	exit(1);
+}
+
+void stack_push(struct CombinatorMachine *machine, struct CombinatorNode *node)
+{
+	// Keeps one spare slot above the top, used by machine_contract() to hand the redex root back
+
+	if (machine->stack_capacity - machine->stack_size <= 1) {
+		// Scaling factor of 2
+
+		machine->stack_capacity = machine->stack_capacity == 0 ? INITIAL_CAPACITY : machine->stack_capacity << 1;
+		machine->stack = realloc(machine->stack, sizeof(*machine->stack) * machine->stack_capacity);
+
+		if (machine->stack == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	machine->stack[machine->stack_size++] = node;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function stack_push().\n");
+	exit(1);
+}
+
+struct LambdaTerm *term_create(enum ExpressionType type)
+{
+	struct LambdaTerm *term = malloc(sizeof(*term));
+
+	if (term == NULL) {
+		goto fatal_error;
+	}
+
+	term->type = type;
+
+	return term;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function term_create().\n");
+	exit(1);
+}
+
+void *array_push(void *array, size_t *size, size_t *capacity, size_t element_size, const void *element)
+{
+	if (*size == *capacity) {
+		// Scaling factor of 2
+
+		*capacity = *capacity == 0 ? INITIAL_CAPACITY : *capacity << 1;
+
+		array = realloc(array, element_size * *capacity);
+
+		if (array == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	memcpy((char *)array + *size * element_size, element, element_size);
+	(*size)++;
+
+	return array;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function array_push().\n");
+	exit(1);
+}
\ No newline at end of file
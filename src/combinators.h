@@ -0,0 +1,80 @@
+#pragma once
+
+#include <arena.h>
+#include <evaluation.h>
+#include <hashmap.h>
+#include <lambda.h>
+#include <linking.h>
+
+// Combinator backend
+// Terms are compiled by bracket abstraction into Turner's extended combinator set, so no environment or variable is left
+// at runtime. The resulting graph is reduced in place by a machine walking the spine on an explicit stack, and
+// read back into a lambda term by applying partial combinator applications to fresh variables.
+// Bracket abstraction contracts eta redexes, so results are normal forms up to eta conversion.
+
+enum Combinator {
+	COMBINATOR_S,		// S f g x = f x (g x)
+	COMBINATOR_K,		// K x y = x
+	COMBINATOR_I,		// I x = x
+	COMBINATOR_B,		// B f g x = f (g x)
+	COMBINATOR_C,		// C f g x = f x g
+	COMBINATOR_S_PRIME,	// S' c f g x = c (f x) (g x)
+	COMBINATOR_B_STAR,	// B* c f g x = c (f (g x))
+	COMBINATOR_C_PRIME	// C' c f g x = c (f x) g
+};
+
+enum CombinatorNodeType {
+	COMBINATOR_APPLICATION,
+	COMBINATOR_CONSTANT,
+	COMBINATOR_CHURCH_NUMERAL,	// Primitive of arity 2
+	COMBINATOR_VARIABLE,		// Variable of the given level, only present while compiling and reading back
+	COMBINATOR_FREE_VARIABLE,
+	COMBINATOR_REFERENCE,		// Linked definition, compiled only once it reaches the head position
+	COMBINATOR_INDIRECTION
+};
+
+struct CombinatorNode {
+	enum CombinatorNodeType type;
+	unsigned int flags;
+
+	union {
+		enum Combinator combinator;
+
+		int church_numeral;
+
+		size_t level;
+
+		const struct Identifier *free_variable;
+
+		struct Linkage *reference;
+
+		struct CombinatorNode *indirection;
+
+		struct CombinatorApplication {
+			struct CombinatorNode *function;
+			struct CombinatorNode *argument;
+		} application;
+	};
+};
+
+struct CombinatorMachine {
+	struct Arena arena;
+	struct Linker linker;
+
+	struct CombinatorNode *root;
+
+	struct CombinatorNode **stack;	// Spine stack
+	size_t stack_size;
+	size_t stack_capacity;
+
+	size_t step_limit;		// Maximum number of combinator reductions, 0 meaning unlimited
+
+	struct EvaluationStats stats;	// beta_steps counts combinator reductions, delta_steps compiled definitions
+};
+
+struct CombinatorMachine combinators_create(struct LambdaHandle lambda, const struct HashMap *definitions);	// Link and compile lambda
+void combinators_destroy(struct CombinatorMachine machine);							// Release the graph
+
+struct LambdaHandle combinators_readback(struct CombinatorMachine *machine);	// Reduce to normal form while reading back
+
+struct LambdaHandle combinators_evaluate(struct LambdaHandle lambda, const struct HashMap *definitions, struct EvaluationStats *stats);	// Evaluate a term to its normal form with the combinator backend
\ No newline at end of file
@@ -0,0 +1,2282 @@
+#include <evaluation.h>
+#include <fingerprint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+// Enclosing binders of a state being fingerprinted, innermost first
+
+struct BinderScope {
+	const struct Node *binder;
+	const struct BinderScope *next;
+};
+
+// Pair of nodes compared by lambda_equivalent(), each under the binders opened on its side
+
+struct EquivalencePair {
+	struct Node *left;
+	struct Node *right;
+
+	const struct BinderScope *left_scope;
+	const struct BinderScope *right_scope;
+};
+
+// Pairs left to compare, and closed pairs met so far
+
+struct Equivalence {
+	struct EquivalencePair *queue;		// Pairs from begin to size are pending, level by level
+	size_t begin;
+	size_t size;
+	size_t capacity;
+
+	struct Node **visited;			// Open addressing table of closed pairs, left node then right node
+	size_t visited_size;
+	size_t visited_capacity;		// In pairs, a power of 2
+
+	struct EquivalencePair comparing;	// The pair whose sides are being reduced
+};
+
+static struct Evaluation evaluation_link(struct LambdaHandle lambda, const struct HashMap *definitions, int original);
+
+// Graph subroutines
+
+static struct Node *node_create(struct Evaluation *evaluation, enum NodeType type);
+static struct Node *node_instantiate(struct Evaluation *evaluation, struct Node *node, struct Node *binder, struct Node *argument, size_t *reach);
+static struct Node *redex_contract(struct Evaluation *evaluation, struct Node *abstraction, struct Node *argument);
+static struct Node *node_whnf(struct Evaluation *evaluation, struct Node *node);
+static int node_normalize(struct Evaluation *evaluation, struct Node *node);
+
+static struct Node *term_compile(struct Evaluation *evaluation, const struct LambdaTerm *term, struct Linkage *linkage, size_t *reach);
+static struct Node *reference_unfold(struct Evaluation *evaluation, struct Node *node);
+static struct Node *church_numeral_expand(struct Evaluation *evaluation, struct Node *node);
+
+static int step_admit(struct Evaluation *evaluation);
+static struct Node *fixpoint_tie(struct Evaluation *evaluation, struct Node *combinator);
+static struct Node *fixpoint_unfold(struct Evaluation *evaluation, struct Node *node, size_t base);
+static unsigned int fixpoint_shape(const struct Node *node);
+static struct Node *application_build(struct Evaluation *evaluation, struct Node *function, struct Node *argument);
+static unsigned int fixpoint_half(const struct Node *half, const struct Node *function);
+static int turing_half_is(const struct Node *half);
+static int self_application_is(const struct Node *node, const struct Node *binder);
+static int variable_is(const struct Node *node, const struct Node *binder);
+
+static struct Node *node_optimize(struct Evaluation *evaluation, struct Node *node, size_t arguments);
+static struct Node *abstraction_eta_reduce(struct Evaluation *evaluation, struct Node *node);
+static size_t binder_uses(const struct Node *node, const struct Node *binder, size_t leading, int under, int *guarded);
+static int atom_is(const struct Node *node);
+static int linkage_inlinable(struct Linkage *linkage);
+static int linkage_reaches(struct Linkage *linkage, const struct Linkage *target);
+static int term_fits(const struct LambdaTerm *term, size_t *budget);
+
+static int loop_check(struct Evaluation *evaluation, struct Node *node);
+static int state_fingerprint(struct Node *node, const struct BinderScope *scope, size_t *budget, uint64_t *fingerprint);
+
+static int pair_compare(struct Evaluation *evaluation, struct Equivalence *equivalence, struct EquivalencePair pair);
+static int pair_visit(struct Equivalence *equivalence, struct Node *left, struct Node *right);
+static void pair_push(struct Equivalence *equivalence, struct EquivalencePair pair);
+static int pair_unsolvable(struct Evaluation *evaluation, struct Node *node);
+static void pair_evacuate(struct Evaluation *evaluation, struct EquivalencePair *pair);
+static void equivalence_roots(struct Evaluation *evaluation, void *context);
+static struct Node *binder_enter(struct Evaluation *evaluation, struct Node *node, const struct BinderScope **scope);
+static int head_equal(const struct Node *left, const struct BinderScope *left_scope, const struct Node *right, const struct BinderScope *right_scope);
+static size_t scope_index(const struct BinderScope *scope, const struct Node *binder);
+
+static size_t abstraction_close(struct Node *node, size_t level, size_t reach);
+static size_t application_close(struct Node *node, size_t function_reach, size_t argument_reach);
+static uint64_t binder_bit(const struct Node *binder);
+
+static struct Node *spine_dereference(struct Node *node);
+
+static int nursery_full(const struct Evaluation *evaluation);
+static void nursery_collect(struct Evaluation *evaluation, struct Node **head, struct Node **node);
+static void node_evacuate(struct Evaluation *evaluation, struct Node **slot);
+static void node_scan(struct Evaluation *evaluation, struct Node *node);
+static void node_redirect(struct Evaluation *evaluation, struct Node *node, struct Node *result);
+static void node_remember(struct Evaluation *evaluation, struct Node *node, const struct Node *target);
+
+static void stack_push(struct Evaluation *evaluation, struct Node *node);
+static void renaming_push(struct Evaluation *evaluation, struct Node *from, struct Node *to);
+
+static int identifier_equal(const struct Identifier *left, const struct Identifier *right);
+
+struct EvaluationControl evaluation_control;
+
+struct Evaluation evaluation_create(struct LambdaHandle lambda, const struct HashMap *definitions)
+{
+	return evaluation_link(lambda, definitions, 0);
+}
+
+struct Evaluation evaluation_create_profiled(struct LambdaHandle lambda, const struct HashMap *definitions)
+{
+	// Optimized definitions inline the small ones they apply, whose costs would then be charged to the caller, so the
+	// definitions are profiled as they were written
+
+	struct Evaluation evaluation = evaluation_link(lambda, definitions, 1);
+
+	evaluation.profiling = 1;
+
+	return evaluation;
+}
+
+struct Evaluation evaluation_link(struct LambdaHandle lambda, const struct HashMap *definitions, int original)
+{
+	struct Evaluation evaluation = {0};
+
+	evaluation.arena = arena_create();
+	evaluation.step_limit = DEFAULT_STEP_LIMIT;
+	evaluation.stats.status = EVALUATION_PENDING;
+
+	if (lambda.term == NULL) {
+		return evaluation;
+	}
+
+	// The evaluated term is linked like any stored definition, which resolves everything it can reach
+
+	evaluation.linker = linker_create(&evaluation.arena);
+	evaluation.linker.original = original;
+	evaluation.definitions = definitions;
+
+	struct Linkage *root = linker_link(&evaluation.linker, lambda, definitions);
+
+	size_t reach;
+
+	evaluation.origin = root;
+	evaluation.root = term_compile(&evaluation, lambda.term, root, &reach);
+
+	// The compiled term stays in the arena, as most of it lives as long as the evaluation, but what reduction
+	// allocates goes to the nursery
+
+	evaluation.generational = 1;
+
+	return evaluation;
+}
+
+void evaluation_destroy(struct Evaluation evaluation)
+{
+	linker_destroy(evaluation.linker);
+
+	free(evaluation.stack);
+	free(evaluation.renaming);
+	free(evaluation.remembered);
+	free(evaluation.nursery);
+
+	arena_destroy(evaluation.arena);
+}
+
+int evaluation_reduce(struct Evaluation *evaluation, enum EvaluationMode mode)
+{
+	if (evaluation->root == NULL) {
+		return 1;
+	}
+
+	evaluation->mode = mode;
+
+	struct Node *node = evaluation->root;
+
+	switch (mode) {
+	case EVALUATION_WHNF:
+		node_whnf(evaluation, node);
+		break;
+
+	case EVALUATION_HNF:
+		// Descending into the bodies of head abstractions only
+
+		node = node_whnf(evaluation, node);
+
+		while (evaluation->stats.status == EVALUATION_PENDING && node->type == NODE_ABSTRACTION) {
+			node = node_whnf(evaluation, abstraction_open(node));
+		}
+
+		break;
+
+	case EVALUATION_NF:
+	case EVALUATION_CBV:
+		node_normalize(evaluation, node);
+		break;
+	}
+
+	if (evaluation->stats.status != EVALUATION_PENDING) {
+		return 0;
+	}
+
+	evaluation->stats.status = EVALUATION_NORMAL_FORM;
+
+	return 1;
+}
+
+int node_normalize(struct Evaluation *evaluation, struct Node *node)
+{
+	// The head is reduced first, then the body of an abstraction or the arguments of a stuck application are
+	// normalized from left to right.
+	// The stack above base is used as the worklist, node_whnf() only ever uses the part above it.
+
+	size_t base = evaluation->stack_size;
+
+	stack_push(evaluation, node);
+
+	while (evaluation->stack_size > base) {
+		struct Node *node = evaluation->stack[--evaluation->stack_size];
+
+		node = node_whnf(evaluation, node);
+
+		if (evaluation->stats.status != EVALUATION_PENDING) {
+			evaluation->stack_size = base;
+			return 0;
+		}
+
+		// Shared subgraphs are only scheduled once
+
+		if (node->flags & NODE_NORMALIZED) {
+			continue;
+		}
+
+		node->flags |= NODE_NORMALIZED;
+
+		if (node->type == NODE_ABSTRACTION) {
+			stack_push(evaluation, abstraction_open(node));
+			continue;
+		}
+
+		// Pushing arguments right to left so they are popped left to right
+
+		while (node->type == NODE_APPLICATION) {
+			stack_push(evaluation, node->application.argument);
+
+			node = node_dereference(node->application.function);
+		}
+	}
+
+	return 1;
+}
+
+struct LambdaHandle lambda_evaluate(
+	struct LambdaHandle lambda, const struct HashMap *definitions,
+	enum EvaluationMode mode, struct EvaluationStats *stats
+)
+{
+	struct Evaluation evaluation = evaluation_create(lambda, definitions);
+
+	evaluation.folding = 1;
+	evaluation.loop_checking = 1;
+
+	evaluation_reduce(&evaluation, mode);
+
+	// Nodes in the nursery stay where they are while the result is read back
+
+	evaluation.generational = 0;
+
+	// A cancelled evaluation is released straight away instead of reading back a partial graph
+
+	struct LambdaHandle result = {0};
+
+	if (evaluation.stats.status != EVALUATION_CANCELLED) {
+		result = evaluation_readback(&evaluation);
+	}
+
+	if (stats != NULL) {
+		*stats = evaluation.stats;
+	}
+
+	evaluation_destroy(evaluation);
+
+	return result;
+}
+
+int lambda_fingerprint_normal_form(const struct HashMap *definitions, struct LambdaHandle lambda, uint64_t *fingerprint)
+{
+	// Definitions without a normal form within a few steps are left out of the index
+
+	struct Evaluation evaluation = evaluation_create(lambda, definitions);
+
+	evaluation.step_limit = FINGERPRINT_STEP_LIMIT;
+	evaluation.node_limit = FINGERPRINT_NODE_LIMIT;
+	evaluation.loop_checking = 1;
+
+	int found = evaluation_reduce(&evaluation, EVALUATION_NF);
+
+	if (found) {
+		struct LambdaHandle normal_form = evaluation_readback(&evaluation);
+
+		// A normal form too large to read back in full is left out as well
+
+		found = !evaluation.stats.truncated;
+
+		if (found) {
+			*fingerprint = lambda_fingerprint(normal_form);
+		}
+
+		lambda_free(normal_form);
+	}
+
+	evaluation_destroy(evaluation);
+
+	return found;
+}
+
+struct LambdaHandle lambda_optimize(const struct HashMap *definitions, struct LambdaHandle lambda)
+{
+	// Numerals are folded back but definitions are not, since their names would undo the inlining
+	// Nothing is returned when no rewrite applied, or when the evaluation was cancelled
+
+	struct Evaluation evaluation = evaluation_create(lambda, definitions);
+
+	evaluation.step_limit = OPTIMIZATION_STEP_LIMIT;
+	evaluation.node_limit = FINGERPRINT_NODE_LIMIT;
+	evaluation.folding = 1;
+	evaluation.definitions = NULL;
+
+	struct LambdaHandle optimized = {0};
+
+	if (evaluation.root != NULL) {
+		evaluation.root = node_optimize(&evaluation, evaluation.root, 0);
+	}
+
+	if (evaluation.stats.status != EVALUATION_CANCELLED && evaluation.stats.beta_steps + evaluation.stats.delta_steps != 0) {
+		optimized = evaluation_readback(&evaluation);
+
+		// The definition is kept as written rather than replaced by an elided term
+
+		if (evaluation.stats.truncated) {
+			lambda_free(optimized);
+
+			optimized = (struct LambdaHandle){0};
+		}
+	}
+
+	evaluation_destroy(evaluation);
+
+	return optimized;
+}
+
+int lambda_equivalent(
+	struct LambdaHandle left, struct LambdaHandle right, const struct HashMap *definitions, struct EvaluationStats *stats
+)
+{
+	// Both terms are compiled into the same graph, so the definitions they use are the same nodes on both sides
+
+	struct Evaluation evaluation = evaluation_create(left, definitions);
+
+	evaluation.node_limit = EQUIVALENCE_LIMIT;
+	evaluation.loop_checking = 1;
+
+	int equivalent = -1;
+
+	if (evaluation.root != NULL && right.term != NULL) {
+		struct Linkage *linkage = linker_link(&evaluation.linker, right, definitions);
+
+		size_t reach;
+
+		evaluation.origin = linkage;
+
+		struct Node *node = term_compile(&evaluation, right.term, linkage, &reach);
+
+		struct Equivalence equivalence = {0};
+
+		pair_push(&equivalence, (struct EquivalencePair){evaluation.root, node, NULL, NULL});
+
+		evaluation.roots = equivalence_roots;
+		evaluation.roots_context = &equivalence;
+
+		// Comparisons reducing nothing are limited and polled as well, since shared subterms can unfold into
+		// exponentially many pairs
+
+		size_t compared = 0;
+
+		equivalent = 1;
+
+		while (equivalent == 1 && equivalence.begin < equivalence.size) {
+			if (++compared > EQUIVALENCE_LIMIT) {
+				evaluation.stats.status = EVALUATION_STEP_LIMIT;
+				equivalent = -1;
+				break;
+			}
+
+			if ((compared & (EVALUATION_POLL_INTERVAL - 1)) == 0 && !evaluation_poll(&evaluation.stats)) {
+				equivalent = -1;
+				break;
+			}
+
+			equivalent = pair_compare(&evaluation, &equivalence, equivalence.queue[equivalence.begin++]);
+		}
+
+		free(equivalence.queue);
+		free(equivalence.visited);
+	}
+
+	if (equivalent != -1) {
+		evaluation.stats.status = EVALUATION_NORMAL_FORM;
+	}
+
+	if (stats != NULL) {
+		*stats = evaluation.stats;
+	}
+
+	evaluation_destroy(evaluation);
+
+	return equivalent;
+}
+
+int pair_compare(struct Evaluation *evaluation, struct Equivalence *equivalence, struct EquivalencePair pair)
+{
+	// Returns 1 once the pair is equated or its subterms queued, 0 once it is told apart and -1 once a limit is hit
+
+	struct Node *left = node_dereference(pair.left);
+	struct Node *right = node_dereference(pair.right);
+
+	// The same node is the same term when its variables, if any, are bound by the same binders on both sides
+
+	if (left == right && ((left->flags & NODE_CLOSED) || pair.left_scope == pair.right_scope)) {
+		return 1;
+	}
+
+	if ((left->flags & right->flags & NODE_CLOSED) && pair_visit(equivalence, left, right)) {
+		return 1;
+	}
+
+	// Variables of both sides are hashed by their position in the scopes, which have the same depth
+
+	size_t left_budget = EQUIVALENCE_FINGERPRINT_BUDGET;
+	size_t right_budget = EQUIVALENCE_FINGERPRINT_BUDGET;
+	uint64_t left_fingerprint;
+	uint64_t right_fingerprint;
+
+	if (state_fingerprint(left, pair.left_scope, &left_budget, &left_fingerprint) &&
+		state_fingerprint(right, pair.right_scope, &right_budget, &right_fingerprint) &&
+		left_fingerprint == right_fingerprint) {
+		return 1;
+	}
+
+	// Each side may be moved out of the nursery while the other one is reduced
+
+	equivalence->comparing = (struct EquivalencePair){left, right, pair.left_scope, pair.right_scope};
+	equivalence->comparing.left = evaluation_whnf(evaluation, equivalence->comparing.left);
+
+	if (evaluation->stats.status == EVALUATION_LOOP) {
+		right = equivalence->comparing.right;
+		equivalence->comparing = (struct EquivalencePair){0};
+
+		return pair_unsolvable(evaluation, right);
+	}
+
+	if (evaluation->stats.status != EVALUATION_PENDING) {
+		return -1;
+	}
+
+	right = evaluation_whnf(evaluation, equivalence->comparing.right);
+	left = equivalence->comparing.left;
+
+	equivalence->comparing = (struct EquivalencePair){0};
+
+	if (evaluation->stats.status == EVALUATION_LOOP) {
+		return pair_unsolvable(evaluation, left);
+	}
+
+	if (evaluation->stats.status != EVALUATION_PENDING) {
+		return -1;
+	}
+
+	if (left->type == NODE_CHURCH_NUMERAL && right->type == NODE_CHURCH_NUMERAL) {
+		return left->church_numeral == right->church_numeral;
+	}
+
+	// One binder is entered on each side, eta expanding a side without one, and the bodies are compared on the next level
+
+	if (left->type == NODE_ABSTRACTION || left->type == NODE_CHURCH_NUMERAL ||
+		right->type == NODE_ABSTRACTION || right->type == NODE_CHURCH_NUMERAL) {
+		pair.left = binder_enter(evaluation, left, &pair.left_scope);
+		pair.right = binder_enter(evaluation, right, &pair.right_scope);
+
+		pair_push(equivalence, pair);
+
+		return 1;
+	}
+
+	// Both sides are stuck applications or heads, which must have the same head and as many arguments
+
+	size_t left_arguments = 0;
+	size_t right_arguments = 0;
+
+	struct Node *left_head = left;
+	struct Node *right_head = right;
+
+	while (left_head->type == NODE_APPLICATION) {
+		left_head = node_dereference(left_head->application.function);
+		left_arguments++;
+	}
+
+	while (right_head->type == NODE_APPLICATION) {
+		right_head = node_dereference(right_head->application.function);
+		right_arguments++;
+	}
+
+	if (left_arguments != right_arguments || !head_equal(left_head, pair.left_scope, right_head, pair.right_scope)) {
+		return 0;
+	}
+
+	while (left->type == NODE_APPLICATION) {
+		pair.left = left->application.argument;
+		pair.right = right->application.argument;
+
+		pair_push(equivalence, pair);
+
+		left = node_dereference(left->application.function);
+		right = node_dereference(right->application.function);
+	}
+
+	return 1;
+}
+
+int pair_visit(struct Equivalence *equivalence, struct Node *left, struct Node *right)
+{
+	// Returns 1 if the closed pair was met before, adding it otherwise
+
+	if (equivalence->visited_size >= equivalence->visited_capacity / 2) {
+		// Scaling factor of 2
+
+		size_t capacity = equivalence->visited_capacity == 0 ? INITIAL_CAPACITY : equivalence->visited_capacity * 2;
+
+		struct Node **visited = calloc(capacity * 2, sizeof(*visited));
+
+		if (visited == NULL) {
+			goto fatal_error;
+		}
+
+		for (size_t i = 0; i < equivalence->visited_capacity; i++) {
+			if (equivalence->visited[i * 2] == NULL) {
+				continue;
+			}
+
+			uint64_t hash = fingerprint_application((uintptr_t)equivalence->visited[i * 2], (uintptr_t)equivalence->visited[i * 2 + 1]);
+			size_t slot = hash & (capacity - 1);
+
+			while (visited[slot * 2] != NULL) {
+				slot = (slot + 1) & (capacity - 1);
+			}
+
+			visited[slot * 2] = equivalence->visited[i * 2];
+			visited[slot * 2 + 1] = equivalence->visited[i * 2 + 1];
+		}
+
+		free(equivalence->visited);
+
+		equivalence->visited = visited;
+		equivalence->visited_capacity = capacity;
+	}
+
+	uint64_t hash = fingerprint_application((uintptr_t)left, (uintptr_t)right);
+	size_t slot = hash & (equivalence->visited_capacity - 1);
+
+	while (equivalence->visited[slot * 2] != NULL) {
+		if (equivalence->visited[slot * 2] == left && equivalence->visited[slot * 2 + 1] == right) {
+			return 1;
+		}
+
+		slot = (slot + 1) & (equivalence->visited_capacity - 1);
+	}
+
+	equivalence->visited[slot * 2] = left;
+	equivalence->visited[slot * 2 + 1] = right;
+	equivalence->visited_size++;
+
+	return 0;
+
+fatal_error:
+	printf("Fatal error: calloc() returned NULL in function pair_visit().\n");
+	exit(1);
+}
+
+void pair_push(struct Equivalence *equivalence, struct EquivalencePair pair)
+{
+	if (equivalence->size == equivalence->capacity) {
+		// Compared pairs are dropped first, then the queue grows by a scaling factor of 2
+
+		if (equivalence->begin >= equivalence->capacity / 2 && equivalence->begin != 0) {
+			memmove(equivalence->queue, equivalence->queue + equivalence->begin, (equivalence->size - equivalence->begin) * sizeof(*equivalence->queue));
+
+			equivalence->size -= equivalence->begin;
+			equivalence->begin = 0;
+		} else {
+			size_t capacity = equivalence->capacity == 0 ? INITIAL_CAPACITY : equivalence->capacity * 2;
+
+			struct EquivalencePair *queue = realloc(equivalence->queue, capacity * sizeof(*queue));
+
+			if (queue == NULL) {
+				goto fatal_error;
+			}
+
+			equivalence->queue = queue;
+			equivalence->capacity = capacity;
+		}
+	}
+
+	equivalence->queue[equivalence->size++] = pair;
+
+	return;
+
+fatal_error:
+	printf("Fatal error: realloc() returned NULL in function pair_push().\n");
+	exit(1);
+}
+
+int pair_unsolvable(struct Evaluation *evaluation, struct Node *node)
+{
+	// Called once the weak head reduction of the other side of a pair looped, which leaves it without a head normal
+	// form. Returns 0 if node has one, and -1 once a limit is hit or node loops as well: two unsolvable terms which
+	// aren't the same term may still differ, like Ω and y Ω, and beta eta conversion can't tell them apart from a loop
+	// alone. The loop found no longer stands for the reductions to come, unless it ends the comparison.
+
+	evaluation->stats.status = EVALUATION_PENDING;
+	evaluation->loop.owner = NULL;
+
+	while (1) {
+		node = evaluation_whnf(evaluation, node);
+
+		if (evaluation->stats.status != EVALUATION_PENDING) {
+			return -1;
+		}
+
+		if (node->type != NODE_ABSTRACTION) {
+			return 0;
+		}
+
+		node = abstraction_open(node);
+	}
+}
+
+void pair_evacuate(struct Evaluation *evaluation, struct EquivalencePair *pair)
+{
+	// Scopes are shared between pairs, and evacuating a binder again just finds its copy
+
+	evaluation_evacuate(evaluation, &pair->left);
+	evaluation_evacuate(evaluation, &pair->right);
+
+	for (struct BinderScope *scope = (struct BinderScope *)pair->left_scope; scope != NULL; scope = (struct BinderScope *)scope->next) {
+		evaluation_evacuate(evaluation, (struct Node **)&scope->binder);
+	}
+
+	for (struct BinderScope *scope = (struct BinderScope *)pair->right_scope; scope != NULL; scope = (struct BinderScope *)scope->next) {
+		evaluation_evacuate(evaluation, (struct Node **)&scope->binder);
+	}
+}
+
+void equivalence_roots(struct Evaluation *evaluation, void *context)
+{
+	// Closed pairs met so far are forgotten rather than hashed again, since nodes moved and the nursery gets reused:
+	// they only serve to cut cycles, which are then met again
+
+	struct Equivalence *equivalence = context;
+
+	for (size_t i = equivalence->begin; i < equivalence->size; i++) {
+		pair_evacuate(evaluation, equivalence->queue + i);
+	}
+
+	pair_evacuate(evaluation, &equivalence->comparing);
+
+	if (equivalence->visited != NULL) {
+		memset(equivalence->visited, 0, sizeof(*equivalence->visited) * equivalence->visited_capacity * 2);
+	}
+
+	equivalence->visited_size = 0;
+}
+
+struct Node *binder_enter(struct Evaluation *evaluation, struct Node *node, const struct BinderScope **scope)
+{
+	// Pushes a binder onto scope and returns the node under it: the body of an abstraction, or any other node applied to
+	// the variable of a fresh binder, which is never reduced itself
+
+	static const struct Identifier variable_name = {"v", -1};
+
+	struct BinderScope *inner = arena_alloc(&evaluation->arena, sizeof(*inner));
+
+	inner->next = *scope;
+	*scope = inner;
+
+	if (node->type == NODE_CHURCH_NUMERAL) {
+		node = church_numeral_expand(evaluation, node);
+	}
+
+	if (node->type == NODE_ABSTRACTION) {
+		inner->binder = node;
+
+		return abstraction_open(node);
+	}
+
+	struct Node *binder = node_create(evaluation, NODE_ABSTRACTION);
+	struct Node *variable = node_create(evaluation, NODE_VARIABLE);
+
+	variable->binder = binder;
+	variable->binders = binder_bit(binder);
+
+	binder->abstraction.bound_variable = &variable_name;
+	binder->abstraction.body = variable;
+
+	abstraction_close(binder, 1, 1);
+
+	inner->binder = binder;
+
+	return application_build(evaluation, node, variable);
+}
+
+int head_equal(const struct Node *left, const struct BinderScope *left_scope, const struct Node *right, const struct BinderScope *right_scope)
+{
+	if (left->type != right->type) {
+		return 0;
+	}
+
+	switch (left->type) {
+	case NODE_VARIABLE:
+		// Bound at the same depth on both sides, or by the same binder outside both scopes
+
+		size_t index = scope_index(left_scope, left->binder);
+
+		if (index != scope_index(right_scope, right->binder)) {
+			return 0;
+		}
+
+		return index != SIZE_MAX || left->binder == right->binder;
+
+	case NODE_FREE_VARIABLE:
+		return identifier_equal(left->free_variable, right->free_variable);
+
+	case NODE_REFERENCE:
+		// Left folded by a limit, every occurrence of a definition being the same node
+
+		return left == right;
+
+	default:
+		return 0;
+	}
+}
+
+size_t scope_index(const struct BinderScope *scope, const struct Node *binder)
+{
+	// Position of binder in scope, innermost first, or SIZE_MAX if it is outside of it
+
+	for (size_t index = 0; scope != NULL; scope = scope->next, index++) {
+		if (scope->binder == binder) {
+			return index;
+		}
+	}
+
+	return SIZE_MAX;
+}
+
+int evaluation_poll(struct EvaluationStats *stats)
+{
+	atomic_store_explicit(&evaluation_control.beta_steps, stats->beta_steps, memory_order_relaxed);
+	atomic_store_explicit(&evaluation_control.nodes, stats->nodes, memory_order_relaxed);
+
+	if (atomic_load_explicit(&evaluation_control.cancel, memory_order_relaxed)) {
+		stats->status = EVALUATION_CANCELLED;
+		return 0;
+	}
+
+	return 1;
+}
+
+struct Node *evaluation_whnf(struct Evaluation *evaluation, struct Node *node)
+{
+	evaluation->mode = EVALUATION_NF;
+
+	return node_whnf(evaluation, node);
+}
+
+struct Node *node_whnf(struct Evaluation *evaluation, struct Node *node)
+{
+	// Unwinds the spine of node onto the stack and contracts head redexes until the head is an abstraction without
+	// arguments or a variable.
+	// Every contracted application is overwritten with an indirection, so node always derefers to the current result.
+	// Applications on the stack are marked as visited: meeting one again means the term needs its own value to reduce,
+	// which only happens through the cycles of recursive definitions and fixpoints.
+
+	size_t base = evaluation->stack_size;
+
+	struct Node *head = spine_dereference(node);
+
+	while (1) {
+		// Nested reductions of applicative order hold nodes the collector can't see
+
+		if (nursery_full(evaluation) && evaluation->depth == 0) {
+			nursery_collect(evaluation, &head, &node);
+		}
+
+		switch (head->type) {
+		case NODE_APPLICATION:
+			if (head->flags & NODE_VISITING) {
+				evaluation->stats.status = EVALUATION_LOOP;
+				evaluation->stats.loop_period = 0;
+				goto end;
+			}
+
+			// Θ is an application, recognized before it gets unwound
+
+			if ((head->flags & NODE_COMBINATOR) && evaluation->stack_size != base) {
+				if (!step_admit(evaluation)) {
+					goto end;
+				}
+
+				struct Node *fixpoint = fixpoint_tie(evaluation, head);
+
+				if (fixpoint != NULL) {
+					head = fixpoint;
+					continue;
+				}
+			}
+
+			head->flags |= NODE_VISITING;
+
+			stack_push(evaluation, head);
+
+			head = spine_dereference(head->application.function);
+
+			continue;
+
+		case NODE_REFERENCE:
+			head = reference_unfold(evaluation, head);
+
+			if (evaluation->stats.status != EVALUATION_PENDING) {
+				goto end;
+			}
+
+			continue;
+
+		case NODE_FIXPOINT:
+			head = fixpoint_unfold(evaluation, head, base);
+
+			continue;
+
+		case NODE_CHURCH_NUMERAL:
+			if (evaluation->stack_size == base) {
+				goto end;
+			}
+
+			head = church_numeral_expand(evaluation, head);
+
+			continue;
+
+		case NODE_ABSTRACTION:
+			if (evaluation->stack_size == base) {
+				goto end;
+			}
+
+			if (!step_admit(evaluation)) {
+				goto end;
+			}
+
+			// A fixpoint combinator applied to a closed function is contracted without copying anything
+
+			if (head->flags & NODE_COMBINATOR) {
+				struct Node *fixpoint = fixpoint_tie(evaluation, head);
+
+				if (fixpoint != NULL) {
+					head = fixpoint;
+					continue;
+				}
+			}
+
+			// Applicative order normalizes the argument before it gets substituted, unless it is dropped
+
+			if (evaluation->mode == EVALUATION_CBV && (head->flags & NODE_UNUSED) == 0) {
+				struct Node *argument = evaluation->stack[evaluation->stack_size - 1]->application.argument;
+
+				if (evaluation->depth == DEPTH_LIMIT) {
+					evaluation->stats.status = EVALUATION_DEPTH_LIMIT;
+					goto end;
+				}
+
+				evaluation->depth++;
+
+				int normalized = node_normalize(evaluation, argument);
+
+				evaluation->depth--;
+
+				if (!normalized) {
+					goto end;
+				}
+			}
+
+			struct Node *application = evaluation->stack[--evaluation->stack_size];
+			struct Node *argument = application->application.argument;
+
+			application->flags &= ~NODE_VISITING;
+
+			struct Node *result = redex_contract(evaluation, head, argument);
+
+			evaluation->stats.beta_steps++;
+
+			if (evaluation->profiling) {
+				head->origin->beta_steps++;
+			}
+
+			// A redex whose contractum stands for the redex itself would forward to itself
+
+			if (node_dereference(result) == application) {
+				evaluation->stats.status = EVALUATION_LOOP;
+				evaluation->stats.loop_period = 0;
+				goto end;
+			}
+
+			node_redirect(evaluation, application, result);
+
+			head = spine_dereference(result);
+
+			if (evaluation->loop_checking && evaluation->stats.beta_steps >= evaluation->loop.next && !loop_check(evaluation, node)) {
+				goto end;
+			}
+
+			continue;
+
+		default:
+			goto end;
+		}
+	}
+
+	end:
+
+	for (size_t i = base; i < evaluation->stack_size; i++) {
+		evaluation->stack[i]->flags &= ~NODE_VISITING;
+	}
+
+	evaluation->stack_size = base;
+
+	return node_dereference(node);
+}
+
+struct Node *application_build(struct Evaluation *evaluation, struct Node *function, struct Node *argument)
+{
+	struct Node *application = node_create(evaluation, NODE_APPLICATION);
+
+	application->application.function = function;
+	application->application.argument = argument;
+
+	application_close(application, function->flags & NODE_CLOSED ? SIZE_MAX : 0, argument->flags & NODE_CLOSED ? SIZE_MAX : 0);
+
+	return application;
+}
+
+int step_admit(struct Evaluation *evaluation)
+{
+	// Returns 0 once a limit is hit or the evaluation is cancelled, checked before every beta step
+
+	if (evaluation->step_limit != 0 && evaluation->stats.beta_steps >= evaluation->step_limit) {
+		evaluation->stats.status = EVALUATION_STEP_LIMIT;
+		return 0;
+	}
+
+	if (evaluation->node_limit != 0 && evaluation->stats.nodes >= evaluation->node_limit) {
+		evaluation->stats.status = EVALUATION_STEP_LIMIT;
+		return 0;
+	}
+
+	if ((evaluation->stats.beta_steps & (EVALUATION_POLL_INTERVAL - 1)) == 0 && !evaluation_poll(&evaluation->stats)) {
+		return 0;
+	}
+
+	return 1;
+}
+
+int loop_check(struct Evaluation *evaluation, struct Node *node)
+{
+	// Returns 0 once a loop is found, with the stats telling its period
+	// Another reduction taking over the checkpoints drops the previous ones, while the spacing keeps growing with the
+	// steps of the whole evaluation so that short reductions in a row don't get fingerprinted at every step
+
+	struct LoopCheck *loop = &evaluation->loop;
+	size_t steps = evaluation->stats.beta_steps;
+
+	if (loop->spacing == 0) {
+		loop->spacing = 1;
+	}
+
+	if (loop->owner != node) {
+		loop->owner = node;
+		loop->size = 0;
+		loop->searching = 0;
+	}
+
+	uint64_t fingerprint;
+	size_t budget = LOOP_FINGERPRINT_BUDGET;
+
+	int fingerprinted = state_fingerprint(node_dereference(node), NULL, &budget, &fingerprint);
+
+	if (loop->searching) {
+		loop->next = steps + 1;
+
+		if (!fingerprinted || (fingerprint != loop->target && steps - loop->found < loop->repetition)) {
+			return 1;
+		}
+
+		evaluation->stats.loop_period = fingerprint == loop->target ? steps - loop->found : loop->repetition;
+		evaluation->stats.status = EVALUATION_LOOP;
+
+		return 0;
+	}
+
+	loop->next = steps + loop->spacing;
+
+	if (++loop->taken == LOOP_CHECKPOINTS) {
+		loop->spacing <<= 1;
+		loop->taken = 0;
+	}
+
+	// States too large to fingerprint are left unchecked
+
+	if (!fingerprinted) {
+		return 1;
+	}
+
+	for (size_t i = 0; i < loop->size; i++) {
+		if (loop->fingerprints[i] != fingerprint) {
+			continue;
+		}
+
+		loop->repetition = steps - loop->steps[i];
+
+		// The shortest period divides the repetition, every step until it shows up is fingerprinted if affordable
+
+		size_t state_size = LOOP_FINGERPRINT_BUDGET - budget + 1;
+
+		if (loop->repetition > 1 && loop->repetition <= LOOP_SEARCH_BUDGET / state_size) {
+			loop->searching = 1;
+			loop->target = fingerprint;
+			loop->found = steps;
+			loop->next = steps + 1;
+
+			return 1;
+		}
+
+		evaluation->stats.loop_period = loop->repetition;
+		evaluation->stats.status = EVALUATION_LOOP;
+
+		return 0;
+	}
+
+	// The oldest checkpoint makes room for the new one
+
+	if (loop->size == LOOP_CHECKPOINTS) {
+		memmove(loop->fingerprints, loop->fingerprints + 1, sizeof(*loop->fingerprints) * (LOOP_CHECKPOINTS - 1));
+		memmove(loop->steps, loop->steps + 1, sizeof(*loop->steps) * (LOOP_CHECKPOINTS - 1));
+
+		loop->size--;
+	}
+
+	loop->fingerprints[loop->size] = fingerprint;
+	loop->steps[loop->size] = steps;
+	loop->size++;
+
+	return 1;
+}
+
+int state_fingerprint(struct Node *node, const struct BinderScope *scope, size_t *budget, uint64_t *fingerprint)
+{
+	// Alpha invariant fingerprint of the term a node stands for
+	// Unfolded definitions are reduced in place, so their graph is part of the state. A definition met again inside its
+	// own graph is hashed by name, which stands for the graph being hashed already.
+	// Variables bound outside the state are hashed by binder. Returns 0 once budget nodes have been visited
+
+	node = node_forward(node);
+
+	if (*budget == 0) {
+		return 0;
+	}
+
+	--*budget;
+
+	switch (node->type) {
+	case NODE_VARIABLE:
+		size_t index = 0;
+
+		for (const struct BinderScope *binder = scope; binder != NULL; binder = binder->next, index++) {
+			if (binder->binder == node->binder) {
+				*fingerprint = fingerprint_variable(index);
+				return 1;
+			}
+		}
+
+		*fingerprint = fingerprint_variable(node->binder->abstraction.stamp);
+		return 1;
+
+	case NODE_ABSTRACTION:
+		struct BinderScope inner = {node, scope};
+
+		if (!state_fingerprint(node->abstraction.body, &inner, budget, fingerprint)) {
+			return 0;
+		}
+
+		*fingerprint = fingerprint_abstraction(*fingerprint);
+		return 1;
+
+	case NODE_APPLICATION:
+		uint64_t function;
+
+		if (!state_fingerprint(node->application.function, scope, budget, &function) ||
+			!state_fingerprint(node->application.argument, scope, budget, fingerprint)) {
+			return 0;
+		}
+
+		*fingerprint = fingerprint_application(function, *fingerprint);
+		return 1;
+
+	case NODE_FIXPOINT:
+		// Hashed as the combinator applied to the function, which the value of the fixpoint only unfolds
+
+		if (!state_fingerprint(node->fixpoint->combinator, scope, budget, &function) ||
+			!state_fingerprint(node->fixpoint->function, scope, budget, fingerprint)) {
+			return 0;
+		}
+
+		*fingerprint = fingerprint_application(function, *fingerprint);
+		return 1;
+
+	case NODE_FREE_VARIABLE:
+		*fingerprint = fingerprint_free_variable(node->free_variable);
+		return 1;
+
+	case NODE_REFERENCE:
+		if (node->reference->unfolded == NULL || (node->flags & NODE_VISITING)) {
+			*fingerprint = fingerprint_free_variable(&node->reference->definition.identifier);
+			return 1;
+		}
+
+		node->flags |= NODE_VISITING;
+
+		int fingerprinted = state_fingerprint(node->reference->unfolded, scope, budget, fingerprint);
+
+		node->flags &= ~NODE_VISITING;
+
+		return fingerprinted;
+
+	case NODE_CHURCH_NUMERAL:
+		if ((size_t)node->church_numeral > *budget) {
+			return 0;
+		}
+
+		*budget -= (size_t)node->church_numeral;
+
+		*fingerprint = fingerprint_church_numeral(node->church_numeral);
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+struct Node *redex_contract(struct Evaluation *evaluation, struct Node *abstraction, struct Node *argument)
+{
+	// The body of an unused binder is the contractum as it is, and the argument is dropped without being looked at
+	// The copied body is attributed to the definition the abstraction comes from
+
+	if (abstraction->flags & NODE_UNUSED) {
+		return abstraction->abstraction.body;
+	}
+
+	evaluation->origin = abstraction->origin;
+	evaluation->renamed = 0;
+	evaluation->replaced = binder_bit(abstraction);
+
+	size_t reach;
+
+	return node_instantiate(evaluation, abstraction->abstraction.body, abstraction, argument, &reach);
+}
+
+struct Node *node_instantiate(struct Evaluation *evaluation, struct Node *node, struct Node *binder, struct Node *argument, size_t *reach)
+{
+	// Copies the body of binder, replacing its variable by the shared argument
+	// Binders inside the body are copied as well, and renaming maps their variables to the copies
+	// Only indirections are followed: definitions are closed, so their references are shared rather than copied
+	// reach is the level of the outermost copied binder the copy refers to, 0 for binders outside the body and SIZE_MAX
+	// if none, which tells whether a copied abstraction is closed
+
+	node = node_forward(node);
+
+	// Closed subterms and subterms without any variable being replaced or renamed are shared in constant time
+
+	if ((node->flags & NODE_CLOSED) || (node->binders & (evaluation->renamed | evaluation->replaced)) == 0) {
+		*reach = node->flags & NODE_CLOSED ? SIZE_MAX : 0;
+
+		return node;
+	}
+
+	switch (node->type) {
+	case NODE_VARIABLE:
+		if (node->binder == binder) {
+			*reach = argument->flags & NODE_CLOSED ? SIZE_MAX : 0;
+
+			if (binder->flags & NODE_LINEAR) {
+				evaluation->replaced = 0;
+			}
+
+			return argument;
+		}
+
+		for (size_t i = evaluation->renaming_size; i > 0; i -= 2) {
+			if (evaluation->renaming[i - 2] == node->binder) {
+				struct Node *variable = node_create(evaluation, NODE_VARIABLE);
+
+				variable->binder = evaluation->renaming[i - 1];
+				variable->binders = binder_bit(variable->binder);
+
+				*reach = i >> 1;
+
+				return variable;
+			}
+		}
+
+		// Variables bound outside the body are shared
+
+		*reach = 0;
+
+		return node;
+
+	case NODE_ABSTRACTION:
+		struct Node *abstraction = node_create(evaluation, NODE_ABSTRACTION);
+
+		abstraction->abstraction.bound_variable = node->abstraction.bound_variable;
+
+		// The copy uses its variable as often as the original, the argument being bound outside of it
+
+		abstraction->flags |= node->flags & (NODE_UNUSED | NODE_LINEAR);
+
+		uint64_t renamed = evaluation->renamed;
+
+		renaming_push(evaluation, node, abstraction);
+
+		evaluation->renamed |= binder_bit(node);
+
+		size_t level = evaluation->renaming_size >> 1;
+
+		abstraction->abstraction.body = node_instantiate(evaluation, node->abstraction.body, binder, argument, reach);
+
+		evaluation->renamed = renamed;
+		evaluation->renaming_size -= 2;
+
+		*reach = abstraction_close(abstraction, level, *reach);
+
+		return abstraction;
+
+	case NODE_APPLICATION:
+		size_t function_reach, argument_reach;
+
+		struct Node *function = node_instantiate(evaluation, node->application.function, binder, argument, &function_reach);
+		struct Node *application_argument = node_instantiate(evaluation, node->application.argument, binder, argument, &argument_reach);
+
+		struct Node *application = node_create(evaluation, NODE_APPLICATION);
+
+		application->application.function = function;
+		application->application.argument = application_argument;
+
+		*reach = application_close(application, function_reach, argument_reach);
+
+		return application;
+
+	default:
+		// Free variables, numerals, definitions and fixpoints are closed, hence shared
+
+		*reach = SIZE_MAX;
+
+		return node;
+	}
+}
+
+struct Node *reference_unfold(struct Evaluation *evaluation, struct Node *node)
+{
+	struct Linkage *linkage = node->reference;
+
+	// A definition is compiled once per evaluation, then every occurrence forwards to the same graph
+
+	if (linkage->unfolded == NULL) {
+		// The caller is the definition owning the application the reference was found in
+
+		if (evaluation->stack_size != 0) {
+			linkage->caller = evaluation->stack[evaluation->stack_size - 1]->origin;
+		}
+
+		evaluation->origin = linkage;
+
+		size_t reach;
+
+		struct Node *unfolded = term_compile(evaluation, linkage->definition.term, linkage, &reach);
+
+		evaluation->stats.delta_steps++;
+
+		// A definition which is its own value, like X = X, would forward to itself
+
+		if (node_dereference(unfolded) == node) {
+			evaluation->stats.status = EVALUATION_LOOP;
+			evaluation->stats.loop_period = 0;
+
+			return node;
+		}
+
+		linkage->unfolded = unfolded;
+	}
+
+	return spine_dereference(linkage->unfolded);
+}
+
+struct Node *church_numeral_expand(struct Evaluation *evaluation, struct Node *node)
+{
+	// Builds λf.λx.f (f ... (f x)) out of a Church numeral reaching the head position
+
+	static const struct Identifier function_name = {"f", -1};
+	static const struct Identifier argument_name = {"x", -1};
+
+	evaluation->origin = node->origin;
+
+	struct Node *function_binder = node_create(evaluation, NODE_ABSTRACTION);
+	struct Node *argument_binder = node_create(evaluation, NODE_ABSTRACTION);
+
+	function_binder->abstraction.bound_variable = &function_name;
+	function_binder->abstraction.body = argument_binder;
+
+	argument_binder->abstraction.bound_variable = &argument_name;
+
+	struct Node *function = node_create(evaluation, NODE_VARIABLE);
+	struct Node *body = node_create(evaluation, NODE_VARIABLE);
+
+	function->binder = function_binder;
+	function->binders = binder_bit(function_binder);
+
+	body->binder = argument_binder;
+	body->binders = binder_bit(argument_binder);
+
+	for (int i = 0; i < node->church_numeral; i++) {
+		struct Node *application = node_create(evaluation, NODE_APPLICATION);
+
+		application->application.function = function;
+		application->application.argument = body;
+
+		application_close(application, 0, 0);
+
+		body = application;
+	}
+
+	argument_binder->abstraction.body = body;
+
+	abstraction_close(argument_binder, 2, 1);
+	abstraction_close(function_binder, 1, 1);
+
+	argument_binder->flags |= NODE_LINEAR;
+	function_binder->flags |= node->church_numeral == 0 ? NODE_UNUSED : node->church_numeral == 1 ? NODE_LINEAR : 0;
+
+	return function_binder;
+}
+
+struct Node *fixpoint_tie(struct Evaluation *evaluation, struct Node *combinator)
+{
+	// Contracts the combinator with the topmost application of the spine into a fixpoint node, counted as a beta step
+	// Returns NULL when the argument isn't closed: the fixpoint would then hold variables that instantiation has to
+	// replace, so it couldn't be shared
+
+	struct Node *application = evaluation->stack[evaluation->stack_size - 1];
+	struct Node *function = node_forward(application->application.argument);
+
+	if (!(function->flags & NODE_CLOSED)) {
+		return NULL;
+	}
+
+	evaluation->stack_size--;
+
+	application->flags &= ~NODE_VISITING;
+
+	evaluation->origin = combinator->origin;
+
+	struct Node *node = node_create(evaluation, NODE_FIXPOINT);
+
+	node->flags |= NODE_CLOSED | (combinator->flags & NODE_ETA);
+	node->fixpoint = arena_alloc(&evaluation->arena, sizeof(*node->fixpoint));
+
+	node->fixpoint->combinator = application->application.function;
+	node->fixpoint->function = function;
+	node->fixpoint->unfolded = NULL;
+
+	node_redirect(evaluation, application, node);
+
+	evaluation->stats.beta_steps++;
+
+	if (evaluation->profiling) {
+		combinator->origin->beta_steps++;
+	}
+
+	return node;
+}
+
+struct Node *fixpoint_unfold(struct Evaluation *evaluation, struct Node *node, size_t base)
+{
+	// Y f and Θ f unfold to f (Y f), Z f to f (λv.Z f v), the fixpoint node itself standing for Y f and Z f
+	// Applied, the fixpoint unfolds afresh into the application of the spine holding it: reusing a value reduced in
+	// place, normalized parts included, would make every unrolling copy the previous ones. Otherwise the unfolding
+	// becomes the value of the fixpoint.
+
+	static const struct Identifier variable_name = {"v", -1};
+
+	struct Fixpoint *fixpoint = node->fixpoint;
+
+	if (evaluation->stack_size == base && fixpoint->unfolded != NULL) {
+		return spine_dereference(fixpoint->unfolded);
+	}
+
+	struct Node *argument = node;
+
+	evaluation->origin = node->origin;
+
+	if (node->flags & NODE_ETA) {
+		struct Node *abstraction = node_create(evaluation, NODE_ABSTRACTION);
+		struct Node *variable = node_create(evaluation, NODE_VARIABLE);
+		struct Node *application = node_create(evaluation, NODE_APPLICATION);
+
+		variable->binder = abstraction;
+		variable->binders = binder_bit(abstraction);
+
+		application->application.function = node;
+		application->application.argument = variable;
+
+		application_close(application, SIZE_MAX, 1);
+
+		abstraction->abstraction.bound_variable = &variable_name;
+		abstraction->abstraction.body = application;
+
+		abstraction_close(abstraction, 1, 1);
+
+		abstraction->flags |= NODE_LINEAR;
+
+		argument = abstraction;
+	}
+
+	struct Node *unfolded = node_create(evaluation, NODE_APPLICATION);
+
+	unfolded->application.function = fixpoint->function;
+	unfolded->application.argument = argument;
+
+	application_close(unfolded, SIZE_MAX, SIZE_MAX);
+
+	if (evaluation->stack_size == base) {
+		fixpoint->unfolded = unfolded;
+
+		node_remember(evaluation, node, unfolded);
+	} else {
+		evaluation->stack[evaluation->stack_size - 1]->application.function = unfolded;
+
+		node_remember(evaluation, evaluation->stack[evaluation->stack_size - 1], unfolded);
+	}
+
+	return unfolded;
+}
+
+unsigned int fixpoint_shape(const struct Node *node)
+{
+	// Flags of a freshly compiled node being Y = λf.(λx.f (x x)) λx.f (x x), Z = λf.(λx.f (λv.x x v)) λx.f (λv.x x v)
+	// or Θ = (λx.λy.y (x x y)) λx.λy.y (x x y), up to alpha equivalence
+
+	if (node->type == NODE_APPLICATION) {
+		return turing_half_is(node->application.function) && turing_half_is(node->application.argument) ? NODE_COMBINATOR : 0;
+	}
+
+	if (node->type != NODE_ABSTRACTION || node->abstraction.body->type != NODE_APPLICATION) {
+		return 0;
+	}
+
+	const struct Node *body = node->abstraction.body;
+
+	unsigned int function = fixpoint_half(body->application.function, node);
+	unsigned int argument = fixpoint_half(body->application.argument, node);
+
+	return function == argument ? function : 0;
+}
+
+unsigned int fixpoint_half(const struct Node *half, const struct Node *function)
+{
+	// λx.f (x x) for Y and λx.f (λv.x x v) for Z
+
+	if (half->type != NODE_ABSTRACTION) {
+		return 0;
+	}
+
+	const struct Node *body = half->abstraction.body;
+
+	if (body->type != NODE_APPLICATION || !variable_is(body->application.function, function)) {
+		return 0;
+	}
+
+	const struct Node *argument = body->application.argument;
+
+	if (self_application_is(argument, half)) {
+		return NODE_COMBINATOR;
+	}
+
+	if (argument->type != NODE_ABSTRACTION) {
+		return 0;
+	}
+
+	const struct Node *expansion = argument->abstraction.body;
+
+	if (expansion->type == NODE_APPLICATION && self_application_is(expansion->application.function, half) &&
+		variable_is(expansion->application.argument, argument)) {
+		return NODE_COMBINATOR | NODE_ETA;
+	}
+
+	return 0;
+}
+
+int turing_half_is(const struct Node *half)
+{
+	// λx.λy.y (x x y)
+
+	if (half->type != NODE_ABSTRACTION || half->abstraction.body->type != NODE_ABSTRACTION) {
+		return 0;
+	}
+
+	const struct Node *inner = half->abstraction.body;
+	const struct Node *body = inner->abstraction.body;
+
+	if (body->type != NODE_APPLICATION || !variable_is(body->application.function, inner)) {
+		return 0;
+	}
+
+	const struct Node *argument = body->application.argument;
+
+	return argument->type == NODE_APPLICATION && self_application_is(argument->application.function, half) &&
+		variable_is(argument->application.argument, inner);
+}
+
+int self_application_is(const struct Node *node, const struct Node *binder)
+{
+	return node->type == NODE_APPLICATION && variable_is(node->application.function, binder) &&
+		variable_is(node->application.argument, binder);
+}
+
+int variable_is(const struct Node *node, const struct Node *binder)
+{
+	return node->type == NODE_VARIABLE && node->binder == binder;
+}
+
+struct Node *node_optimize(struct Evaluation *evaluation, struct Node *node, size_t arguments)
+{
+	// Rewrites node bottom up and returns what stands for it, arguments being the number of arguments it is applied to
+	// Contracta are optimized again, since substitution makes new redexes out of the copied nodes
+	// Rewritten nodes are marked as normalized so that shared ones are only visited once
+
+	node = node_forward(node);
+
+	if (evaluation->stats.status != EVALUATION_PENDING || (node->flags & NODE_NORMALIZED)) {
+		return node;
+	}
+
+	size_t reach;
+
+	switch (node->type) {
+	case NODE_REFERENCE:
+		// Inlined only where applied, anywhere else the shared reference costs less than a copy
+
+		if (arguments == 0 || !linkage_inlinable(node->reference)) {
+			return node;
+		}
+
+		evaluation->origin = node->reference;
+
+		struct Node *definition = term_compile(evaluation, node->reference->definition.term, node->reference, &reach);
+
+		// Fixpoint combinators keep their name, which is what gets them recognized once applied
+
+		if (definition->flags & NODE_COMBINATOR) {
+			node->reference->inlining = -1;
+
+			return node;
+		}
+
+		evaluation->stats.delta_steps++;
+
+		return node_optimize(evaluation, definition, arguments);
+
+	case NODE_CHURCH_NUMERAL:
+		// Arithmetic on constants then folds back into a numeral
+
+		if (arguments == 0 || node->church_numeral > NUMERAL_INLINE_LIMIT) {
+			return node;
+		}
+
+		return node_optimize(evaluation, church_numeral_expand(evaluation, node), arguments);
+
+	case NODE_ABSTRACTION:
+		node->flags |= NODE_NORMALIZED;
+
+		node->abstraction.body = node_optimize(evaluation, abstraction_open(node), 0);
+
+		return abstraction_eta_reduce(evaluation, node);
+
+	case NODE_APPLICATION:
+		node->flags |= NODE_NORMALIZED;
+
+		node->application.function = node_optimize(evaluation, node->application.function, arguments + 1);
+		node->application.argument = node_optimize(evaluation, node->application.argument, 0);
+
+		struct Node *head = node_forward(node->application.function);
+		struct Node *argument = node_forward(node->application.argument);
+
+		if (head->type != NODE_ABSTRACTION || (head->flags & NODE_COMBINATOR)) {
+			return node;
+		}
+
+		// The abstractions at the top of the body are applied right away by the enclosing arguments, so only the
+		// ones below can run a substituted argument several times
+
+		int guarded = 0;
+
+		size_t uses = binder_uses(head->abstraction.body, head, arguments, 0, &guarded);
+
+		if (!atom_is(argument) && (uses > 1 || (uses == 1 && guarded && argument->type != NODE_ABSTRACTION))) {
+			return node;
+		}
+
+		if (!step_admit(evaluation)) {
+			return node;
+		}
+
+		struct Node *result = redex_contract(evaluation, head, argument);
+
+		evaluation->stats.beta_steps++;
+
+		node_redirect(evaluation, node, result);
+
+		return node_optimize(evaluation, result, arguments);
+
+	default:
+		return node;
+	}
+}
+
+struct Node *abstraction_eta_reduce(struct Evaluation *evaluation, struct Node *node)
+{
+	// λx.M x becomes M when M is an abstraction or a definition written as one, which is also what a beta step gives
+
+	struct Node *body = node_forward(node->abstraction.body);
+
+	if (body->type != NODE_APPLICATION || !variable_is(node_forward(body->application.argument), node)) {
+		return node;
+	}
+
+	struct Node *function = node_forward(body->application.function);
+
+	int abstraction = function->type == NODE_ABSTRACTION ||
+		(function->type == NODE_REFERENCE && function->reference->definition.term->type == ABSTRACTION);
+
+	int guarded = 0;
+
+	if (!abstraction || binder_uses(function, node, 0, 0, &guarded) != 0 || !step_admit(evaluation)) {
+		return node;
+	}
+
+	evaluation->stats.beta_steps++;
+
+	node_redirect(evaluation, node, function);
+
+	return function;
+}
+
+size_t binder_uses(const struct Node *node, const struct Node *binder, size_t leading, int under, int *guarded)
+{
+	// Counts the variables of binder in node, up to 2
+	// The first leading abstractions on top of node are looked through, and guarded is set for any variable found
+	// below another abstraction
+
+	node = node_forward((struct Node *)node);
+
+	if ((node->binders & binder_bit(binder)) == 0) {
+		return 0;
+	}
+
+	switch (node->type) {
+	case NODE_VARIABLE:
+		if (node->binder != binder) {
+			return 0;
+		}
+
+		*guarded |= under;
+
+		return 1;
+
+	case NODE_ABSTRACTION:
+		if (leading > 0) {
+			return binder_uses(node->abstraction.body, binder, leading - 1, under, guarded);
+		}
+
+		return binder_uses(node->abstraction.body, binder, 0, 1, guarded);
+
+	case NODE_APPLICATION:
+		size_t uses = binder_uses(node->application.function, binder, 0, under, guarded);
+
+		if (uses < 2) {
+			uses += binder_uses(node->application.argument, binder, 0, under, guarded);
+		}
+
+		return uses < 2 ? uses : 2;
+
+	default:
+		return 0;
+	}
+}
+
+int atom_is(const struct Node *node)
+{
+	// Atoms are substituted any number of times, since copying them neither duplicates work nor grows the term much
+
+	switch (node->type) {
+	case NODE_VARIABLE:
+	case NODE_FREE_VARIABLE:
+	case NODE_REFERENCE:
+	case NODE_CHURCH_NUMERAL:
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+
+int linkage_inlinable(struct Linkage *linkage)
+{
+	// Decided once per evaluation: small definitions which can't reach themselves are inlined
+
+	if (linkage->inlining == 0) {
+		size_t budget = INLINE_SIZE_LIMIT;
+
+		int inlinable = term_fits(linkage->definition.term, &budget) && !linkage_reaches(linkage, linkage);
+
+		linkage->inlining = inlinable ? 1 : -1;
+	}
+
+	return linkage->inlining > 0;
+}
+
+int linkage_reaches(struct Linkage *linkage, const struct Linkage *target)
+{
+	// Depth first search over the definitions used, each one visited once per target
+
+	for (size_t i = 0; i < linkage->definition.free_variables_size; i++) {
+		struct Linkage *used = linkage->targets[i];
+
+		if (used == NULL || used->searched == target) {
+			continue;
+		}
+
+		if (used == target) {
+			return 1;
+		}
+
+		used->searched = target;
+
+		if (linkage_reaches(used, target)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int term_fits(const struct LambdaTerm *term, size_t *budget)
+{
+	if (*budget == 0) {
+		return 0;
+	}
+
+	(*budget)--;
+
+	switch (term->type) {
+	case ABSTRACTION:
+		return term_fits(term->expression.abstraction.body, budget);
+
+	case APPLICATION:
+		return term_fits(term->expression.application.function, budget) && term_fits(term->expression.application.argument, budget);
+
+	default:
+		return 1;
+	}
+}
+
+struct Node *term_compile(struct Evaluation *evaluation, const struct LambdaTerm *term, struct Linkage *linkage, size_t *reach)
+{
+	// Recursive compilation of a parsed term, with the enclosing abstractions kept on the renaming stack
+	// Bound variables are resolved against the name string their abstraction owns
+	// reach is the level of the outermost enclosing abstraction the term refers to, SIZE_MAX if none
+
+	struct Node *node;
+
+	*reach = SIZE_MAX;
+
+	switch (term->type) {
+	case CHURCH_NUMERAL:
+		node = node_create(evaluation, NODE_CHURCH_NUMERAL);
+		node->church_numeral = term->expression.church_numeral;
+		node->flags |= NODE_CLOSED;
+
+		return node;
+
+	case BOUND_VARIABLE:
+		for (size_t i = evaluation->renaming_size; i > 0; i -= 2) {
+			struct Node *binder = evaluation->renaming[i - 1];
+
+			if (identifier_equal(binder->abstraction.bound_variable, &term->expression.variable)) {
+				// Unused, then linear, then shared as its variables are met
+
+				if (binder->flags & NODE_UNUSED) {
+					binder->flags ^= NODE_UNUSED | NODE_LINEAR;
+				} else {
+					binder->flags &= ~NODE_LINEAR;
+				}
+
+				node = node_create(evaluation, NODE_VARIABLE);
+				node->binder = binder;
+				node->binders = binder_bit(binder);
+
+				*reach = i >> 1;
+
+				return node;
+			}
+		}
+
+		// Unreachable for terms built by lambda_parse()
+
+		node = node_create(evaluation, NODE_FREE_VARIABLE);
+		node->free_variable = &term->expression.variable;
+		node->flags |= NODE_CLOSED;
+
+		return node;
+
+	case FREE_VARIABLE:
+		const struct Identifier *free_variable;
+
+		struct Linkage *target = linkage_target(linkage, &term->expression.variable, &free_variable);
+
+		if (target == NULL) {
+			node = node_create(evaluation, NODE_FREE_VARIABLE);
+			node->free_variable = free_variable;
+			node->flags |= NODE_CLOSED;
+
+			return node;
+		}
+
+		// Every occurrence of a definition shares a single reference node
+
+		if (target->reference == NULL) {
+			target->reference = node_create(evaluation, NODE_REFERENCE);
+			target->reference->reference = target;
+			target->reference->flags |= NODE_CLOSED;
+		}
+
+		return target->reference;
+
+	case ABSTRACTION:
+		node = node_create(evaluation, NODE_ABSTRACTION);
+		node->abstraction.bound_variable = &term->expression.abstraction.bound_variable;
+		node->flags |= NODE_UNUSED;
+
+		// The renaming stack is reused as a scope, pairing the source term with its node
+
+		renaming_push(evaluation, NULL, node);
+
+		size_t level = evaluation->renaming_size >> 1;
+
+		node->abstraction.body = term_compile(evaluation, term->expression.abstraction.body, linkage, reach);
+
+		evaluation->renaming_size -= 2;
+
+		*reach = abstraction_close(node, level, *reach);
+
+		node->flags |= fixpoint_shape(node);
+
+		return node;
+
+	case APPLICATION:
+		size_t function_reach, argument_reach;
+
+		struct Node *function = term_compile(evaluation, term->expression.application.function, linkage, &function_reach);
+		struct Node *argument = term_compile(evaluation, term->expression.application.argument, linkage, &argument_reach);
+
+		node = node_create(evaluation, NODE_APPLICATION);
+		node->application.function = function;
+		node->application.argument = argument;
+
+		*reach = application_close(node, function_reach, argument_reach);
+
+		node->flags |= fixpoint_shape(node);
+
+		return node;
+
+	default:
+		// Incomplete abstractions never survive lambda_parse()
+
+		return NULL;
+	}
+}
+
+struct Node *node_create(struct Evaluation *evaluation, enum NodeType type)
+{
+	struct Node *node;
+
+	if (evaluation->generational && NURSERY_SIZE - evaluation->nursery_size >= sizeof(*node)) {
+		if (evaluation->nursery == NULL) {
+			evaluation->nursery = malloc(NURSERY_SIZE);
+
+			if (evaluation->nursery == NULL) {
+				goto fatal_error;
+			}
+		}
+
+		node = (struct Node *)(evaluation->nursery + evaluation->nursery_size);
+		node->flags = NODE_NURSERY;
+
+		evaluation->nursery_size += sizeof(*node);
+	} else {
+		node = arena_alloc(&evaluation->arena, sizeof(*node));
+		node->flags = 0;
+
+		// Allocated while the nursery is full, the node may point into it once it is filled in
+
+		if (evaluation->generational) {
+			node_remember(evaluation, node, NULL);
+		}
+	}
+
+	node->type = type;
+	node->origin = evaluation->origin;
+	node->binders = 0;
+
+	if (type == NODE_ABSTRACTION) {
+		node->abstraction.stamp = evaluation->stats.nodes;
+	}
+
+	evaluation->stats.nodes++;
+
+	if (evaluation->profiling) {
+		evaluation->origin->allocations++;
+	}
+
+	return node;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function node_create().\n");
+	exit(1);
+}
+
+size_t abstraction_close(struct Node *node, size_t level, size_t reach)
+{
+	// Sets the metadata of an abstraction at level out of the reach of its body, returning its own reach
+
+	node->binders = node->abstraction.body->binders | binder_bit(node);
+
+	if (reach < level) {
+		return reach;
+	}
+
+	node->flags |= NODE_CLOSED;
+
+	return SIZE_MAX;
+}
+
+size_t application_close(struct Node *node, size_t function_reach, size_t argument_reach)
+{
+	node->binders = node->application.function->binders | node->application.argument->binders;
+
+	if (function_reach == SIZE_MAX && argument_reach == SIZE_MAX) {
+		node->flags |= NODE_CLOSED;
+	}
+
+	return function_reach < argument_reach ? function_reach : argument_reach;
+}
+
+uint64_t binder_bit(const struct Node *binder)
+{
+	// Stamps are consecutive, so they are mixed by the splitmix64 finalizer before the top bits pick one of the 64:
+	// Fibonacci hashing alone puts binders a Fibonacci number apart into the same bit
+
+	uint64_t hash = (uint64_t)binder->abstraction.stamp;
+
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9u;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebu;
+	hash ^= hash >> 31;
+
+	return (uint64_t)1 << (hash >> 58);
+}
+
+struct Node *node_dereference(struct Node *node)
+{
+	// Unfolded references and fixpoints are followed but never bypassed, so every cycle through a recursive definition
+	// keeps its name and every cycle through a fixpoint keeps a node to be cut at
+
+	while (1) {
+		node = spine_dereference(node);
+
+		if (node->type == NODE_FIXPOINT && node->fixpoint->unfolded != NULL) {
+			node = node->fixpoint->unfolded;
+
+			continue;
+		}
+
+		return node;
+	}
+}
+
+struct Node *spine_dereference(struct Node *node)
+{
+	// Stops at fixpoints, which unfold afresh in the head position
+
+	while (1) {
+		node = node_forward(node);
+
+		if (node->type == NODE_REFERENCE && node->reference->unfolded != NULL) {
+			node = node->reference->unfolded;
+
+			continue;
+		}
+
+		return node;
+	}
+}
+
+struct Node *abstraction_open(struct Node *node)
+{
+	node->flags &= ~NODE_LINEAR;
+
+	return node->abstraction.body;
+}
+
+struct Node *node_forward(struct Node *node)
+{
+	// Follows indirections, halving the path on the way
+	// An arena node forwarding to another one is left as it is when that would make it point into the nursery, since
+	// only the other one is remembered
+
+	while (node->type == NODE_INDIRECTION) {
+		struct Node *target = node->indirection;
+
+		if (target->type == NODE_INDIRECTION &&
+			(((node->flags | target->flags) & NODE_NURSERY) || !(target->indirection->flags & NODE_NURSERY))) {
+			node->indirection = target->indirection;
+		}
+
+		node = target;
+	}
+
+	return node;
+}
+
+int nursery_full(const struct Evaluation *evaluation)
+{
+	// Nodes allocated in the arena since the last collection are remembered, hence counted as well
+	// Every collection scans the whole stack and every linkage, so it waits for allocation to outweigh them
+
+	size_t allocated = evaluation->nursery_size + sizeof(struct Node) * evaluation->remembered_size;
+
+	return allocated >= NURSERY_COLLECTION && allocated >= sizeof(struct Node) * (evaluation->stack_size + evaluation->linker.capacity);
+}
+
+void nursery_collect(struct Evaluation *evaluation, struct Node **head, struct Node **node)
+{
+	// Copies the nodes of the nursery reachable from the roots and the head of the reduction to the arena, then
+	// empties it
+	// Copies are appended to the remembered nodes, which then serve as the queue of nodes left to scan
+
+	size_t remembered = evaluation->remembered_size;
+
+	node_evacuate(evaluation, head);
+	node_evacuate(evaluation, node);
+	node_evacuate(evaluation, &evaluation->root);
+	node_evacuate(evaluation, &evaluation->loop.owner);
+
+	for (size_t i = 0; i < evaluation->stack_size; i++) {
+		node_evacuate(evaluation, &evaluation->stack[i]);
+	}
+
+	for (size_t i = 0; i < evaluation->linker.capacity; i++) {
+		struct Linkage *linkage = evaluation->linker.linkages[i];
+
+		if (linkage != NULL) {
+			node_evacuate(evaluation, &linkage->reference);
+			node_evacuate(evaluation, &linkage->unfolded);
+		}
+	}
+
+	if (evaluation->roots != NULL) {
+		evaluation->roots(evaluation, evaluation->roots_context);
+	}
+
+	for (size_t i = 0; i < evaluation->remembered_size; i++) {
+		node_scan(evaluation, evaluation->remembered[i]);
+	}
+
+	evaluation->stats.collections++;
+	evaluation->stats.collected += evaluation->nursery_size / sizeof(struct Node);
+	evaluation->stats.survivors += evaluation->remembered_size - remembered;
+
+	evaluation->nursery_size = 0;
+	evaluation->remembered_size = 0;
+}
+
+void evaluation_evacuate(struct Evaluation *evaluation, struct Node **slot)
+{
+	node_evacuate(evaluation, slot);
+}
+
+void node_evacuate(struct Evaluation *evaluation, struct Node **slot)
+{
+	// Points slot to the copy of a nursery node, copying it first if it hasn't been yet
+
+	struct Node *node = *slot;
+
+	while (node != NULL && (node->flags & NODE_NURSERY)) {
+		if (node->flags & NODE_EVACUATED) {
+			*slot = node->indirection;
+			return;
+		}
+
+		if (node->type != NODE_INDIRECTION) {
+			break;
+		}
+
+		node = node->indirection;
+	}
+
+	if (node == NULL || !(node->flags & NODE_NURSERY)) {
+		*slot = node;
+		return;
+	}
+
+	struct Node *copy = arena_alloc(&evaluation->arena, sizeof(*copy));
+
+	*copy = *node;
+	copy->flags &= ~NODE_NURSERY;
+
+	node->flags |= NODE_EVACUATED;
+	node->indirection = copy;
+
+	node_remember(evaluation, copy, NULL);
+
+	*slot = copy;
+}
+
+void node_scan(struct Evaluation *evaluation, struct Node *node)
+{
+	switch (node->type) {
+	case NODE_VARIABLE:
+		node_evacuate(evaluation, &node->binder);
+		break;
+
+	case NODE_ABSTRACTION:
+		node_evacuate(evaluation, &node->abstraction.body);
+		break;
+
+	case NODE_APPLICATION:
+		node_evacuate(evaluation, &node->application.function);
+		node_evacuate(evaluation, &node->application.argument);
+		break;
+
+	case NODE_INDIRECTION:
+		node_evacuate(evaluation, &node->indirection);
+		break;
+
+	case NODE_FIXPOINT:
+		node_evacuate(evaluation, &node->fixpoint->combinator);
+		node_evacuate(evaluation, &node->fixpoint->function);
+		node_evacuate(evaluation, &node->fixpoint->unfolded);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void node_redirect(struct Evaluation *evaluation, struct Node *node, struct Node *result)
+{
+	node->type = NODE_INDIRECTION;
+	node->indirection = result;
+
+	node_remember(evaluation, node, result);
+}
+
+void node_remember(struct Evaluation *evaluation, struct Node *node, const struct Node *target)
+{
+	// Records an arena node which now points to target, unless target is known to be outside of the nursery
+
+	if ((node->flags & NODE_NURSERY) || (target != NULL && !(target->flags & NODE_NURSERY))) {
+		return;
+	}
+
+	if (evaluation->remembered_size == evaluation->remembered_capacity) {
+		// Scaling factor of 2
+
+		evaluation->remembered_capacity = evaluation->remembered_capacity == 0 ? INITIAL_CAPACITY : evaluation->remembered_capacity << 1;
+		evaluation->remembered = realloc(evaluation->remembered, sizeof(*evaluation->remembered) * evaluation->remembered_capacity);
+
+		if (evaluation->remembered == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	evaluation->remembered[evaluation->remembered_size++] = node;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function node_remember().\n");
+	exit(1);
+}
+
+void stack_push(struct Evaluation *evaluation, struct Node *node)
+{
+	if (evaluation->stack_size == evaluation->stack_capacity) {
+		// Scaling factor of 2
+
+		evaluation->stack_capacity = evaluation->stack_capacity == 0 ? INITIAL_CAPACITY : evaluation->stack_capacity << 1;
+		evaluation->stack = realloc(evaluation->stack, sizeof(*evaluation->stack) * evaluation->stack_capacity);
+
+		if (evaluation->stack == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	evaluation->stack[evaluation->stack_size++] = node;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function stack_push().\n");
+	exit(1);
+}
+
+void renaming_push(struct Evaluation *evaluation, struct Node *from, struct Node *to)
+{
+	if (evaluation->renaming_capacity - evaluation->renaming_size < 2) {
+		// Scaling factor of 2
+
+		evaluation->renaming_capacity = evaluation->renaming_capacity == 0 ? INITIAL_CAPACITY : evaluation->renaming_capacity << 1;
+		evaluation->renaming = realloc(evaluation->renaming, sizeof(*evaluation->renaming) * evaluation->renaming_capacity);
+
+		if (evaluation->renaming == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	evaluation->renaming[evaluation->renaming_size++] = from;
+	evaluation->renaming[evaluation->renaming_size++] = to;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function renaming_push().\n");
+	exit(1);
+}
+
+int identifier_equal(const struct Identifier *left, const struct Identifier *right)
+{
+	// Variable terms share the name string they refer to, so the string comparison is only a fallback
+
+	if (left->subscript != right->subscript) {
+		return 0;
+	}
+
+	return left->name == right->name || strcmp(left->name, right->name) == 0;
+}
\ No newline at end of file
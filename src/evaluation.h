@@ -0,0 +1,300 @@
+#pragma once
+
+#include <arena.h>
+#include <hashmap.h>
+#include <lambda.h>
+#include <linking.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Graph reduction evaluator
+// A lambda term is compiled into a graph in which every variable points straight to its binder, so arguments are shared
+// between all of their occurrences without any renaming or shifting.
+// Redexes are overwritten in place by an indirection to their contractum, hence a shared subterm is reduced at most once.
+// All nodes of an evaluation live in a single arena and are released together, unless they die young in the nursery.
+
+enum NodeType {
+	NODE_VARIABLE,		// Bound variable occurrence, pointing to its abstraction node
+	NODE_ABSTRACTION,
+	NODE_APPLICATION,
+	NODE_FREE_VARIABLE,	// Free variable which doesn't name any definition
+	NODE_REFERENCE,		// Linked definition, unfolded only once it reaches the head position and forwarding to it afterwards
+	NODE_CHURCH_NUMERAL,
+	NODE_INDIRECTION,	// A reduced node, forwarding to its result
+	NODE_FIXPOINT		// Fixpoint combinator applied to a closed function
+};
+
+enum NodeFlags {
+	NODE_NORMALIZED = 1,	// The node has been reduced to weak head normal form and its subterms have been scheduled for normalization
+	NODE_VISITING = 2,	// The node lies on the path of an ongoing traversal, used to cut cycles
+	NODE_CLOSED = 4,	// No variable of the node is bound outside of it, so instantiation always shares it
+	NODE_COMBINATOR = 8,	// The node is Y, Z or Θ up to alpha equivalence, set at compilation
+	NODE_ETA = 16,		// The combinator or fixpoint is Z, which passes itself eta expanded
+	NODE_UNUSED = 32,	// The abstraction never uses its variable
+	NODE_LINEAR = 64,	// The abstraction uses its variable once, cleared once its body gets reduced in place
+	NODE_NURSERY = 128,	// The node lives in the nursery
+	NODE_EVACUATED = 256	// The nursery node has been copied to the arena during a collection, its indirection being the copy
+};
+
+// Usage of binders
+// Every abstraction is annotated at compilation as unused, linear or, without either flag, shared. Reduction only ever
+// erases or duplicates variables, so an unused binder stays unused, while a linear one may stop being linear once its
+// body is reduced: whatever descends into the body of an abstraction to reduce it clears NODE_LINEAR first.
+// Beta steps on unused binders take the body as it is and drop the argument without evaluating it, and instantiation
+// stops looking for the variable of a linear binder once it has replaced it, copying nothing else but renamed binders.
+
+// Cyclic fixpoints
+// A fixpoint combinator applied to a closed function f is contracted into a single node standing for Y f. Applied to
+// arguments, the node unfolds to f applied to the node itself, so unrolling the recursion costs one node and the beta
+// reduction of f instead of copying the combinator. Every unrolling starts over from f, which is never reduced in place.
+// The value of the fixpoint itself is only computed when it is evaluated without arguments, and kept in the node.
+
+struct Fixpoint {
+	struct Node *combinator;	// Combinator as applied, read back where the cycle is cut
+	struct Node *function;
+	struct Node *unfolded;		// The function applied to the fixpoint once evaluated without arguments, NULL until then
+};
+
+struct Node {
+	enum NodeType type;
+	unsigned int flags;
+
+	struct Linkage *origin;		// Definition the node was compiled or instantiated from
+
+	// Bloom filter of the binders of every variable in the node, set at construction
+	// Reduction never adds free variables, so it stays a superset of the binders of the free variables as the graph changes
+
+	uint64_t binders;
+
+	union {
+		int church_numeral;
+
+		struct Node *binder;
+
+		const struct Identifier *free_variable;
+
+		struct Linkage *reference;
+
+		struct Node *indirection;
+
+		struct Fixpoint *fixpoint;
+
+		struct NodeAbstraction {
+			const struct Identifier *bound_variable;	// Name hint for readback, owned by the source term
+			struct Node *body;
+			size_t stamp;					// Allocation number, standing for the binder in hashes since nodes move
+		} abstraction;
+
+		struct NodeApplication {
+			struct Node *function;
+			struct Node *argument;
+		} application;
+	};
+};
+
+// Evaluation strategies, from the least to the most work
+// EVALUATION_CBV reaches the full normal form as well, but in applicative order: arguments are normalized before being
+// substituted, which avoids repeating work in some terms and diverges on terms that discard divergent arguments
+
+enum EvaluationMode {
+	EVALUATION_WHNF,	// Weak head normal form: stops at the first abstraction or stuck application
+	EVALUATION_HNF,		// Head normal form: also reduces the head below abstractions, arguments are left untouched
+	EVALUATION_NF,		// Full normal form in normal order
+	EVALUATION_CBV		// Full normal form in applicative order
+};
+
+enum EvaluationStatus {
+	EVALUATION_PENDING,
+	EVALUATION_NORMAL_FORM,		// The requested normal form has been reached
+	EVALUATION_STEP_LIMIT,		// The step limit, or the node limit, was hit
+	EVALUATION_DEPTH_LIMIT,		// Applicative order nested too many argument evaluations
+	EVALUATION_CANCELLED,		// Aborted through evaluation_control
+	EVALUATION_LOOP			// The reduction came back to a state it already went through, so it never ends
+};
+
+struct EvaluationStats {
+	enum EvaluationStatus status;
+
+	size_t beta_steps;	// Beta reductions performed
+	size_t delta_steps;	// Definitions unfolded
+	size_t nodes;		// Graph nodes allocated
+
+	int truncated;		// The readback elided the subterms past READBACK_NODE_LIMIT
+
+	size_t loop_period;	// Beta steps between two occurrences of the repeated state for EVALUATION_LOOP, 0 when
+				// the term needs its own value to reduce
+
+	size_t collections;	// Nursery collections
+	size_t collected;	// Nodes allocated in the nursery before a collection
+	size_t survivors;	// Nodes a collection copied out of the nursery
+};
+
+// Control shared by every evaluation of the process, so that another thread or a signal handler can follow and abort
+// the running one. Both backends poll it every EVALUATION_POLL_INTERVAL steps, which keeps the cost off the reduction loop.
+
+struct EvaluationControl {
+	atomic_int cancel;		// Set to abort running evaluations at their next poll
+	atomic_size_t beta_steps;	// Progress of the latest polling evaluation
+	atomic_size_t nodes;
+};
+
+extern struct EvaluationControl evaluation_control;
+
+// Reduction loop detection
+// The state under weak head reduction is fingerprinted up to alpha equivalence at checkpoints, LOOP_CHECKPOINTS at each
+// spacing before the spacing doubles, so the number of fingerprints only grows with the logarithm of the steps taken.
+// Reduction is deterministic, hence a fingerprint seen again means a loop. Its shortest period is then found by
+// fingerprinting every step until the state comes back, when that costs little enough.
+
+#define LOOP_CHECKPOINTS 16
+#define LOOP_FINGERPRINT_BUDGET 4096		// Nodes of the largest state fingerprinted
+#define LOOP_SEARCH_BUDGET ((size_t)1 << 22)	// Nodes fingerprinted at most while looking for the shortest period
+
+struct LoopCheck {
+	struct Node *owner;		// Node under weak head reduction the checkpoints belong to
+
+	uint64_t fingerprints[LOOP_CHECKPOINTS];
+	size_t steps[LOOP_CHECKPOINTS];
+	size_t size;
+
+	size_t spacing;			// Beta steps between two checkpoints
+	size_t taken;			// Checkpoints taken at this spacing
+	size_t next;			// Beta steps of the next checkpoint
+
+	int searching;			// Fingerprinting every step until target comes back
+	uint64_t target;
+	size_t found;			// Beta steps when target was seen again
+	size_t repetition;		// Beta steps between the two checkpoints sharing target
+};
+
+// Generational allocation
+// Most nodes die within a few steps, once the redex they were copied for has been reduced. With a nursery, new nodes are
+// bump allocated from a block of NURSERY_SIZE bytes, and between two steps of a top level weak head reduction the
+// nodes it still reaches are copied to the arena once the block is mostly used, so that it gets reused from the start.
+// Roots are the spine being reduced, the normalization worklist, the definitions compiled so far and the arena nodes
+// remembered as pointing into the nursery: those allocated while it was full, and those overwritten with a pointer
+// into it. Copies are scanned in turn, and indirections inside the nursery are bypassed rather than copied.
+// Every evaluation starts with the nursery on. Callers holding nodes of the graph across reductions, as streaming and
+// equivalence checking do, hand them to each collection through the roots callback.
+
+#define NURSERY_SIZE ((size_t)1 << 22)		// Bytes of the nursery
+#define NURSERY_COLLECTION (NURSERY_SIZE / 4 * 3)	// Bytes allocated since the last collection which start the next one
+
+// The evaluated handle and every stored definition reachable from it must outlive the evaluation, since the graph
+// borrows their names.
+
+struct Evaluation;
+
+typedef void (*EvaluationRoots)(struct Evaluation *evaluation, void *context);	// Passes every node the caller holds to evaluation_evacuate()
+
+struct Evaluation {
+	struct Arena arena;
+
+	struct Node *root;
+
+	int generational;		// Allocate new nodes in the nursery, collecting it during reduction
+	unsigned char *nursery;		// Block of NURSERY_SIZE bytes, NULL until the first node is allocated in it
+	size_t nursery_size;		// Bytes of the nursery allocated since the last collection
+
+	EvaluationRoots roots;		// Called by every collection, NULL when the caller holds no node
+	void *roots_context;
+
+	struct Node **remembered;	// Arena nodes which may point into the nursery, then the copies left to scan
+	size_t remembered_size;
+	size_t remembered_capacity;
+
+	struct Linker linker;
+	const struct HashMap *definitions;
+
+	struct Node **stack;		// Scratch stack shared by the spine walk and the normalization worklist
+	size_t stack_size;
+	size_t stack_capacity;
+
+	struct Node **renaming;		// Pairs of original and copied binders during instantiation
+	size_t renaming_size;
+	size_t renaming_capacity;
+
+	uint64_t renamed;		// Bloom filter of the binders renamed by the ongoing instantiation
+	uint64_t replaced;		// Bit of the binder it replaces, cleared once the variable of a linear binder is met
+
+	size_t step_limit;		// Maximum number of beta steps, 0 meaning unlimited
+	size_t node_limit;		// Nodes allocated past which no more beta step is taken, 0 meaning unlimited
+
+	enum EvaluationMode mode;
+	size_t depth;			// Nesting of argument evaluations in applicative order
+
+	struct Linkage *origin;		// Origin given to the nodes being allocated
+	int profiling;			// Count beta steps and allocations per definition in the linkages
+	int folding;			// Read back Church numerals and the normal forms of definitions as such
+
+	int loop_checking;		// Stop with EVALUATION_LOOP once a reduction loop is found
+	struct LoopCheck loop;
+
+	struct EvaluationStats stats;
+};
+
+#define DEFAULT_STEP_LIMIT 10000000
+#define DEPTH_LIMIT 10000
+#define FINGERPRINT_STEP_LIMIT 10000	// Beta steps spent looking for the normal form of a stored definition
+#define FINGERPRINT_NODE_LIMIT ((size_t)1 << 20)	// Nodes allocated likewise, since a step may copy a large body
+#define EVALUATION_POLL_INTERVAL 1024	// Steps between two polls of evaluation_control, a power of 2
+#define READBACK_NODE_LIMIT ((size_t)1 << 25)	// Nodes read back at most, as a shared graph may unfold into an exponentially larger term
+
+// Definition-time optimization
+// A definition is compiled and rewritten in the graph once when it is stored, then read back with numerals folded:
+// - redexes whose argument is used at most once, or is a variable, a name or a numeral, are contracted, unless the use
+//   lies under an abstraction that may run more than once and the argument still has work to do
+// - small non-recursive definitions are inlined where they are applied, and small numerals expanded likewise
+// - λx.M x becomes M when M is an abstraction or names one, where eta is a beta step as well
+// Every rewrite is a beta equivalence, so normal forms don't change.
+
+#define OPTIMIZATION_STEP_LIMIT 10000	// Rewrites performed at most on a definition
+#define INLINE_SIZE_LIMIT 64		// Terms of the largest definition inlined
+#define NUMERAL_INLINE_LIMIT 64		// Largest Church numeral expanded where applied
+
+struct Evaluation evaluation_create(struct LambdaHandle lambda, const struct HashMap *definitions);	// Link lambda against the definitions and compile it
+struct Evaluation evaluation_create_profiled(struct LambdaHandle lambda, const struct HashMap *definitions);	// Likewise against the definitions as written, profiling them
+void evaluation_destroy(struct Evaluation evaluation);							// Release the graph and every linkage
+
+int evaluation_reduce(struct Evaluation *evaluation, enum EvaluationMode mode);	// Reduce to the normal form of mode. Returns 0 once a limit is hit
+struct Node *evaluation_whnf(struct Evaluation *evaluation, struct Node *node);	// Reduce a node of the graph to weak head normal form in normal order
+struct LambdaHandle evaluation_readback(struct Evaluation *evaluation);	// Convert the current graph back into a freshly allocated lambda term
+struct LambdaHandle lambda_fold(struct LambdaHandle lambda, const struct HashMap *definitions);	// Fold numerals and definitions back into a term read back by another backend, in place
+int evaluation_stream(FILE *stream, struct Evaluation *evaluation);				// Normalize and print at once, head first. Returns 0 once a limit is hit
+void evaluation_fprint_shared(FILE *stream, struct Evaluation *evaluation, size_t limit);	// Print the current graph with shared subterms as let bindings, truncated after limit nodes unless 0
+
+int evaluation_poll(struct EvaluationStats *stats);	// Publish stats to evaluation_control. Returns 0 and marks stats cancelled if requested
+void evaluation_evacuate(struct Evaluation *evaluation, struct Node **slot);	// Point a node held by the caller to where the collection moved it
+
+struct Node *node_dereference(struct Node *node);	// Follow indirections, unfolded references and fixpoints to the current value of a node
+struct Node *node_forward(struct Node *node);		// Follow indirections only
+struct Node *abstraction_open(struct Node *node);	// Body of an abstraction about to be reduced in place, which no longer counts as linear
+
+struct LambdaHandle lambda_evaluate(
+	struct LambdaHandle lambda, const struct HashMap *definitions,
+	enum EvaluationMode mode, struct EvaluationStats *stats
+);	// Evaluate a term to the normal form of mode, folding numerals and definitions back
+
+int lambda_fingerprint_normal_form(const struct HashMap *definitions, struct LambdaHandle lambda, uint64_t *fingerprint);	// Fingerprint callback of the definitions' reverse index
+struct LambdaHandle lambda_optimize(const struct HashMap *definitions, struct LambdaHandle lambda);				// Optimize callback of the definitions
+
+// Equivalence checking
+// Two terms are compiled into one graph, where the definitions they both use share their nodes, and compared as a
+// bisimulation of head normal forms reduced lazily, pair by pair and level by level. Once both sides of a pair are head
+// normal forms λx1 ... λxn.h M1 ... Mk, their heads and numbers of arguments are compared and their arguments queued
+// as new pairs, so the first heads that differ end the comparison. A side with fewer binders is applied to a fresh
+// variable, which makes the comparison beta eta. Before reducing a pair, both sides are equated when they are the same
+// node and mean the same on both sides, or when their alpha invariant fingerprints agree, so equal subterms are rarely
+// reduced at all. Pairs of closed nodes met again are taken as equal, as bisimulation allows, hence the cycles of
+// recursive definitions are compared in finite time and terms without a normal form are equated when their Böhm trees
+// are equal up to eta. Infinite trees that never meet such a pair again are compared until a limit is hit. A side whose
+// head reduction loops is told apart from a head normal form, but left undecided against another looping term, unless
+// both were equated before being reduced.
+
+#define EQUIVALENCE_FINGERPRINT_BUDGET 256	// Nodes fingerprinted at most on each side of a pair before it is reduced
+#define EQUIVALENCE_LIMIT ((size_t)1 << 22)	// Nodes allocated, and pairs compared, past which equivalence is undecided
+
+int lambda_equivalent(
+	struct LambdaHandle left, struct LambdaHandle right, const struct HashMap *definitions, struct EvaluationStats *stats
+);	// Decide whether two terms are beta eta equivalent. Returns 1 if they are, 0 if not and -1 once a limit is hit first or both sides of a pair loop
\ No newline at end of file
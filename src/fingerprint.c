@@ -0,0 +1,150 @@
+#include <fingerprint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+#define TAG_VARIABLE 0x9e3779b97f4a7c15UL
+#define TAG_FREE_VARIABLE 0xc2b2ae3d27d4eb4fUL
+#define TAG_ABSTRACTION 0x165667b19e3779f9UL
+#define TAG_APPLICATION 0x27d4eb2f165667c5UL
+
+static uint64_t mix(uint64_t hash);
+
+static uint64_t term_fingerprint(const struct LambdaTerm *term, const struct Identifier ***scope, size_t *scope_size, size_t *scope_capacity);
+
+uint64_t fingerprint_variable(size_t index)
+{
+	return mix(TAG_VARIABLE + (uint64_t)index);
+}
+
+uint64_t fingerprint_free_variable(const struct Identifier *identifier)
+{
+	// FNV-1a of the name, as in the hashmap
+
+	uint64_t hash = 14695981039346656037UL;
+
+	for (const char *c = identifier->name; *c != '\0'; c++) {
+		hash ^= (uint64_t)(unsigned char)*c;
+		hash *= 1099511628211UL;
+	}
+
+	return mix(TAG_FREE_VARIABLE ^ (31 * hash + (uint64_t)identifier->subscript));
+}
+
+uint64_t fingerprint_abstraction(uint64_t body)
+{
+	return mix(TAG_ABSTRACTION ^ body);
+}
+
+uint64_t fingerprint_application(uint64_t function, uint64_t argument)
+{
+	// Asymmetric, so f x and x f differ
+
+	return mix(mix(TAG_APPLICATION ^ function) + argument);
+}
+
+uint64_t fingerprint_church_numeral(int church_numeral)
+{
+	uint64_t function = fingerprint_variable(1);
+	uint64_t body = fingerprint_variable(0);
+
+	for (int i = 0; i < church_numeral; i++) {
+		body = fingerprint_application(function, body);
+	}
+
+	return fingerprint_abstraction(fingerprint_abstraction(body));
+}
+
+uint64_t lambda_fingerprint(struct LambdaHandle lambda)
+{
+	if (lambda.term == NULL) {
+		return 0;
+	}
+
+	const struct Identifier **scope = NULL;
+
+	size_t scope_size = 0;
+	size_t scope_capacity = 0;
+
+	uint64_t fingerprint = term_fingerprint(lambda.term, &scope, &scope_size, &scope_capacity);
+
+	free(scope);
+
+	return fingerprint;
+}
+
+uint64_t term_fingerprint(const struct LambdaTerm *term, const struct Identifier ***scope, size_t *scope_size, size_t *scope_capacity)
+{
+	// The scope holds the enclosing binders, innermost last
+
+	switch (term->type) {
+	case CHURCH_NUMERAL:
+		return fingerprint_church_numeral(term->expression.church_numeral);
+
+	case BOUND_VARIABLE:
+		for (size_t i = *scope_size; i > 0; i--) {
+			const struct Identifier *binder = (*scope)[i - 1];
+
+			if (binder->subscript != term->expression.variable.subscript) {
+				continue;
+			}
+
+			if (binder->name == term->expression.variable.name || strcmp(binder->name, term->expression.variable.name) == 0) {
+				return fingerprint_variable(*scope_size - i);
+			}
+		}
+
+		return fingerprint_free_variable(&term->expression.variable);
+
+	case FREE_VARIABLE:
+		return fingerprint_free_variable(&term->expression.variable);
+
+	case ABSTRACTION:
+		if (*scope_size == *scope_capacity) {
+			// Scaling factor of 2
+
+			*scope_capacity = *scope_capacity == 0 ? INITIAL_CAPACITY : *scope_capacity << 1;
+			*scope = realloc(*scope, sizeof(**scope) * *scope_capacity);
+
+			if (*scope == NULL) {
+				goto fatal_error;
+			}
+		}
+
+		(*scope)[(*scope_size)++] = &term->expression.abstraction.bound_variable;
+
+		uint64_t body = term_fingerprint(term->expression.abstraction.body, scope, scope_size, scope_capacity);
+
+		(*scope_size)--;
+
+		return fingerprint_abstraction(body);
+
+	case APPLICATION:
+		uint64_t function = term_fingerprint(term->expression.application.function, scope, scope_size, scope_capacity);
+		uint64_t argument = term_fingerprint(term->expression.application.argument, scope, scope_size, scope_capacity);
+
+		return fingerprint_application(function, argument);
+
+	default:
+		return 0;
+	}
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function term_fingerprint().\n");
+	exit(1);
+}
+
+uint64_t mix(uint64_t hash)
+{
+	// Finalizer of splitmix64, with 0 mapped away since it means no fingerprint
+
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9UL;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebUL;
+	hash ^= hash >> 31;
+
+	return hash == 0 ? 1 : hash;
+}
\ No newline at end of file
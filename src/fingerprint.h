@@ -0,0 +1,17 @@
+#pragma once
+
+#include <lambda.h>
+#include <stdint.h>
+
+// Alpha invariant hashing of lambda terms
+// Bound variables are hashed by de Bruijn index, so terms differing only in the names of their binders get the same
+// fingerprint. A fingerprint is built bottom up in constant time per term from the fingerprints of its subterms.
+// Church numerals hash like their expansion λf.λx.f (f ... (f x)), and fingerprints are never 0.
+
+uint64_t fingerprint_variable(size_t index);					// Bound variable of de Bruijn index index
+uint64_t fingerprint_free_variable(const struct Identifier *identifier);	// Free variable
+uint64_t fingerprint_abstraction(uint64_t body);				// Abstraction of the given body
+uint64_t fingerprint_application(uint64_t function, uint64_t argument);	// Application
+uint64_t fingerprint_church_numeral(int church_numeral);			// Church numeral, in time linear in its value
+
+uint64_t lambda_fingerprint(struct LambdaHandle lambda);	// Fingerprint of a whole term
\ No newline at end of file
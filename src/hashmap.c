@@ -1,4 +1,5 @@
 #include <hashmap.h>
+#include <reclaimer.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -6,74 +7,227 @@
 
 #define INITIAL_SIZE 16
 
+// Once published, a table only changes through atomic stores to its slots
+
+struct HashMapTable {
+	size_t capacity;
+
+	_Atomic(struct HashMapEntry *) *entries;	// NULL for an empty slot
+	_Atomic size_t *index;				// Open addressing table of entry positions plus one, keyed by fingerprint
+};
+
+// The definitions written in terms of a name, only ever used by the writer
+
+struct HashMapDependency {
+	struct Identifier identifier;	// Copy of the name, NULL for an empty slot
+
+	struct Identifier *dependents;	// Sharing the name copied into their own slot
+	size_t dependents_size;
+	size_t dependents_capacity;
+
+	size_t search;			// Stamp of the latest search that reached the name
+};
+
 static uint64_t hash_key(struct Identifier identifier);
 static int identifier_comparison(struct Identifier left, struct Identifier right);
 
+static struct HashMapTable *table_create(size_t capacity);
+static struct HashMapTable *table_load(const struct HashMap *hashmap);
+static void table_retire(struct HashMapTable *table);
+
 static void hashmap_scale(struct HashMap *hashmap);
 
+static struct HashMapEntry *entry_get(const struct HashMapTable *table, size_t position);
+static struct HashMapEntry *entry_find(const struct HashMapTable *table, struct Identifier identifier);
+static size_t entry_slot(const struct HashMapTable *table, struct Identifier identifier);
+static void entry_publish(struct HashMapTable *table, size_t position, struct LambdaHandle lambda, struct LambdaHandle optimized, uint64_t fingerprint);
+static void entry_optimize(struct HashMap *hashmap, size_t position);
+static void entry_fingerprint(struct HashMap *hashmap, size_t position);
+static void entries_refresh(struct HashMap *hashmap, const struct Identifier *identifiers, size_t size);
+
+static size_t dependency_slot(const struct HashMap *hashmap, struct Identifier identifier);
+static struct HashMapDependency *dependency_get(struct HashMap *hashmap, struct Identifier identifier);
+static void dependencies_add(struct HashMap *hashmap, struct LambdaHandle lambda);
+static void dependencies_remove(struct HashMap *hashmap, struct LambdaHandle lambda);
+static void dependencies_scale(struct HashMap *hashmap);
+
+static void index_insert(struct HashMap *hashmap, size_t position);
+static void index_place(struct HashMap *hashmap, struct HashMapTable *table, size_t position);
+static void index_rebuild(struct HashMap *hashmap);
+
 struct HashMap hashmap_create()
 {
 	struct HashMap hashmap;
 
-	hashmap.capacity = INITIAL_SIZE;
-	hashmap.size = 0;
+	atomic_init(&hashmap.table, table_create(INITIAL_SIZE));
 
-	// The function calloc() is used to initialize all pointers to NULL
+	hashmap.size = 0;
+	hashmap.parent = NULL;
 
-	hashmap.entries = calloc(hashmap.capacity, sizeof(*hashmap.entries));
+	hashmap.index_size = 0;
+	hashmap.fingerprint = NULL;
+	hashmap.optimize = NULL;
 
-	if (hashmap.entries == NULL) {
-		goto fatal_error;
-	}
+	hashmap.dependencies = NULL;
+	hashmap.dependencies_size = 0;
+	hashmap.dependencies_capacity = 0;
+	hashmap.dependencies_search = 0;
 
 	return hashmap;
-	
-	fatal_error:
+}
 
-	printf("Fatal error: calloc() returned NULL in function hashmap_create().\n");
+struct HashMap hashmap_create_overlay(const struct HashMap *parent)
+{
+	struct HashMap hashmap = hashmap_create();
 
-	exit(1);
+	hashmap.parent = parent;
+	hashmap.fingerprint = parent->fingerprint;
+	hashmap.optimize = parent->optimize;
+
+	return hashmap;
 }
 
 void hashmap_destroy(struct HashMap hashmap)
 {
-	if (hashmap.entries == NULL) {
+	// Nobody reads a hashmap being destroyed, so everything is freed at once
+
+	struct HashMapTable *table = atomic_load(&hashmap.table);
+
+	if (table == NULL) {
 		return;
 	}
 
-	for (size_t index = 0; index < hashmap.capacity; index++) {
-		lambda_free(hashmap.entries[index]);
+	for (size_t position = 0; position < table->capacity; position++) {
+		struct HashMapEntry *entry = entry_get(table, position);
+
+		if (entry == NULL) {
+			continue;
+		}
+
+		lambda_free(entry->lambda);
+		lambda_free(entry->optimized);
+
+		free(entry);
+	}
+
+	free(table->entries);
+	free(table->index);
+	free(table);
+
+	for (size_t position = 0; position < hashmap.dependencies_capacity; position++) {
+		free(hashmap.dependencies[position].identifier.name);
+		free(hashmap.dependencies[position].dependents);
+	}
+
+	free(hashmap.dependencies);
+}
+
+struct LambdaHandle hashmap_get(const struct HashMap *hashmap, struct Identifier identifier)
+{
+	const struct HashMapEntry *entry = entry_find(table_load(hashmap), identifier);
+
+	if (entry != NULL) {
+		// The optimized term stands for the entry under its name
+
+		struct LambdaHandle lambda = entry->lambda;
+		struct LambdaHandle optimized = entry->optimized;
+
+		if (optimized.term != NULL) {
+			lambda.term = optimized.term;
+			lambda.free_variables = optimized.free_variables;
+			lambda.free_variables_size = optimized.free_variables_size;
+			lambda.free_variables_capacity = optimized.free_variables_capacity;
+		}
+
+		return lambda;
+	}
+
+	// Overlays fall back to the hashmap they are layered over
+
+	if (hashmap->parent != NULL) {
+		return hashmap_get(hashmap->parent, identifier);
+	}
+
+	// If no matching member is found, return an empty handle
+
+	return (struct LambdaHandle){0};
+}
+
+struct LambdaHandle hashmap_get_original(const struct HashMap *hashmap, struct Identifier identifier)
+{
+	const struct HashMapEntry *entry = entry_find(table_load(hashmap), identifier);
+
+	if (entry != NULL) {
+		return entry->lambda;
+	}
+
+	if (hashmap->parent != NULL) {
+		return hashmap_get_original(hashmap->parent, identifier);
 	}
 
-	free(hashmap.entries);
+	return (struct LambdaHandle){0};
+}
+
+struct HashMapEntry *entry_get(const struct HashMapTable *table, size_t position)
+{
+	return atomic_load_explicit(&table->entries[position], memory_order_acquire);
+}
+
+struct HashMapEntry *entry_find(const struct HashMapTable *table, struct Identifier identifier)
+{
+	// Returns the entry named identifier, or NULL if there is none
+
+	return entry_get(table, entry_slot(table, identifier));
 }
 
-struct LambdaHandle hashmap_get(struct HashMap hashmap, struct Identifier identifier)
+size_t entry_slot(const struct HashMapTable *table, struct Identifier identifier)
 {
+	// Returns the position of the entry named identifier, or of the empty slot it would take
+
 	uint64_t hash = hash_key(identifier);
-	size_t index = hash % hashmap.capacity;
+	size_t index = hash % table->capacity;
 
 	// Linear probing
 
-	struct LambdaHandle lambda = hashmap.entries[index];
+	struct HashMapEntry *entry;
 
-	while (lambda.identifier.name != NULL) {
-		if (identifier_comparison(lambda.identifier, identifier)) {
-			return lambda;
+	while ((entry = entry_get(table, index)) != NULL) {
+		if (identifier_comparison(entry->lambda.identifier, identifier)) {
+			return index;
 		}
 
 		index++;
 
-		if (index == hashmap.capacity) {
+		if (index == table->capacity) {
 			index = 0;
 		}
+	}
+
+	return index;
+}
+
+void entry_publish(struct HashMapTable *table, size_t position, struct LambdaHandle lambda, struct LambdaHandle optimized, uint64_t fingerprint)
+{
+	// Records are never modified once published: readers holding the one replaced keep it until they leave
+
+	struct HashMapEntry *entry = malloc(sizeof(*entry));
 
-		lambda = hashmap.entries[index];
+	if (entry == NULL) {
+		goto fatal_error;
 	}
 
-	// If no matching member is found, return an empty handle
+	entry->lambda = lambda;
+	entry->optimized = optimized;
+	entry->fingerprint = fingerprint;
 
-	return (struct LambdaHandle){0};
+	memory_retire(atomic_exchange_explicit(&table->entries[position], entry, memory_order_acq_rel));
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function entry_publish().\n");
+	exit(1);
 }
 
 int hashmap_set(struct HashMap *hashmap, struct LambdaHandle lambda)
@@ -82,38 +236,528 @@ int hashmap_set(struct HashMap *hashmap, struct LambdaHandle lambda)
 		return 0;
 	}
 
-	uint64_t hash = hash_key(lambda.identifier);
-	size_t index = hash % hashmap->capacity;
+	// Scaling at half capacity keeps the probing sequences short and guarantees an empty slot
 
-	if (hashmap->capacity == hashmap->size) {
+	if (hashmap->size >= table_load(hashmap)->capacity >> 1) {
 		// Scaling the hashmap to fit new members
 		hashmap_scale(hashmap);
 	}
 
-	struct LambdaHandle entry = hashmap->entries[index];
+	struct HashMapTable *table = table_load(hashmap);
+
+	size_t index = entry_slot(table, lambda.identifier);
+	struct HashMapEntry *entry = entry_get(table, index);
+
+	// The replaced terms are only retired once the new entry is published, so readers never reach them afterwards
+
+	int overwritten = entry != NULL;
+	struct HashMapEntry replaced = overwritten ? *entry : (struct HashMapEntry){0};
+
+	entry_publish(table, index, lambda, (struct LambdaHandle){0}, 0);
+
+	if (overwritten) {
+		// Overwritting the current entry
+		dependencies_remove(hashmap, replaced.lambda);
+
+		lambda_retire(replaced.lambda);
+		lambda_retire(replaced.optimized);
+	} else {
+		hashmap->size++;
+	}
+
+	dependencies_add(hashmap, lambda);
+
+	// The definitions written in terms of this one may have inlined what it replaced, or be reduced differently now
+	// that it exists, so they start over from what was written along with it. It comes last, to be indexed last.
+
+	size_t size;
+	struct Identifier *refreshed = hashmap_dependents(hashmap, &lambda.identifier, 1, &size);
+
+	refreshed = realloc(refreshed, sizeof(*refreshed) * (size + 1));
+
+	if (refreshed == NULL) {
+		goto fatal_error;
+	}
 
-	while (entry.identifier.name != NULL) {
-		if (identifier_comparison(entry.identifier, lambda.identifier)) {
-			// Overwritting the current entry
-			lambda_free(entry);
-			hashmap->size--;
-	
-			break;
+	refreshed[size++] = lambda.identifier;
+
+	entries_refresh(hashmap, refreshed, size);
+
+	free(refreshed);
+
+	return 1;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function hashmap_set().\n");
+	exit(1);
+}
+
+void hashmap_restore(struct HashMap *hashmap, struct LambdaHandle lambda, struct LambdaHandle optimized, uint64_t fingerprint)
+{
+	// Saved entries were optimized and indexed against each other, so nothing is computed again as long as all of
+	// them are restored
+
+	if (hashmap->size >= table_load(hashmap)->capacity >> 1) {
+		hashmap_scale(hashmap);
+	}
+
+	struct HashMapTable *table = table_load(hashmap);
+
+	size_t index = entry_slot(table, lambda.identifier);
+	struct HashMapEntry *entry = entry_get(table, index);
+
+	int overwritten = entry != NULL;
+	struct HashMapEntry replaced = overwritten ? *entry : (struct HashMapEntry){0};
+
+	entry_publish(table, index, lambda, optimized, fingerprint);
+
+	if (overwritten) {
+		dependencies_remove(hashmap, replaced.lambda);
+
+		lambda_retire(replaced.lambda);
+		lambda_retire(replaced.optimized);
+	} else {
+		hashmap->size++;
+	}
+
+	dependencies_add(hashmap, lambda);
+
+	if (fingerprint != 0) {
+		index_insert(hashmap, index);
+	}
+}
+
+void hashmap_update(struct HashMap *hashmap, struct Identifier identifier, struct LambdaHandle optimized, uint64_t fingerprint)
+{
+	// Lets a caller optimize and index definitions on its own, as long as nothing writes the hashmap meanwhile
+
+	struct HashMapTable *table = table_load(hashmap);
+
+	size_t index = entry_slot(table, identifier);
+	struct HashMapEntry *entry = entry_get(table, index);
+
+	if (entry == NULL) {
+		return;
+	}
+
+	struct HashMapEntry replaced = *entry;
+
+	if (optimized.term == NULL) {
+		optimized = replaced.optimized;
+	}
+
+	entry_publish(table, index, replaced.lambda, optimized, fingerprint);
+
+	if (optimized.term != replaced.optimized.term) {
+		lambda_retire(replaced.optimized);
+	}
+
+	if (fingerprint != 0 && fingerprint != replaced.fingerprint) {
+		index_insert(hashmap, index);
+	}
+}
+
+struct Identifier *hashmap_dependents(struct HashMap *hashmap, const struct Identifier *identifiers, size_t count, size_t *size)
+{
+	// Breadth first search through the dependencies, the array doubling as the queue after the identifiers. These are
+	// left out, even when they depend on each other or on themselves through others.
+
+	struct Identifier *dependents;
+
+	size_t capacity = INITIAL_SIZE;
+
+	dependents = malloc(sizeof(*dependents) * capacity);
+
+	if (dependents == NULL) {
+		goto fatal_error;
+	}
+
+	*size = 0;
+
+	hashmap->dependencies_search++;
+
+	for (size_t i = 0; i < count; i++) {
+		dependency_get(hashmap, identifiers[i])->search = hashmap->dependencies_search;
+	}
+
+	for (size_t i = 0; i < count + *size; i++) {
+		const struct HashMapDependency *dependency = dependency_get(hashmap, i < count ? identifiers[i] : dependents[i - count]);
+
+		for (size_t j = 0; j < dependency->dependents_size; j++) {
+			// Dependents have a slot of their own already, so looking them up never scales the table
+
+			struct HashMapDependency *dependent = dependency_get(hashmap, dependency->dependents[j]);
+
+			if (dependent->search == hashmap->dependencies_search) {
+				continue;
+			}
+
+			dependent->search = hashmap->dependencies_search;
+
+			if (*size == capacity) {
+				// Scaling factor of 2
+
+				capacity <<= 1;
+				dependents = realloc(dependents, sizeof(*dependents) * capacity);
+
+				if (dependents == NULL) {
+					goto fatal_error;
+				}
+			}
+
+			dependents[(*size)++] = dependent->identifier;
+		}
+	}
+
+	return dependents;
+
+	fatal_error:
+
+	printf("Fatal error: memory allocation failed in function hashmap_dependents().\n");
+	exit(1);
+}
+
+void hashmap_refresh(struct HashMap *hashmap, const struct Identifier *identifiers, size_t count)
+{
+	size_t size;
+	struct Identifier *refreshed = hashmap_dependents(hashmap, identifiers, count, &size);
+
+	entries_refresh(hashmap, refreshed, size);
+
+	free(refreshed);
+}
+
+int hashmap_find(const struct HashMap *hashmap, uint64_t fingerprint, struct Identifier *identifier)
+{
+	const struct HashMapTable *table = table_load(hashmap);
+
+	size_t index = fingerprint % table->capacity;
+	size_t position;
+
+	// Linear probing; entries whose fingerprint changed since they were indexed are skipped
+
+	while ((position = atomic_load_explicit(&table->index[index], memory_order_acquire)) != 0) {
+		const struct HashMapEntry *entry = entry_get(table, position - 1);
+
+		if (entry->fingerprint == fingerprint) {
+			*identifier = entry->lambda.identifier;
+
+			return 1;
 		}
 
 		index++;
 
-		if (index == hashmap->capacity) {
+		if (index == table->capacity) {
 			index = 0;
 		}
+	}
 
-		entry = hashmap->entries[index];
+	if (hashmap->parent == NULL || !hashmap_find(hashmap->parent, fingerprint, identifier)) {
+		return 0;
 	}
 
-	hashmap->entries[index] = lambda;
-	hashmap->size++;
-	
-	return 1;
+	// The name may be shadowed by a definition of the overlay
+
+	return hashmap_get(hashmap, *identifier).term == hashmap_get(hashmap->parent, *identifier).term;
+}
+
+const struct HashMapEntry *hashmap_next(const struct HashMap *hashmap, size_t *position)
+{
+	const struct HashMapTable *table = table_load(hashmap);
+
+	while (*position < table->capacity) {
+		const struct HashMapEntry *entry = entry_get(table, (*position)++);
+
+		if (entry != NULL) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+void entry_optimize(struct HashMap *hashmap, size_t position)
+{
+	struct HashMapTable *table = table_load(hashmap);
+	struct HashMapEntry *entry = entry_get(table, position);
+
+	if (entry == NULL) {
+		return;
+	}
+
+	struct LambdaHandle optimized = hashmap->optimize(hashmap, entry->lambda);
+
+	if (optimized.term != NULL) {
+		entry_publish(table, position, entry->lambda, optimized, entry->fingerprint);
+	}
+}
+
+void entry_fingerprint(struct HashMap *hashmap, size_t position)
+{
+	// Indexing the normal form of a definition, which may refer to itself. A definition whose normal form is no longer
+	// known loses its fingerprint, and the index slot it had is skipped from then on.
+
+	struct HashMapTable *table = table_load(hashmap);
+	struct HashMapEntry *entry = entry_get(table, position);
+
+	uint64_t fingerprint = 0;
+
+	if (!hashmap->fingerprint(hashmap, hashmap_get(hashmap, entry->lambda.identifier), &fingerprint)) {
+		fingerprint = 0;
+	}
+
+	if (fingerprint == entry->fingerprint) {
+		return;
+	}
+
+	entry_publish(table, position, entry->lambda, entry->optimized, fingerprint);
+
+	if (fingerprint != 0) {
+		index_insert(hashmap, position);
+	}
+}
+
+void entries_refresh(struct HashMap *hashmap, const struct Identifier *identifiers, size_t size)
+{
+	// Every entry starts over from what was written before any of them is optimized, so that none inlines the stale
+	// optimized form of another. Names without an entry are skipped.
+
+	struct HashMapTable *table = table_load(hashmap);
+
+	for (size_t i = 0; i < size; i++) {
+		size_t position = entry_slot(table, identifiers[i]);
+		struct HashMapEntry *entry = entry_get(table, position);
+
+		if (entry == NULL || entry->optimized.term == NULL) {
+			continue;
+		}
+
+		struct LambdaHandle optimized = entry->optimized;
+
+		entry_publish(table, position, entry->lambda, (struct LambdaHandle){0}, entry->fingerprint);
+		lambda_retire(optimized);
+	}
+
+	for (size_t i = 0; hashmap->optimize != NULL && i < size; i++) {
+		entry_optimize(hashmap, entry_slot(table, identifiers[i]));
+	}
+
+	// Indexing may rebuild the table, though without moving the entries
+
+	for (size_t i = 0; hashmap->fingerprint != NULL && i < size; i++) {
+		table = table_load(hashmap);
+
+		size_t position = entry_slot(table, identifiers[i]);
+
+		if (entry_get(table, position) != NULL) {
+			entry_fingerprint(hashmap, position);
+		}
+	}
+}
+
+size_t dependency_slot(const struct HashMap *hashmap, struct Identifier identifier)
+{
+	// Returns the position of the slot of identifier, or of the empty slot it would take
+
+	size_t index = hash_key(identifier) % hashmap->dependencies_capacity;
+
+	while (hashmap->dependencies[index].identifier.name != NULL) {
+		if (identifier_comparison(hashmap->dependencies[index].identifier, identifier)) {
+			return index;
+		}
+
+		index++;
+
+		if (index == hashmap->dependencies_capacity) {
+			index = 0;
+		}
+	}
+
+	return index;
+}
+
+struct HashMapDependency *dependency_get(struct HashMap *hashmap, struct Identifier identifier)
+{
+	// Finds the slot of a name or creates it. Only creating a slot may scale the table and move the others.
+
+	size_t index;
+
+	if (hashmap->dependencies_capacity > 0) {
+		index = dependency_slot(hashmap, identifier);
+
+		if (hashmap->dependencies[index].identifier.name != NULL) {
+			return hashmap->dependencies + index;
+		}
+	}
+
+	if (hashmap->dependencies_size >= hashmap->dependencies_capacity >> 1) {
+		dependencies_scale(hashmap);
+	}
+
+	index = dependency_slot(hashmap, identifier);
+
+	struct HashMapDependency *dependency = hashmap->dependencies + index;
+
+	dependency->identifier.name = strdup(identifier.name);
+	dependency->identifier.subscript = identifier.subscript;
+
+	if (dependency->identifier.name == NULL) {
+		goto fatal_error;
+	}
+
+	hashmap->dependencies_size++;
+
+	return dependency;
+
+	fatal_error:
+
+	printf("Fatal error: strdup() returned NULL in function dependency_get().\n");
+	exit(1);
+}
+
+void dependencies_add(struct HashMap *hashmap, struct LambdaHandle lambda)
+{
+	// Names copied into the slots never move, even when the table is scaled
+
+	struct Identifier name = dependency_get(hashmap, lambda.identifier)->identifier;
+
+	for (size_t i = 0; i < lambda.free_variables_size; i++) {
+		if (identifier_comparison(lambda.free_variables[i], name)) {
+			continue;
+		}
+
+		struct HashMapDependency *dependency = dependency_get(hashmap, lambda.free_variables[i]);
+
+		if (dependency->dependents_size == dependency->dependents_capacity) {
+			// Scaling factor of 2
+
+			dependency->dependents_capacity = dependency->dependents_capacity == 0 ? 4 : dependency->dependents_capacity << 1;
+			dependency->dependents = realloc(dependency->dependents, sizeof(*dependency->dependents) * dependency->dependents_capacity);
+
+			if (dependency->dependents == NULL) {
+				goto fatal_error;
+			}
+		}
+
+		dependency->dependents[dependency->dependents_size++] = name;
+	}
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function dependencies_add().\n");
+	exit(1);
+}
+
+void dependencies_remove(struct HashMap *hashmap, struct LambdaHandle lambda)
+{
+	for (size_t i = 0; i < lambda.free_variables_size; i++) {
+		if (identifier_comparison(lambda.free_variables[i], lambda.identifier)) {
+			continue;
+		}
+
+		struct HashMapDependency *dependency = dependency_get(hashmap, lambda.free_variables[i]);
+
+		for (size_t j = 0; j < dependency->dependents_size; j++) {
+			if (identifier_comparison(dependency->dependents[j], lambda.identifier)) {
+				dependency->dependents[j] = dependency->dependents[--dependency->dependents_size];
+				break;
+			}
+		}
+	}
+}
+
+void dependencies_scale(struct HashMap *hashmap)
+{
+	struct HashMapDependency *dependencies = hashmap->dependencies;
+	size_t capacity = hashmap->dependencies_capacity;
+
+	hashmap->dependencies_capacity = capacity == 0 ? INITIAL_SIZE : capacity << 1;
+	hashmap->dependencies = calloc(hashmap->dependencies_capacity, sizeof(*hashmap->dependencies));
+
+	if (hashmap->dependencies == NULL) {
+		goto fatal_error;
+	}
+
+	for (size_t position = 0; position < capacity; position++) {
+		if (dependencies[position].identifier.name != NULL) {
+			hashmap->dependencies[dependency_slot(hashmap, dependencies[position].identifier)] = dependencies[position];
+		}
+	}
+
+	free(dependencies);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function dependencies_scale().\n");
+	exit(1);
+}
+
+void index_insert(struct HashMap *hashmap, size_t position)
+{
+	// Stale slots are only reclaimed by rebuilding, which also guarantees an empty slot
+
+	if (hashmap->index_size >= table_load(hashmap)->capacity >> 1) {
+		index_rebuild(hashmap);
+	}
+
+	index_place(hashmap, table_load(hashmap), position);
+}
+
+void index_place(struct HashMap *hashmap, struct HashMapTable *table, size_t position)
+{
+	uint64_t fingerprint = entry_get(table, position)->fingerprint;
+	size_t index = fingerprint % table->capacity;
+	size_t current;
+
+	while ((current = atomic_load_explicit(&table->index[index], memory_order_relaxed)) != 0) {
+		if (entry_get(table, current - 1)->fingerprint == fingerprint) {
+			// The latest definition with a given normal form names it
+
+			atomic_store_explicit(&table->index[index], position + 1, memory_order_release);
+
+			return;
+		}
+
+		index++;
+
+		if (index == table->capacity) {
+			index = 0;
+		}
+	}
+
+	atomic_store_explicit(&table->index[index], position + 1, memory_order_release);
+	hashmap->index_size++;
+}
+
+void index_rebuild(struct HashMap *hashmap)
+{
+	// Readers may be probing the index, so it is rebuilt in a copy of the table sharing its entries
+
+	struct HashMapTable *table = table_load(hashmap);
+	struct HashMapTable *rebuilt = table_create(table->capacity);
+
+	for (size_t position = 0; position < table->capacity; position++) {
+		atomic_store_explicit(&rebuilt->entries[position], entry_get(table, position), memory_order_relaxed);
+	}
+
+	hashmap->index_size = 0;
+
+	for (size_t position = 0; position < rebuilt->capacity; position++) {
+		struct HashMapEntry *entry = entry_get(rebuilt, position);
+
+		if (entry != NULL && entry->fingerprint != 0) {
+			index_place(hashmap, rebuilt, position);
+		}
+	}
+
+	atomic_store_explicit(&hashmap->table, rebuilt, memory_order_release);
+
+	table_retire(table);
 }
 
 #define FNV_OFFSET 14695981039346656037UL
@@ -133,42 +777,80 @@ uint64_t hash_key(struct Identifier identifier)
 	return hash;
 }
 
-void hashmap_scale(struct HashMap *hashmap)
+struct HashMapTable *table_create(size_t capacity)
 {
-	size_t new_capacity = hashmap->capacity << 1;
+	struct HashMapTable *table;
 
-	struct LambdaHandle *new_entries;
+	table = calloc(1, sizeof(*table));
 
-	new_entries = calloc(new_capacity, sizeof(*new_entries));
+	if (table == NULL) {
+		goto fatal_error;
+	}
 
-	if (new_entries == NULL) {
+	// The function calloc() is used to initialize all pointers to NULL
+
+	table->capacity = capacity;
+	table->entries = calloc(capacity, sizeof(*table->entries));
+	table->index = calloc(capacity, sizeof(*table->index));
+
+	if (table->entries == NULL || table->index == NULL) {
 		goto fatal_error;
 	}
 
-	for (uint64_t index = 0; index < hashmap->capacity; index++) {
-		struct LambdaHandle lambda = hashmap->entries[index];
+	return table;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function table_create().\n");
+	exit(1);
+}
+
+struct HashMapTable *table_load(const struct HashMap *hashmap)
+{
+	return atomic_load_explicit(&hashmap->table, memory_order_acquire);
+}
+
+void table_retire(struct HashMapTable *table)
+{
+	// The entries themselves live on in the table replacing this one
+
+	memory_retire(table->entries);
+	memory_retire(table->index);
+	memory_retire(table);
+}
 
-		if (lambda.identifier.name == NULL) {
+void hashmap_scale(struct HashMap *hashmap)
+{
+	// The scaled table is filled before it is published, so readers see either table whole
+
+	struct HashMapTable *table = table_load(hashmap);
+	struct HashMapTable *scaled = table_create(table->capacity << 1);
+
+	for (size_t position = 0; position < table->capacity; position++) {
+		struct HashMapEntry *entry = entry_get(table, position);
+
+		if (entry == NULL) {
 			continue;
 		}
 
-		uint64_t hash = hash_key(lambda.identifier);
-		size_t new_index = hash % new_capacity;
-
-		new_entries[new_index] = lambda;
+		atomic_store_explicit(&scaled->entries[entry_slot(scaled, entry->lambda.identifier)], entry, memory_order_relaxed);
 	}
 
-	free(hashmap->entries);
-	
-	hashmap->entries = new_entries;
-	hashmap->capacity = new_capacity;
+	// Entry positions changed, so the reverse index is built again
 
-	return;
+	hashmap->index_size = 0;
 
-	fatal_error:
+	for (size_t position = 0; position < scaled->capacity; position++) {
+		struct HashMapEntry *entry = entry_get(scaled, position);
 
-	printf("Fatal error: calloc() returned NULL in function hashmap_scale.");
-	exit(1);
+		if (entry != NULL && entry->fingerprint != 0) {
+			index_place(hashmap, scaled, position);
+		}
+	}
+
+	atomic_store_explicit(&hashmap->table, scaled, memory_order_release);
+
+	table_retire(table);
 }
 
 int identifier_comparison(struct Identifier left, struct Identifier right)
@@ -1,20 +1,73 @@
 #pragma once
 
 #include <lambda.h>
+#include <stdatomic.h>
+#include <stdint.h>
 
 // A hashtable implementation to store free variables
 // Linear probing is used to handle hash collisions
 // The entries array is reallocated once the number of entries grows
+// An overlay hashmap falls back to its parent on lookup misses, without ever modifying it
+// A reverse index maps the fingerprint of each definition's normal form back to its name. It is filled by hashmap_set()
+// through the fingerprint callback.
+// Definitions are optimized once when they are set, through the optimize callback, and lookups return the optimized
+// form while the entry keeps the one written.
+// The writer also maps every name to the definitions written in terms of it. When a definition is overwritten, the ones
+// depending on it, directly or not, are optimized and indexed again, since they may have inlined it or reduce to
+// something else now; the others are left alone. A caller storing many definitions at once may instead store them as
+// written with hashmap_restore(), compute their optimized forms and fingerprints itself, hand them over through
+// hashmap_update() and refresh the definitions depending on them.
+// Lookups never lock, so threads may read a hashmap while one thread at a time writes it. Each entry is an immutable
+// record, and writing one publishes a new record in its slot with a single atomic store, as scaling the table publishes
+// a new table. What a write replaces is retired through the reclaimer rather than freed, so readers must run between
+// reclaimer_enter() and reclaimer_leave() whenever another thread may write, and the handles they were given stay valid
+// until they leave. A reader may see some entries from before a write and others from after it, as when every entry is
+// optimized again.
+
+struct HashMap;
+struct HashMapTable;
+struct HashMapDependency;
+
+typedef int (*HashMapFingerprint)(const struct HashMap *hashmap, struct LambdaHandle lambda, uint64_t *fingerprint);	// Returns 0 when lambda has no known normal form
+typedef struct LambdaHandle (*HashMapOptimize)(const struct HashMap *hashmap, struct LambdaHandle lambda);		// Returns an empty handle when lambda is kept as written
+
+struct HashMapEntry {
+	struct LambdaHandle lambda;	// As written
+	struct LambdaHandle optimized;	// With a NULL term when it is used as written
+	uint64_t fingerprint;		// Normal form fingerprint, 0 when unknown
+};
 
 struct HashMap {
-	struct LambdaHandle *entries;
+	_Atomic(struct HashMapTable *) table;	// Entries and reverse index, replaced as a whole when scaled
 
 	size_t size;
-	size_t capacity;
+
+	const struct HashMap *parent;
+
+	HashMapOptimize optimize;	// NULL stores the definitions as written
+
+	size_t index_size;		// Slots used in the reverse index, stale ones included
+	HashMapFingerprint fingerprint;	// NULL disables the reverse index
+
+	struct HashMapDependency *dependencies;	// Open addressing table from a name to the definitions using it, for the writer only
+	size_t dependencies_size;
+	size_t dependencies_capacity;
+	size_t dependencies_search;		// Stamp of the latest search through the dependencies
 };
 
-struct HashMap hashmap_create();		// Create an empty hashmap
+struct HashMap hashmap_create();					// Create an empty hashmap
+struct HashMap hashmap_create_overlay(const struct HashMap *parent);	// Create an empty hashmap layered over parent
 void hashmap_destroy(struct HashMap hashmap);	// Deallocate all the memory stored inside the hashmap (including the terms stored inside it)
 
-struct LambdaHandle hashmap_get(struct HashMap hashmap, struct Identifier identifier);		// Acess a term inside the hashmap
-int hashmap_set(struct HashMap *hashmap, struct LambdaHandle lambda);				// Store a term inside the hashmap. Returns 0 upon failure and 1 upon success
\ No newline at end of file
+struct LambdaHandle hashmap_get(const struct HashMap *hashmap, struct Identifier identifier);		// Acess a term inside the hashmap, optimized if it was
+struct LambdaHandle hashmap_get_original(const struct HashMap *hashmap, struct Identifier identifier);	// Acess a term inside the hashmap as it was written
+int hashmap_set(struct HashMap *hashmap, struct LambdaHandle lambda);				// Store a term inside the hashmap. Returns 0 upon failure and 1 upon success
+void hashmap_restore(struct HashMap *hashmap, struct LambdaHandle lambda, struct LambdaHandle optimized, uint64_t fingerprint);	// Store a term with the optimized form and fingerprint it had, computing neither
+void hashmap_update(struct HashMap *hashmap, struct Identifier identifier, struct LambdaHandle optimized, uint64_t fingerprint);	// Give a stored term the optimized form and fingerprint computed for it, keeping the optimized form it has if optimized is empty
+
+struct Identifier *hashmap_dependents(struct HashMap *hashmap, const struct Identifier *identifiers, size_t count, size_t *size);	// The definitions written in terms of any of identifiers, directly or not. The array is to be freed, the names belong to the hashmap
+void hashmap_refresh(struct HashMap *hashmap, const struct Identifier *identifiers, size_t count);				// Optimize and index again the definitions depending on any of identifiers, after they changed underneath an overlay or were stored without hashmap_set()
+
+int hashmap_find(const struct HashMap *hashmap, uint64_t fingerprint, struct Identifier *identifier);	// Name a definition whose normal form has the fingerprint. Returns 0 if none
+
+const struct HashMapEntry *hashmap_next(const struct HashMap *hashmap, size_t *position);	// The first entry at position or past it, moving position after it. Returns NULL past the last one, overlays excluded
\ No newline at end of file
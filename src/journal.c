@@ -0,0 +1,1019 @@
+#include <journal.h>
+#include <reclaimer.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define INITIAL_CAPACITY 4096
+
+#define JOURNAL_MAGIC "LAMJRNL1"
+#define SNAPSHOT_MAGIC "LAMSNAP1"
+#define MAGIC_SIZE 8
+
+#define FNV_OFFSET 14695981039346656037UL
+#define FNV_PRIME 1099511628211UL
+
+// Every record of the journal is an encoded definition, the snapshot a header followed by its entries:
+// fingerprint, whether an optimized form follows, the definition as written and its optimized form
+// A handle is encoded as its name, its free variables, then its term in preorder: a tag byte per term, a name for
+// abstractions, the index of the free variable or the de Bruijn index of the binder for variables.
+
+struct JournalHeader {
+	char magic[MAGIC_SIZE];
+	uint64_t epoch;			// Epoch of the snapshot the records follow
+};
+
+struct SnapshotHeader {
+	char magic[MAGIC_SIZE];
+	uint64_t epoch;
+	uint64_t entries;
+	uint64_t size;			// Bytes of the entries
+	uint64_t checksum;		// Of the entries
+};
+
+struct RecordHeader {
+	uint32_t size;
+	uint32_t checksum;
+};
+
+struct JournalBuffer {
+	unsigned char *data;
+	size_t size;
+	size_t capacity;
+};
+
+// Bounds checked reading out of a mapped file, which fails instead of reading past the end
+
+struct JournalReader {
+	const unsigned char *data;
+	size_t size;
+	size_t position;
+};
+
+// Enclosing binders of a term being encoded or decoded, innermost first
+
+struct JournalScope {
+	const struct Identifier *binder;
+	const struct JournalScope *next;
+};
+
+struct Journal {
+	int open;
+
+	char *journal_path;
+	char *snapshot_path;
+	char *temporary_path;		// Snapshot being written, renamed over snapshot_path once complete
+
+	int file;			// Journal file descriptor, written by the journal thread only
+	uint64_t epoch;			// Epoch of the latest snapshot requested
+	size_t records;			// Records appended since the latest snapshot requested
+
+	// Shared with the journal thread under lock
+
+	struct JournalBuffer pending;	// Records not written yet
+	const struct HashMap *compacting;	// Hashmap to snapshot, NULL if none was requested
+	size_t covered;			// Bytes of pending records which the snapshot will hold
+
+	int stopping;
+	int failed;			// A write failed, after which nothing more gets written
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t queued;
+};
+
+static struct Journal journal = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.queued = PTHREAD_COND_INITIALIZER
+};
+
+static void *journal_main(void *argument);
+static int journal_replay(struct HashMap *hashmap, const unsigned char *data, size_t size, size_t *count);
+static int snapshot_restore(struct HashMap *hashmap, uint64_t *epoch, size_t *count);
+static void snapshot_encode(struct JournalBuffer *buffer, const struct HashMap *hashmap, uint64_t epoch);
+static int snapshot_write(const struct JournalBuffer *buffer);
+
+static int handle_encode(struct JournalBuffer *buffer, struct LambdaHandle lambda);
+static int term_encode(struct JournalBuffer *buffer, const struct LambdaTerm *term, struct LambdaHandle lambda, const struct JournalScope *scope);
+static void identifier_encode(struct JournalBuffer *buffer, const struct Identifier *identifier);
+
+static int handle_decode(struct JournalReader *reader, struct LambdaHandle *lambda);
+static struct LambdaTerm *term_decode(struct JournalReader *reader, struct LambdaHandle *lambda, const struct JournalScope *scope);
+static int identifier_decode(struct JournalReader *reader, struct Identifier *identifier);
+static int reader_read(struct JournalReader *reader, void *data, size_t size);
+
+static void buffer_write(struct JournalBuffer *buffer, const void *data, size_t size);
+static int file_write(int file, const void *data, size_t size);
+static int directory_sync(const char *path);
+static char *path_join(const char *path, const char *suffix);
+static uint64_t checksum(const unsigned char *data, size_t size);
+
+int journal_open(const char *path, struct HashMap *hashmap, size_t *count)
+{
+	if (journal.open) {
+		printf("ERROR: a session is already open.\n");
+		return 0;
+	}
+
+	journal.file = -1;
+	journal.journal_path = path_join(path, ".journal");
+	journal.snapshot_path = path_join(path, ".snapshot");
+	journal.temporary_path = path_join(path, ".snapshot.tmp");
+
+	size_t restored = 0;
+	uint64_t epoch = 0;
+
+	if (!snapshot_restore(hashmap, &epoch, &restored)) {
+		goto failure;
+	}
+
+	journal.file = open(journal.journal_path, O_RDWR | O_CREAT, 0644);
+
+	if (journal.file < 0) {
+		printf("ERROR: could not open %s.\n", journal.journal_path);
+		goto failure;
+	}
+
+	struct stat status;
+
+	if (fstat(journal.file, &status) != 0) {
+		printf("ERROR: could not open %s.\n", journal.journal_path);
+		goto failure;
+	}
+
+	// Records after the last complete one, if the session crashed while writing it, are cut off
+
+	size_t size = (size_t)status.st_size;
+	size_t valid = 0;
+	size_t replayed = 0;
+
+	if (size >= sizeof(struct JournalHeader)) {
+		unsigned char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, journal.file, 0);
+
+		if (data == MAP_FAILED) {
+			printf("ERROR: could not read %s.\n", journal.journal_path);
+			goto failure;
+		}
+
+		struct JournalHeader header;
+
+		memcpy(&header, data, sizeof(header));
+
+		// A journal older than the snapshot only holds what the snapshot does
+
+		if (memcmp(header.magic, JOURNAL_MAGIC, MAGIC_SIZE) == 0 && header.epoch >= epoch) {
+			valid = sizeof(header) + journal_replay(hashmap, data + sizeof(header), size - sizeof(header), &replayed);
+			epoch = header.epoch;
+		}
+
+		munmap(data, size);
+	}
+
+	if (valid == 0) {
+		struct JournalHeader header = {JOURNAL_MAGIC, epoch};
+
+		if (ftruncate(journal.file, 0) != 0 || !file_write(journal.file, &header, sizeof(header))) {
+			printf("ERROR: could not write %s.\n", journal.journal_path);
+			goto failure;
+		}
+
+		valid = sizeof(header);
+	}
+
+	if (ftruncate(journal.file, (off_t)valid) != 0 || lseek(journal.file, 0, SEEK_END) < 0) {
+		printf("ERROR: could not write %s.\n", journal.journal_path);
+		goto failure;
+	}
+
+	journal.epoch = epoch;
+	journal.records = replayed;
+	journal.stopping = 0;
+	journal.failed = 0;
+
+	if (pthread_create(&journal.thread, NULL, journal_main, NULL) != 0) {
+		printf("ERROR: could not start the journal thread.\n");
+		goto failure;
+	}
+
+	journal.open = 1;
+
+	if (count != NULL) {
+		*count = restored + replayed;
+	}
+
+	return 1;
+
+	failure:
+
+	if (journal.file >= 0) {
+		close(journal.file);
+	}
+
+	free(journal.journal_path);
+	free(journal.snapshot_path);
+	free(journal.temporary_path);
+
+	return 0;
+}
+
+void journal_close(const struct HashMap *hashmap)
+{
+	if (!journal.open) {
+		return;
+	}
+
+	// The next session starts from a snapshot alone
+
+	if (journal.records != 0) {
+		journal_compact(hashmap);
+	}
+
+	pthread_mutex_lock(&journal.lock);
+
+	journal.stopping = 1;
+
+	pthread_cond_signal(&journal.queued);
+	pthread_mutex_unlock(&journal.lock);
+
+	pthread_join(journal.thread, NULL);
+
+	close(journal.file);
+
+	free(journal.pending.data);
+	free(journal.journal_path);
+	free(journal.snapshot_path);
+	free(journal.temporary_path);
+
+	journal.open = 0;
+	journal.pending = (struct JournalBuffer){0};
+	journal.compacting = NULL;
+}
+
+int journal_append(const struct HashMap *hashmap, struct LambdaHandle lambda)
+{
+	if (!journal.open) {
+		return 1;
+	}
+
+	pthread_mutex_lock(&journal.lock);
+
+	// The header is filled in once the size of the record is known
+
+	size_t begin = journal.pending.size;
+	struct RecordHeader header = {0};
+
+	buffer_write(&journal.pending, &header, sizeof(header));
+
+	if (!handle_encode(&journal.pending, lambda)) {
+		journal.pending.size = begin;
+
+		pthread_mutex_unlock(&journal.lock);
+
+		return 0;
+	}
+
+	header.size = (uint32_t)(journal.pending.size - begin - sizeof(header));
+	header.checksum = (uint32_t)checksum(journal.pending.data + begin + sizeof(header), header.size);
+
+	memcpy(journal.pending.data + begin, &header, sizeof(header));
+
+	pthread_cond_signal(&journal.queued);
+	pthread_mutex_unlock(&journal.lock);
+
+	if (++journal.records >= JOURNAL_COMPACTION_RECORDS) {
+		journal_compact(hashmap);
+	}
+
+	return 1;
+}
+
+void journal_compact(const struct HashMap *hashmap)
+{
+	if (!journal.open) {
+		return;
+	}
+
+	// Only requested here, the journal thread encoding the hashmap while the caller goes on. A snapshot still waiting is
+	// superseded by this one.
+
+	pthread_mutex_lock(&journal.lock);
+
+	journal.compacting = hashmap;
+	journal.covered = journal.pending.size;
+	journal.epoch++;
+	journal.records = 0;
+
+	pthread_cond_signal(&journal.queued);
+	pthread_mutex_unlock(&journal.lock);
+}
+
+void *journal_main(void *argument)
+{
+	(void)argument;
+
+	// Buffers are swapped with the shared ones, so appending never waits for a write
+
+	struct JournalBuffer records = {0};
+	struct JournalBuffer snapshot = {0};
+
+	pthread_mutex_lock(&journal.lock);
+
+	while (1) {
+		while (journal.pending.size == 0 && journal.compacting == NULL && !journal.stopping) {
+			pthread_cond_wait(&journal.queued, &journal.lock);
+		}
+
+		if (journal.pending.size == 0 && journal.compacting == NULL) {
+			break;
+		}
+
+		struct JournalBuffer swapped = journal.pending;
+
+		journal.pending = records;
+		journal.pending.size = 0;
+		records = swapped;
+
+		const struct HashMap *compacting = journal.compacting;
+		uint64_t epoch = journal.epoch;
+
+		journal.compacting = NULL;
+
+		size_t covered = journal.covered;
+
+		journal.covered = 0;
+
+		int failed = journal.failed;
+
+		pthread_mutex_unlock(&journal.lock);
+
+		// The hashmap is read while the REPL may write it. The snapshot then holds every definition the covered
+		// records do, and maybe some of the ones after them, which replaying those records stores again all the same.
+
+		if (!failed && compacting != NULL) {
+			size_t reader = reclaimer_enter();
+
+			snapshot_encode(&snapshot, compacting, epoch);
+
+			reclaimer_leave(reader);
+		}
+
+		// Records the snapshot holds are written first, in case writing it fails
+
+		if (!failed && snapshot.size != 0) {
+			struct SnapshotHeader header;
+
+			memcpy(&header, snapshot.data, sizeof(header));
+
+			struct JournalHeader reset = {JOURNAL_MAGIC, header.epoch};
+
+			failed = !file_write(journal.file, records.data, covered) || !snapshot_write(&snapshot) ||
+				ftruncate(journal.file, 0) != 0 || lseek(journal.file, 0, SEEK_SET) != 0 ||
+				!file_write(journal.file, &reset, sizeof(reset));
+
+			snapshot.size = 0;
+		} else {
+			covered = 0;
+		}
+
+		if (!failed) {
+			failed = !file_write(journal.file, records.data + covered, records.size - covered) || fdatasync(journal.file) != 0;
+		}
+
+		pthread_mutex_lock(&journal.lock);
+
+		if (failed && !journal.failed) {
+			printf("\nERROR: could not write %s, the session is no longer saved.\n", journal.journal_path);
+		}
+
+		journal.failed = failed;
+	}
+
+	pthread_mutex_unlock(&journal.lock);
+
+	free(records.data);
+	free(snapshot.data);
+
+	return NULL;
+}
+
+int journal_replay(struct HashMap *hashmap, const unsigned char *data, size_t size, size_t *count)
+{
+	// Returns the bytes of the complete records stored
+
+	struct JournalReader reader = {data, size, 0};
+
+	*count = 0;
+
+	while (1) {
+		size_t begin = reader.position;
+
+		struct RecordHeader header;
+
+		if (!reader_read(&reader, &header, sizeof(header)) || header.size > reader.size - reader.position ||
+			(uint32_t)checksum(reader.data + reader.position, header.size) != header.checksum) {
+			return begin;
+		}
+
+		struct JournalReader record = {reader.data + reader.position, header.size, 0};
+		struct LambdaHandle lambda;
+
+		if (!handle_decode(&record, &lambda)) {
+			return begin;
+		}
+
+		if (lambda.identifier.name == NULL) {
+			lambda_free(lambda);
+			return begin;
+		}
+
+		hashmap_set(hashmap, lambda);
+
+		reader.position += header.size;
+
+		++*count;
+	}
+}
+
+int snapshot_restore(struct HashMap *hashmap, uint64_t *epoch, size_t *count)
+{
+	// A missing snapshot is an empty session
+
+	int file = open(journal.snapshot_path, O_RDONLY);
+
+	if (file < 0) {
+		return errno == ENOENT;
+	}
+
+	struct stat status;
+
+	if (fstat(file, &status) != 0 || (size_t)status.st_size < sizeof(struct SnapshotHeader)) {
+		printf("ERROR: %s is not a snapshot.\n", journal.snapshot_path);
+		close(file);
+
+		return 0;
+	}
+
+	size_t size = (size_t)status.st_size;
+	unsigned char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+	close(file);
+
+	if (data == MAP_FAILED) {
+		printf("ERROR: could not read %s.\n", journal.snapshot_path);
+		return 0;
+	}
+
+	struct SnapshotHeader header;
+
+	memcpy(&header, data, sizeof(header));
+
+	struct JournalReader reader = {data + sizeof(header), size - sizeof(header), 0};
+
+	if (memcmp(header.magic, SNAPSHOT_MAGIC, MAGIC_SIZE) != 0 || header.size != reader.size ||
+		checksum(reader.data, reader.size) != header.checksum) {
+		printf("ERROR: %s is not a snapshot.\n", journal.snapshot_path);
+		munmap(data, size);
+
+		return 0;
+	}
+
+	// The definitions were optimized and fingerprinted together, so they are stored as they were
+
+	for (uint64_t i = 0; i < header.entries; i++) {
+		uint64_t fingerprint;
+		unsigned char optimized;
+
+		struct LambdaHandle lambda = {0};
+		struct LambdaHandle optimized_lambda = {0};
+
+		if (!reader_read(&reader, &fingerprint, sizeof(fingerprint)) || !reader_read(&reader, &optimized, sizeof(optimized)) ||
+			!handle_decode(&reader, &lambda) || (optimized && !handle_decode(&reader, &optimized_lambda))) {
+			// The checksum matched, so only a bug can lead here
+
+			printf("ERROR: %s is not a snapshot.\n", journal.snapshot_path);
+
+			lambda_free(lambda);
+			munmap(data, size);
+
+			return 0;
+		}
+
+		hashmap_restore(hashmap, lambda, optimized_lambda, fingerprint);
+	}
+
+	munmap(data, size);
+
+	*epoch = header.epoch;
+	*count = header.entries;
+
+	return 1;
+}
+
+void snapshot_encode(struct JournalBuffer *buffer, const struct HashMap *hashmap, uint64_t epoch)
+{
+	struct SnapshotHeader header = {SNAPSHOT_MAGIC, epoch, 0, 0, 0};
+
+	buffer_write(buffer, &header, sizeof(header));
+
+	size_t position = 0;
+	const struct HashMapEntry *entry;
+
+	while ((entry = hashmap_next(hashmap, &position)) != NULL) {
+		size_t begin = buffer->size;
+		unsigned char present = entry->optimized.term != NULL;
+
+		buffer_write(buffer, &entry->fingerprint, sizeof(entry->fingerprint));
+		buffer_write(buffer, &present, sizeof(present));
+
+		if (!handle_encode(buffer, entry->lambda) || (present && !handle_encode(buffer, entry->optimized))) {
+			buffer->size = begin;
+			continue;
+		}
+
+		header.entries++;
+	}
+
+	header.size = buffer->size - sizeof(header);
+	header.checksum = checksum(buffer->data + sizeof(header), header.size);
+
+	memcpy(buffer->data, &header, sizeof(header));
+}
+
+int snapshot_write(const struct JournalBuffer *buffer)
+{
+	// The previous snapshot stays in place until the new one is complete on disk
+
+	int file = open(journal.temporary_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	if (file < 0) {
+		return 0;
+	}
+
+	int written = file_write(file, buffer->data, buffer->size) && fsync(file) == 0;
+
+	close(file);
+
+	return written && rename(journal.temporary_path, journal.snapshot_path) == 0 && directory_sync(journal.snapshot_path);
+}
+
+int handle_encode(struct JournalBuffer *buffer, struct LambdaHandle lambda)
+{
+	// Returns 0 if a variable refers to a name the handle doesn't own
+
+	uint32_t free_variables_size = (uint32_t)lambda.free_variables_size;
+
+	identifier_encode(buffer, &lambda.identifier);
+	buffer_write(buffer, &free_variables_size, sizeof(free_variables_size));
+
+	for (size_t i = 0; i < lambda.free_variables_size; i++) {
+		identifier_encode(buffer, &lambda.free_variables[i]);
+	}
+
+	return term_encode(buffer, lambda.term, lambda, NULL);
+}
+
+int term_encode(struct JournalBuffer *buffer, const struct LambdaTerm *term, struct LambdaHandle lambda, const struct JournalScope *scope)
+{
+	unsigned char tag = (unsigned char)term->type;
+
+	buffer_write(buffer, &tag, sizeof(tag));
+
+	switch (term->type) {
+	case CHURCH_NUMERAL:
+		buffer_write(buffer, &term->expression.church_numeral, sizeof(term->expression.church_numeral));
+		return 1;
+
+	case BOUND_VARIABLE: {
+		// Variables share the name string of their binder
+
+		uint32_t index = 0;
+
+		for (; scope != NULL; scope = scope->next, index++) {
+			if (scope->binder->name == term->expression.variable.name) {
+				buffer_write(buffer, &index, sizeof(index));
+				return 1;
+			}
+		}
+
+		return 0;
+	}
+
+	case FREE_VARIABLE:
+		for (uint32_t index = 0; index < lambda.free_variables_size; index++) {
+			if (lambda.free_variables[index].name == term->expression.variable.name) {
+				buffer_write(buffer, &index, sizeof(index));
+				return 1;
+			}
+		}
+
+		return 0;
+
+	case ABSTRACTION: {
+		struct JournalScope inner = {&term->expression.abstraction.bound_variable, scope};
+
+		identifier_encode(buffer, &term->expression.abstraction.bound_variable);
+
+		return term_encode(buffer, term->expression.abstraction.body, lambda, &inner);
+	}
+
+	case APPLICATION:
+		return term_encode(buffer, term->expression.application.function, lambda, scope) &&
+			term_encode(buffer, term->expression.application.argument, lambda, scope);
+
+	default:
+		return 0;
+	}
+}
+
+void identifier_encode(struct JournalBuffer *buffer, const struct Identifier *identifier)
+{
+	// Names are never empty, so a length of 0 stands for no name
+
+	uint32_t length = identifier->name == NULL ? 0 : (uint32_t)strlen(identifier->name);
+	int32_t subscript = identifier->subscript;
+
+	buffer_write(buffer, &length, sizeof(length));
+	buffer_write(buffer, identifier->name, length);
+	buffer_write(buffer, &subscript, sizeof(subscript));
+}
+
+int handle_decode(struct JournalReader *reader, struct LambdaHandle *lambda)
+{
+	// Upon failure, lambda is left empty with nothing allocated
+
+	*lambda = (struct LambdaHandle){0};
+
+	uint32_t free_variables_size;
+
+	if (!identifier_decode(reader, &lambda->identifier)) {
+		return 0;
+	}
+
+	// Every free variable takes at least its length and subscript
+
+	if (!reader_read(reader, &free_variables_size, sizeof(free_variables_size)) ||
+		free_variables_size > (reader->size - reader->position) / (sizeof(uint32_t) + sizeof(int32_t))) {
+		goto failure;
+	}
+
+	if (free_variables_size != 0) {
+		lambda->free_variables = malloc(sizeof(*lambda->free_variables) * free_variables_size);
+
+		if (lambda->free_variables == NULL) {
+			goto fatal_error;
+		}
+
+		lambda->free_variables_capacity = free_variables_size;
+	}
+
+	for (uint32_t i = 0; i < free_variables_size; i++) {
+		if (!identifier_decode(reader, &lambda->free_variables[i])) {
+			goto failure;
+		}
+
+		lambda->free_variables_size++;
+	}
+
+	lambda->term = term_decode(reader, lambda, NULL);
+
+	if (lambda->term == NULL) {
+		goto failure;
+	}
+
+	return 1;
+
+	failure:
+
+	// Without a term, lambda_free() would keep the names
+
+	free(lambda->identifier.name);
+
+	for (size_t i = 0; i < lambda->free_variables_size; i++) {
+		free(lambda->free_variables[i].name);
+	}
+
+	free(lambda->free_variables);
+
+	*lambda = (struct LambdaHandle){0};
+
+	return 0;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function handle_decode().\n");
+	exit(1);
+}
+
+struct LambdaTerm *term_decode(struct JournalReader *reader, struct LambdaHandle *lambda, const struct JournalScope *scope)
+{
+	// Returns NULL once the input is malformed, after releasing whatever was decoded of the term
+
+	unsigned char tag;
+
+	if (!reader_read(reader, &tag, sizeof(tag))) {
+		return NULL;
+	}
+
+	if (tag != CHURCH_NUMERAL && tag != BOUND_VARIABLE && tag != FREE_VARIABLE && tag != ABSTRACTION && tag != APPLICATION) {
+		return NULL;
+	}
+
+	struct LambdaTerm *term = malloc(sizeof(*term));
+
+	if (term == NULL) {
+		goto fatal_error;
+	}
+
+	term->type = tag;
+
+	uint32_t index;
+
+	switch (term->type) {
+	case CHURCH_NUMERAL:
+		if (!reader_read(reader, &term->expression.church_numeral, sizeof(term->expression.church_numeral))) {
+			break;
+		}
+
+		return term;
+
+	case BOUND_VARIABLE:
+		if (!reader_read(reader, &index, sizeof(index))) {
+			break;
+		}
+
+		for (; scope != NULL && index != 0; scope = scope->next, index--);
+
+		if (scope == NULL) {
+			break;
+		}
+
+		term->expression.variable = *scope->binder;
+
+		return term;
+
+	case FREE_VARIABLE:
+		if (!reader_read(reader, &index, sizeof(index)) || index >= lambda->free_variables_size) {
+			break;
+		}
+
+		term->expression.variable = lambda->free_variables[index];
+
+		return term;
+
+	case ABSTRACTION: {
+		struct JournalScope inner = {&term->expression.abstraction.bound_variable, scope};
+
+		if (!identifier_decode(reader, &term->expression.abstraction.bound_variable)) {
+			break;
+		}
+
+		term->expression.abstraction.body = term_decode(reader, lambda, &inner);
+
+		if (term->expression.abstraction.body == NULL) {
+			free(term->expression.abstraction.bound_variable.name);
+			break;
+		}
+
+		return term;
+	}
+
+	case APPLICATION:
+		term->expression.application.function = term_decode(reader, lambda, scope);
+
+		if (term->expression.application.function == NULL) {
+			break;
+		}
+
+		term->expression.application.argument = term_decode(reader, lambda, scope);
+
+		if (term->expression.application.argument == NULL) {
+			lambda_free((struct LambdaHandle){.term = term->expression.application.function});
+			break;
+		}
+
+		return term;
+
+	default:
+		break;
+	}
+
+	free(term);
+
+	return NULL;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function term_decode().\n");
+	exit(1);
+}
+
+int identifier_decode(struct JournalReader *reader, struct Identifier *identifier)
+{
+	uint32_t length;
+	int32_t subscript;
+
+	identifier->name = NULL;
+
+	if (!reader_read(reader, &length, sizeof(length)) || length > reader->size - reader->position) {
+		return 0;
+	}
+
+	if (length != 0) {
+		identifier->name = malloc(length + 1);
+
+		if (identifier->name == NULL) {
+			goto fatal_error;
+		}
+
+		reader_read(reader, identifier->name, length);
+		identifier->name[length] = '\0';
+	}
+
+	if (!reader_read(reader, &subscript, sizeof(subscript))) {
+		free(identifier->name);
+		identifier->name = NULL;
+
+		return 0;
+	}
+
+	identifier->subscript = subscript;
+
+	return 1;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function identifier_decode().\n");
+	exit(1);
+}
+
+int reader_read(struct JournalReader *reader, void *data, size_t size)
+{
+	if (size > reader->size - reader->position) {
+		return 0;
+	}
+
+	memcpy(data, reader->data + reader->position, size);
+
+	reader->position += size;
+
+	return 1;
+}
+
+void buffer_write(struct JournalBuffer *buffer, const void *data, size_t size)
+{
+	if (buffer->capacity - buffer->size < size) {
+		// Scaling factor of 2
+
+		size_t capacity = buffer->capacity == 0 ? INITIAL_CAPACITY : buffer->capacity;
+
+		while (capacity - buffer->size < size) {
+			capacity <<= 1;
+		}
+
+		buffer->data = realloc(buffer->data, capacity);
+		buffer->capacity = capacity;
+
+		if (buffer->data == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	if (size != 0) {
+		memcpy(buffer->data + buffer->size, data, size);
+	}
+
+	buffer->size += size;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function buffer_write().\n");
+	exit(1);
+}
+
+int file_write(int file, const void *data, size_t size)
+{
+	const unsigned char *bytes = data;
+
+	while (size > 0) {
+		ssize_t written = write(file, bytes, size);
+
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (written <= 0) {
+			return 0;
+		}
+
+		bytes += written;
+		size -= (size_t)written;
+	}
+
+	return 1;
+}
+
+int directory_sync(const char *path)
+{
+	// A rename only lasts once the directory holding it is synced
+
+	const char *slash = strrchr(path, '/');
+	char *directory = slash == NULL ? path_join(".", "") : strndup(path, slash == path ? 1 : (size_t)(slash - path));
+
+	if (directory == NULL) {
+		return 0;
+	}
+
+	int file = open(directory, O_RDONLY | O_DIRECTORY);
+
+	free(directory);
+
+	if (file < 0) {
+		return 0;
+	}
+
+	int synced = fsync(file) == 0;
+
+	close(file);
+
+	return synced;
+}
+
+char *path_join(const char *path, const char *suffix)
+{
+	size_t path_length = strlen(path);
+	size_t suffix_length = strlen(suffix);
+
+	char *joined = malloc(path_length + suffix_length + 1);
+
+	if (joined == NULL) {
+		goto fatal_error;
+	}
+
+	memcpy(joined, path, path_length);
+	memcpy(joined + path_length, suffix, suffix_length + 1);
+
+	return joined;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function path_join().\n");
+	exit(1);
+}
+
+uint64_t checksum(const unsigned char *data, size_t size)
+{
+	// FNV-1a
+
+	uint64_t hash = FNV_OFFSET;
+
+	for (size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+#else
+
+int journal_open(const char *path, struct HashMap *hashmap, size_t *count)
+{
+	(void)path;
+	(void)hashmap;
+	(void)count;
+
+	printf("ERROR: sessions are only supported on Linux.\n");
+
+	return 0;
+}
+
+void journal_close(const struct HashMap *hashmap)
+{
+	(void)hashmap;
+}
+
+int journal_append(const struct HashMap *hashmap, struct LambdaHandle lambda)
+{
+	(void)hashmap;
+	(void)lambda;
+
+	return 1;
+}
+
+void journal_compact(const struct HashMap *hashmap)
+{
+	(void)hashmap;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <hashmap.h>
+
+// Session persistence
+// Every definition the REPL stores is appended to a journal, encoded as a pointer free term so that replaying it needs
+// no parsing. Appending only copies the record into a buffer: a journal thread writes whatever has accumulated and
+// syncs it in one go, so a burst of definitions costs a single fdatasync() and none of them on the calling thread.
+// Once the journal holds JOURNAL_COMPACTION_RECORDS records, the whole hashmap is written to a snapshot along with the
+// optimized form and normal form fingerprint of each definition, and the journal starts over. The journal thread
+// encodes the snapshot as well, reading the hashmap while the REPL goes on storing definitions. Restoring maps the
+// snapshot and stores its definitions as they were, without optimizing or evaluating anything, then replays the few
+// records of the journal written since, so restarting costs no more than copying the definitions however long the
+// session ran.
+// The snapshot is written to a temporary file renamed over the previous one, and both files carry the epoch of the
+// snapshot they follow: a journal older than the snapshot is dropped, and a journal cut short by a crash is replayed up
+// to its last complete record. Files use the byte order of the machine that wrote them.
+// There is a single session per process. Elsewhere than on Linux, sessions aren't supported.
+
+#define JOURNAL_COMPACTION_RECORDS 1024	// Records appended since the last snapshot which trigger the next one
+
+int journal_open(const char *path, struct HashMap *hashmap, size_t *count);	// Restore the session saved under path into hashmap, counting its definitions in count, and start journaling. Returns 0 upon failure
+void journal_close(const struct HashMap *hashmap);				// Snapshot hashmap, wait until everything is written and stop journaling
+
+int journal_append(const struct HashMap *hashmap, struct LambdaHandle lambda);	// Record a definition just stored in hashmap, compacting once the journal is long. Returns 0 if it can't be encoded. Does nothing without a session
+void journal_compact(const struct HashMap *hashmap);				// Have every definition of hashmap snapshotted and the journal started over, without waiting. Does nothing without a session
\ No newline at end of file
@@ -5,6 +5,13 @@
 #define LAMBDA_CHARACTER 'λ'
 #define NO_SUBSCRIPT -1
 
+// Token runs are classified 16 bytes at a time with SSE2 where available, byte by byte otherwise
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#define LEXER_SSE2
+#include <emmintrin.h>
+#endif
+
 // lambda_is_valid and lambda_parse subroutines
 
 static void print_error_at(const char *error, const char *str, int position);
@@ -755,11 +762,9 @@ struct LambdaTerm *variable_parse(
 		}
 
 		if (strcmp(variable.name, free_variable->name) == 0) {
-			// Found a matching bound variable
+			// Found a matching free variable
 			// Free the string allocated in variable.name
 
-			type = BOUND_VARIABLE;
-
 			free(variable.name);
 
 			variable.name = free_variable->name;
@@ -777,7 +782,7 @@ struct LambdaTerm *variable_parse(
 	if (*free_variables_capacity == *free_variables_size) {
 		*free_variables_capacity <<= 1;
 
-		*free_variables = realloc(*free_variables, *free_variables_capacity);
+		*free_variables = realloc(*free_variables, sizeof(**free_variables) * *free_variables_capacity);
 	}
 
 	(*free_variables)[(*free_variables_size)++] = variable;
@@ -844,14 +849,52 @@ struct LambdaTerm *abstraction_parse(
 
 const char *skip_whitespace(const char *str, const char *end)
 {
-	while ((*str == ' ') && (end > str))
+	// Spaces and tabs separate tokens
+
+#ifdef LEXER_SSE2
+	while (end - str >= 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i *)str);
+
+		__m128i spaces = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+		__m128i tabs = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'));
+
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(spaces, tabs));
+
+		if (mask != 0XFFFF) {
+			return str + __builtin_ctz(~mask);
+		}
+
+		str += 16;
+	}
+#endif
+
+	while (end > str && (*str == ' ' || *str == '\t'))
 		str++;
 
 	return str;
 }
 const char *skip_name(const char *str, const char *end)
 {
-	while (char_is_name(*str) && (end > str)) {
+#ifdef LEXER_SSE2
+	while (end - str >= 16) {
+		// Setting the case bit folds uppercase letters onto lowercase ones, bytes of λ compare as negative
+
+		__m128i bytes = _mm_or_si128(_mm_loadu_si128((const __m128i *)str), _mm_set1_epi8(0X20));
+
+		__m128i above = _mm_cmpgt_epi8(bytes, _mm_set1_epi8('a' - 1));
+		__m128i below = _mm_cmplt_epi8(bytes, _mm_set1_epi8('z' + 1));
+
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(above, below));
+
+		if (mask != 0XFFFF) {
+			return str + __builtin_ctz(~mask);
+		}
+
+		str += 16;
+	}
+#endif
+
+	while (end > str && char_is_name(*str)) {
 		str++;
 	}
 
@@ -859,7 +902,24 @@ const char *skip_name(const char *str, const char *end)
 }
 const char *skip_digits(const char *str, const char *end)
 {
-	while (char_is_digit(*str) && (end > str)) {
+#ifdef LEXER_SSE2
+	while (end - str >= 16) {
+		__m128i bytes = _mm_loadu_si128((const __m128i *)str);
+
+		__m128i above = _mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1));
+		__m128i below = _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1));
+
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(above, below));
+
+		if (mask != 0XFFFF) {
+			return str + __builtin_ctz(~mask);
+		}
+
+		str += 16;
+	}
+#endif
+
+	while (end > str && char_is_digit(*str)) {
 		str++;
 	}
 
@@ -868,42 +928,23 @@ const char *skip_digits(const char *str, const char *end)
 
 int char_is_valid(char c)
 {
-	const char *table = "λ\\.()=0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+	// Both bytes of λ are accepted here, the parser checks that they come as a pair
 
-	const char *it = table;
+	const char *lambda = "λ";
 
-	while (*it != '\0') {
-		if (*it++ == c)
-			return 1;
+	if (char_is_name(c) || char_is_digit(c)) {
+		return 1;
 	}
 
-	return 0;
+	return c == '\\' || c == '.' || c == '(' || c == ')' || c == '=' || c == lambda[0] || c == lambda[1];
 }
 int char_is_name(char c)
 {
-	const char *table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-
-	const char *it = table;
-
-	while (*it != '\0') {
-		if (*it++ == c)
-			return 1;
-	}
-
-	return 0;
+	return (unsigned int)(((unsigned char)c | 0X20) - 'a') < 26;
 }
 int char_is_digit(char c)
 {
-	const char *table = "0123456789";
-
-	const char *it = table;
-
-	while (*it != '\0') {
-		if (*it++ == c)
-			return 1;
-	}
-
-	return 0;
+	return (unsigned int)((unsigned char)c - '0') < 10;
 }
 
 void print_error_at(const char *error, const char *str, int position)
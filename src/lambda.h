@@ -40,6 +40,7 @@ struct LambdaTerm {
 
 // free_variables_array is an array of all terms which aren't bound by an abstraction
 // Church numerals aren't stored in free_variables_array
+// Variable terms share the name string of the abstraction or free_variables entry they refer to, which owns it
 
 struct LambdaHandle {
 	struct LambdaTerm *term;
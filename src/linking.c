@@ -0,0 +1,224 @@
+#include <linking.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+static struct Linkage *linkage_get(struct Linker *linker, struct LambdaHandle definition, int *created);
+static void linker_scale(struct Linker *linker);
+static size_t term_hash(const struct LambdaTerm *term);
+
+struct Linker linker_create(struct Arena *arena)
+{
+	struct Linker linker;
+
+	linker.arena = arena;
+	linker.size = 0;
+	linker.original = 0;
+	linker.capacity = INITIAL_CAPACITY;
+	linker.linkages = calloc(linker.capacity, sizeof(*linker.linkages));
+
+	if (linker.linkages == NULL) {
+		goto fatal_error;
+	}
+
+	return linker;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function linker_create().\n");
+	exit(1);
+}
+
+void linker_destroy(struct Linker linker)
+{
+	free(linker.linkages);
+}
+
+struct Linkage *linker_link(struct Linker *linker, struct LambdaHandle lambda, const struct HashMap *definitions)
+{
+	// Worklist over every definition transitively reachable from lambda
+	// This is the only place where the definitions are looked up
+
+	int created;
+
+	struct Linkage *root = linkage_get(linker, lambda, &created);
+
+	if (!created) {
+		return root;
+	}
+
+	struct Linkage **worklist;
+
+	size_t worklist_size = 0;
+	size_t worklist_capacity = INITIAL_CAPACITY;
+
+	worklist = malloc(sizeof(*worklist) * worklist_capacity);
+
+	if (worklist == NULL) {
+		goto fatal_error;
+	}
+
+	worklist[worklist_size++] = root;
+
+	while (worklist_size > 0) {
+		struct Linkage *linkage = worklist[--worklist_size];
+
+		size_t size = linkage->definition.free_variables_size;
+
+		linkage->targets = arena_alloc(linker->arena, sizeof(*linkage->targets) * (size + 1));
+
+		for (size_t i = 0; i < size; i++) {
+			struct LambdaHandle definition = {0};
+
+			if (definitions != NULL) {
+				definition = linker->original ?
+					hashmap_get_original(definitions, linkage->definition.free_variables[i]) :
+					hashmap_get(definitions, linkage->definition.free_variables[i]);
+			}
+
+			if (definition.term == NULL) {
+				linkage->targets[i] = NULL;
+				continue;
+			}
+
+			linkage->targets[i] = linkage_get(linker, definition, &created);
+
+			if (!created) {
+				continue;
+			}
+
+			if (worklist_size == worklist_capacity) {
+				worklist_capacity <<= 1;
+
+				worklist = realloc(worklist, sizeof(*worklist) * worklist_capacity);
+
+				if (worklist == NULL) {
+					goto fatal_error;
+				}
+			}
+
+			worklist[worklist_size++] = linkage->targets[i];
+		}
+	}
+
+	free(worklist);
+
+	return root;
+
+	fatal_error:
+
+	printf("Fatal error: memory allocation failed in function linker_link().\n");
+	exit(1);
+}
+
+struct Linkage *linkage_target(const struct Linkage *linkage, const struct Identifier *variable, const struct Identifier **free_variable)
+{
+	// Free variable terms share the name string of their free_variables entry, so the string comparison is only a
+	// fallback. free_variable is set to the matching entry, or to variable itself.
+
+	*free_variable = variable;
+
+	for (size_t i = 0; i < linkage->definition.free_variables_size; i++) {
+		const struct Identifier *entry = linkage->definition.free_variables + i;
+
+		if (entry->subscript != variable->subscript) {
+			continue;
+		}
+
+		if (entry->name != variable->name && strcmp(entry->name, variable->name) != 0) {
+			continue;
+		}
+
+		*free_variable = entry;
+
+		return linkage->targets == NULL ? NULL : linkage->targets[i];
+	}
+
+	return NULL;
+}
+
+struct Linkage *linkage_get(struct Linker *linker, struct LambdaHandle definition, int *created)
+{
+	// Finds the linkage of a definition or creates it
+	// Linear probing on the address of the definition term
+
+	size_t mask = linker->capacity - 1;
+	size_t index = term_hash(definition.term) & mask;
+
+	while (linker->linkages[index] != NULL) {
+		if (linker->linkages[index]->definition.term == definition.term) {
+			*created = 0;
+
+			return linker->linkages[index];
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	struct Linkage *linkage = arena_alloc(linker->arena, sizeof(*linkage));
+
+	memset(linkage, 0, sizeof(*linkage));
+
+	linkage->definition = definition;
+
+	linker->linkages[index] = linkage;
+	linker->size++;
+
+	*created = 1;
+
+	// Scaling at half capacity
+
+	if (linker->size << 1 > linker->capacity) {
+		linker_scale(linker);
+	}
+
+	return linkage;
+}
+
+void linker_scale(struct Linker *linker)
+{
+	size_t capacity = linker->capacity << 1;
+
+	struct Linkage **linkages = calloc(capacity, sizeof(*linkages));
+
+	if (linkages == NULL) {
+		goto fatal_error;
+	}
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		struct Linkage *entry = linker->linkages[i];
+
+		if (entry == NULL) {
+			continue;
+		}
+
+		size_t index = term_hash(entry->definition.term) & (capacity - 1);
+
+		while (linkages[index] != NULL) {
+			index = (index + 1) & (capacity - 1);
+		}
+
+		linkages[index] = entry;
+	}
+
+	free(linker->linkages);
+
+	linker->linkages = linkages;
+	linker->capacity = capacity;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function linker_scale().\n");
+	exit(1);
+}
+
+size_t term_hash(const struct LambdaTerm *term)
+{
+	// Fibonacci hashing of the address
+
+	return (size_t)(((uintptr_t)term >> 4) * 11400714819323198485ULL);
+}
\ No newline at end of file
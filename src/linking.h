@@ -0,0 +1,64 @@
+#pragma once
+
+#include <arena.h>
+#include <hashmap.h>
+#include <lambda.h>
+
+// Ahead of time resolution of definitions
+// A linkage is a definition resolved before evaluation: targets[i] is the linkage named by definition.free_variables[i],
+// or NULL when no such definition exists.
+// Linking is transitive, so the evaluators never look a definition up once reduction has started.
+// Every backend keeps its own per definition state in the linkage.
+
+struct Node;
+struct CombinatorNode;
+struct SigmaNode;
+
+struct Linkage {
+	struct LambdaHandle definition;		// Shallow copy of the stored handle
+	struct Linkage **targets;
+
+	// Graph evaluator state
+
+	struct Node *reference;			// The single reference node shared by every occurrence of the definition
+	struct Node *unfolded;			// The compiled definition, or NULL until it first reaches the head position
+
+	// Combinator backend state
+
+	struct CombinatorNode *combinator;	// The single reference node of the combinator graph
+
+	// Explicit substitution backend state
+
+	struct SigmaNode *sigma;		// The single reference node of the explicit substitution graph
+
+	// Profiling counters of the graph evaluator
+
+	struct Linkage *caller;			// Definition whose code first unfolded this one, NULL for the evaluated term
+	size_t beta_steps;			// Beta reductions of abstractions compiled from the definition
+	size_t allocations;			// Nodes allocated while compiling or instantiating the definition
+
+	// Definition-time optimizer state
+
+	int inlining;				// 1 if applied occurrences are replaced by the definition, -1 if not, 0 until decided
+	const struct Linkage *searched;		// Definition whose recursion search reached this one last
+};
+
+// Open addressing table of linkages keyed by definition term
+// Linkages are allocated in the arena passed to linker_create()
+
+struct Linker {
+	struct Arena *arena;
+
+	struct Linkage **linkages;
+	size_t size;
+	size_t capacity;
+
+	int original;		// Definitions are linked as written, without the rewrites of the optimizer
+};
+
+struct Linker linker_create(struct Arena *arena);	// Create an empty linker allocating its linkages in arena
+void linker_destroy(struct Linker linker);		// Release the table; the linkages go away with the arena
+
+struct Linkage *linker_link(struct Linker *linker, struct LambdaHandle lambda, const struct HashMap *definitions);	// Link lambda and every definition it reaches
+
+struct Linkage *linkage_target(const struct Linkage *linkage, const struct Identifier *variable, const struct Identifier **free_variable);	// Resolve a free variable term. Returns NULL for undefined names
\ No newline at end of file
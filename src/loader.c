@@ -0,0 +1,579 @@
+#include <loader.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <pthread.h>
+#include <unistd.h>
+#include <worker.h>
+
+#endif
+
+#define INITIAL_CAPACITY 1024
+
+#define FNV_OFFSET 14695981039346656037UL
+#define FNV_PRIME 1099511628211UL
+
+// A slice of the lines of a file parsed by one thread, or of the definitions it optimizes or fingerprints
+
+struct LoaderSlice {
+	char **lines;
+	size_t *lengths;
+	struct LambdaHandle *lambdas;	// Parsed definitions by line, an empty handle for skipped lines
+
+	const struct HashMap *hashmap;
+	const size_t *order;		// Lines of the definitions to optimize or fingerprint
+	struct LambdaHandle *optimized;	// Results, by position in order
+	uint64_t *fingerprints;
+
+	size_t begin;
+	size_t end;
+};
+
+// Position of a definition on the stack of the ordering search
+
+struct LoaderFrame {
+	size_t rank;	// Among the definitions, in file order
+	size_t edge;	// Next free variable to follow
+};
+
+static char *file_read(const char *path, size_t *size);
+static size_t threads_count(size_t size);
+static void slices_run(const struct LoaderSlice *slice, void *(*routine)(void *));
+
+static void *slice_parse(void *argument);
+static void *slice_optimize(void *argument);
+static void *slice_fingerprint(void *argument);
+
+static size_t *levels_sort(const struct LambdaHandle *lambdas, const size_t *definitions, size_t size, const size_t *names, size_t names_capacity, size_t **bounds, size_t *levels_size);
+static size_t name_slot(const size_t *names, size_t names_capacity, const struct LambdaHandle *lambdas, struct Identifier identifier);
+static uint64_t name_hash(struct Identifier identifier);
+
+int definitions_load(struct HashMap *hashmap, const char *path, size_t *count)
+{
+	size_t size;
+
+	char *buffer = file_read(path, &size);
+
+	if (buffer == NULL) {
+		printf("ERROR: could not open %s.\n", path);
+		return 0;
+	}
+
+	// Splitting the buffer into lines in place
+
+	size_t lines_size = 0;
+	size_t lines_capacity = INITIAL_CAPACITY;
+
+	char **lines = malloc(sizeof(*lines) * lines_capacity);
+	size_t *lengths = malloc(sizeof(*lengths) * lines_capacity);
+
+	if (lines == NULL || lengths == NULL) {
+		goto fatal_error;
+	}
+
+	for (char *line = buffer; line < buffer + size;) {
+		char *newline = memchr(line, '\n', buffer + size - line);
+
+		if (newline == NULL) {
+			newline = buffer + size;
+		}
+
+		*newline = '\0';
+
+		if (lines_size == lines_capacity) {
+			// Scaling factor of 2
+
+			lines_capacity <<= 1;
+
+			lines = realloc(lines, sizeof(*lines) * lines_capacity);
+			lengths = realloc(lengths, sizeof(*lengths) * lines_capacity);
+
+			if (lines == NULL || lengths == NULL) {
+				goto fatal_error;
+			}
+		}
+
+		lines[lines_size] = line;
+		lengths[lines_size] = strcspn(line, "\r");
+		line[lengths[lines_size]] = '\0';
+
+		lines_size++;
+
+		line = newline + 1;
+	}
+
+	struct LambdaHandle *lambdas = calloc(lines_size + 1, sizeof(*lambdas));
+
+	if (lambdas == NULL) {
+		goto fatal_error;
+	}
+
+	// Parsing every slice, on threads of their own when it pays off
+
+	struct LoaderSlice slice = {
+		.lines = lines,
+		.lengths = lengths,
+		.lambdas = lambdas,
+		.hashmap = hashmap,
+		.begin = 0,
+		.end = lines_size
+	};
+
+	slices_run(&slice, slice_parse);
+
+	// Only the last definition of each name is stored, so lines are gone through from the end of the file, the names
+	// met so far being kept in an open addressing table of lines plus one
+
+	size_t stored = 0;
+
+	size_t names_capacity = INITIAL_CAPACITY;
+
+	while (names_capacity < lines_size << 1) {
+		names_capacity <<= 1;
+	}
+
+	size_t *names = calloc(names_capacity, sizeof(*names));
+
+	if (names == NULL) {
+		goto fatal_error;
+	}
+
+	for (size_t i = lines_size; i-- > 0;) {
+		if (lambdas[i].term == NULL) {
+			continue;
+		}
+
+		stored++;
+
+		size_t slot = name_slot(names, names_capacity, lambdas, lambdas[i].identifier);
+
+		if (names[slot] != 0) {
+			lambda_free(lambdas[i]);
+
+			lambdas[i] = (struct LambdaHandle){0};
+
+			continue;
+		}
+
+		names[slot] = i + 1;
+	}
+
+	// Storing them as written in file order, so that every one of them can be linked against the others
+
+	size_t definitions_size = 0;
+
+	size_t *definitions = malloc(sizeof(*definitions) * (stored + 1));
+	struct Identifier *identifiers = malloc(sizeof(*identifiers) * (stored + 1));
+
+	if (definitions == NULL || identifiers == NULL) {
+		goto fatal_error;
+	}
+
+	for (size_t i = 0; i < lines_size; i++) {
+		if (lambdas[i].term == NULL) {
+			continue;
+		}
+
+		hashmap_restore(hashmap, lambdas[i], (struct LambdaHandle){0}, 0);
+
+		identifiers[definitions_size] = lambdas[i].identifier;
+		definitions[definitions_size++] = i;
+	}
+
+	// Optimizing them level by level in parallel, where a level only uses the definitions of the levels before it,
+	// then fingerprinting all of them in parallel. Nothing writes the hashmap while threads read it.
+
+	struct LambdaHandle *optimized = calloc(definitions_size + 1, sizeof(*optimized));
+	uint64_t *fingerprints = calloc(definitions_size + 1, sizeof(*fingerprints));
+
+	if (optimized == NULL || fingerprints == NULL) {
+		goto fatal_error;
+	}
+
+	slice.optimized = optimized;
+	slice.fingerprints = fingerprints;
+
+	if (hashmap->optimize != NULL) {
+		size_t *bounds;
+		size_t levels_size;
+
+		size_t *order = levels_sort(lambdas, definitions, definitions_size, names, names_capacity, &bounds, &levels_size);
+
+		slice.order = order;
+
+		for (size_t level = 0; level < levels_size; level++) {
+			slice.begin = bounds[level];
+			slice.end = bounds[level + 1];
+
+			slices_run(&slice, slice_optimize);
+
+			for (size_t i = slice.begin; i < slice.end; i++) {
+				if (optimized[i].term != NULL) {
+					hashmap_update(hashmap, lambdas[order[i]].identifier, optimized[i], 0);
+				}
+			}
+		}
+
+		free(order);
+		free(bounds);
+	}
+
+	if (hashmap->fingerprint != NULL) {
+		slice.order = definitions;
+		slice.begin = 0;
+		slice.end = definitions_size;
+
+		slices_run(&slice, slice_fingerprint);
+
+		for (size_t i = 0; i < definitions_size; i++) {
+			if (fingerprints[i] != 0) {
+				hashmap_update(hashmap, identifiers[i], (struct LambdaHandle){0}, fingerprints[i]);
+			}
+		}
+	}
+
+	// Definitions stored before may have inlined what the file overwrote
+
+	hashmap_refresh(hashmap, identifiers, definitions_size);
+
+	if (count != NULL) {
+		*count = stored;
+	}
+
+	free(fingerprints);
+	free(optimized);
+	free(identifiers);
+	free(definitions);
+	free(names);
+	free(lambdas);
+	free(lengths);
+	free(lines);
+	free(buffer);
+
+	return 1;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function definitions_load().\n");
+	exit(1);
+}
+
+void *slice_parse(void *argument)
+{
+	struct LoaderSlice *slice = argument;
+
+	for (size_t i = slice->begin; i < slice->end; i++) {
+		const char *line = slice->lines[i];
+
+		if (slice->lengths[i] == 0 || line[0] == '#') {
+			continue;
+		}
+
+		struct LambdaHandle lambda = lambda_parse(line, slice->lengths[i] + 1);
+
+		if (lambda.term == NULL) {
+			continue;
+		}
+
+		if (lambda.identifier.name == NULL) {
+			lambda_free(lambda);
+		} else {
+			slice->lambdas[i] = lambda;
+		}
+	}
+
+	return NULL;
+}
+
+void *slice_optimize(void *argument)
+{
+	struct LoaderSlice *slice = argument;
+
+	for (size_t i = slice->begin; i < slice->end; i++) {
+		slice->optimized[i] = slice->hashmap->optimize(slice->hashmap, slice->lambdas[slice->order[i]]);
+	}
+
+	return NULL;
+}
+
+void *slice_fingerprint(void *argument)
+{
+	// Normal forms are computed from the optimized definitions, as hashmap_set() does
+
+	struct LoaderSlice *slice = argument;
+
+	for (size_t i = slice->begin; i < slice->end; i++) {
+		struct Identifier identifier = slice->lambdas[slice->order[i]].identifier;
+
+		if (!slice->hashmap->fingerprint(slice->hashmap, hashmap_get(slice->hashmap, identifier), &slice->fingerprints[i])) {
+			slice->fingerprints[i] = 0;
+		}
+	}
+
+	return NULL;
+}
+
+void slices_run(const struct LoaderSlice *slice, void *(*routine)(void *))
+{
+	// Splits the range of slice into contiguous slices, run on threads of their own when it pays off
+
+	size_t size = slice->end - slice->begin;
+	size_t threads_size = threads_count(size);
+
+	struct LoaderSlice slices[LOADER_MAX_THREADS];
+
+	for (size_t i = 0; i < threads_size; i++) {
+		slices[i] = *slice;
+		slices[i].begin = slice->begin + size * i / threads_size;
+		slices[i].end = slice->begin + size * (i + 1) / threads_size;
+	}
+
+#ifdef __linux__
+	// Optimizing and fingerprinting evaluate definitions, which needs as much stack as the worker has
+
+	pthread_t threads[LOADER_MAX_THREADS];
+	int started[LOADER_MAX_THREADS] = {0};
+
+	pthread_attr_t attributes;
+
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, WORKER_STACK_SIZE);
+
+	for (size_t i = 1; i < threads_size; i++) {
+		started[i] = pthread_create(&threads[i], &attributes, routine, &slices[i]) == 0;
+	}
+
+	pthread_attr_destroy(&attributes);
+
+	routine(&slices[0]);
+
+	for (size_t i = 1; i < threads_size; i++) {
+		if (started[i]) {
+			pthread_join(threads[i], NULL);
+		} else {
+			routine(&slices[i]);
+		}
+	}
+#else
+	for (size_t i = 0; i < threads_size; i++) {
+		routine(&slices[i]);
+	}
+#endif
+}
+
+size_t *levels_sort(const struct LambdaHandle *lambdas, const size_t *definitions, size_t size, const size_t *names, size_t names_capacity, size_t **bounds, size_t *levels_size)
+{
+	// Orders the definitions by level, a definition coming one level after the highest of the ones of the file it
+	// uses, so that it inlines their optimized forms as when they are stored one by one. The levels are found by a
+	// depth first search with an explicit stack, and a use closing a cycle is not followed. The search starts from the
+	// end of the file, so that the earlier definitions of a cycle come last, as they are refreshed last one by one.
+	// bounds receives where each level starts, followed by size.
+
+	size_t *levels = calloc(size + 1, sizeof(*levels));
+	unsigned char *states = calloc(size + 1, 1);		// 0 unvisited, 1 on the stack, 2 done
+	struct LoaderFrame *frames = malloc(sizeof(*frames) * (size + 1));
+
+	if (levels == NULL || states == NULL || frames == NULL) {
+		goto fatal_error;
+	}
+
+	*levels_size = 0;
+
+	for (size_t root = size; root-- > 0;) {
+		if (states[root] != 0) {
+			continue;
+		}
+
+		size_t frames_size = 0;
+
+		frames[frames_size++] = (struct LoaderFrame){root, 0};
+		states[root] = 1;
+
+		while (frames_size > 0) {
+			struct LoaderFrame *frame = &frames[frames_size - 1];
+			const struct LambdaHandle *lambda = &lambdas[definitions[frame->rank]];
+
+			if (frame->edge == lambda->free_variables_size) {
+				states[frame->rank] = 2;
+
+				if (levels[frame->rank] + 1 > *levels_size) {
+					*levels_size = levels[frame->rank] + 1;
+				}
+
+				frames_size--;
+
+				continue;
+			}
+
+			size_t line = names[name_slot(names, names_capacity, lambdas, lambda->free_variables[frame->edge])];
+
+			if (line == 0 || line - 1 == definitions[frame->rank]) {
+				frame->edge++;
+
+				continue;
+			}
+
+			// The rank of the definition used, found back from its line
+
+			size_t low = 0;
+			size_t high = size;
+
+			while (low < high) {
+				size_t middle = low + (high - low) / 2;
+
+				if (definitions[middle] < line - 1) {
+					low = middle + 1;
+				} else {
+					high = middle;
+				}
+			}
+
+			if (states[low] == 0) {
+				states[low] = 1;
+				frames[frames_size++] = (struct LoaderFrame){low, 0};
+
+				continue;
+			}
+
+			if (states[low] == 2 && levels[low] + 1 > levels[frame->rank]) {
+				levels[frame->rank] = levels[low] + 1;
+			}
+
+			frame->edge++;
+		}
+	}
+
+	// Counting sort of the definitions by level, in file order within a level
+
+	*bounds = calloc(*levels_size + 2, sizeof(**bounds));
+
+	size_t *order = malloc(sizeof(*order) * (size + 1));
+
+	if (*bounds == NULL || order == NULL) {
+		goto fatal_error;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		(*bounds)[levels[i] + 2]++;
+	}
+
+	for (size_t level = 0; level < *levels_size; level++) {
+		(*bounds)[level + 2] += (*bounds)[level + 1];
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		order[(*bounds)[levels[i] + 1]++] = definitions[i];
+	}
+
+	free(frames);
+	free(states);
+	free(levels);
+
+	return order;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function levels_sort().\n");
+	exit(1);
+}
+
+size_t name_slot(const size_t *names, size_t names_capacity, const struct LambdaHandle *lambdas, struct Identifier identifier)
+{
+	// Returns the slot of the line defining identifier, or the empty slot it would take. names_capacity is a power of 2
+
+	size_t index = name_hash(identifier) & (names_capacity - 1);
+
+	while (names[index] != 0) {
+		struct Identifier name = lambdas[names[index] - 1].identifier;
+
+		if (name.subscript == identifier.subscript && strcmp(name.name, identifier.name) == 0) {
+			return index;
+		}
+
+		index = (index + 1) & (names_capacity - 1);
+	}
+
+	return index;
+}
+
+uint64_t name_hash(struct Identifier identifier)
+{
+	uint64_t hash = FNV_OFFSET;
+
+	for (const char *c = identifier.name; *c != '\0'; c++) {
+		hash ^= (uint64_t)(unsigned char)*c;
+		hash *= FNV_PRIME;
+	}
+
+	return 31 * hash + (uint64_t)identifier.subscript;
+}
+
+size_t threads_count(size_t size)
+{
+	size_t threads_size = size / LOADER_MIN_LINES;
+
+#ifdef __linux__
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (processors > 0 && threads_size > (size_t)processors) {
+		threads_size = (size_t)processors;
+	}
+#else
+	threads_size = 1;
+#endif
+
+	if (threads_size > LOADER_MAX_THREADS) {
+		threads_size = LOADER_MAX_THREADS;
+	}
+
+	return threads_size == 0 ? 1 : threads_size;
+}
+
+char *file_read(const char *path, size_t *size)
+{
+	// Reads a whole file into a buffer, in blocks since its size can't always be known up front
+
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL) {
+		return NULL;
+	}
+
+	size_t capacity = 1 << 16;
+	char *buffer = malloc(capacity);
+
+	if (buffer == NULL) {
+		goto fatal_error;
+	}
+
+	*size = 0;
+
+	while (1) {
+		*size += fread(buffer + *size, 1, capacity - *size, file);
+
+		if (*size < capacity) {
+			break;
+		}
+
+		// Scaling factor of 2
+
+		capacity <<= 1;
+		buffer = realloc(buffer, capacity);
+
+		if (buffer == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	fclose(file);
+
+	return buffer;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function file_read().\n");
+	exit(1);
+}
\ No newline at end of file
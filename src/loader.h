@@ -0,0 +1,15 @@
+#pragma once
+
+#include <hashmap.h>
+
+// Loading of definition files, one definition per line
+// Blank lines and lines starting with '#' are skipped, and so are expressions which aren't definitions.
+// Lines are parsed in parallel, split into contiguous slices across threads, and the last definition of each name is
+// stored as written, in file order. Their optimization follows in parallel, level by level, a definition being optimized
+// once the ones of the file it uses are, and their fingerprints in parallel as well. Only storing into the hashmap, and
+// refreshing the definitions already there which depend on the file, stays sequential.
+
+#define LOADER_MAX_THREADS 64
+#define LOADER_MIN_LINES 1024	// Smallest slice of lines, or of definitions, worth a thread of its own
+
+int definitions_load(struct HashMap *hashmap, const char *path, size_t *count);	// Store the definitions of a file, counting them in count unless NULL. Returns 0 upon failure
\ No newline at end of file
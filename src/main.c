@@ -1,26 +1,174 @@
+#include <blc.h>
+#include <combinators.h>
+#include <evaluation.h>
 #include <hashmap.h>
+#include <journal.h>
 #include <lambda.h>
+#include <loader.h>
+#include <native.h>
 #include <printing.h>
+#include <profiling.h>
+#include <reclaimer.h>
+#include <ctype.h>
+#include <server.h>
+#include <sigma.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+#include <typing.h>
+#include <worker.h>
 
 #define BUFFER_SIZE 65535
 
-int main()
+#define SHARED_PRINT_LIMIT 100000	// Nodes printed by :shared before truncating
+
+#define PROFILE_BETA_PATH "profile-beta.folded"
+#define PROFILE_ALLOCATIONS_PATH "profile-allocations.folded"
+
+// REPL commands are written as ":name argument"
+// Every handler returns 0 once the session should end
+
+struct Command {
+	const char *name;
+	const char *help;
+
+	int (*run)(struct HashMap *hashmap, char *argument, size_t size);
+};
+
+static int line_run(struct HashMap *hashmap, char *input, size_t size);
+static int session_open(struct HashMap *hashmap, char *path, size_t size);
+static int command_run(struct HashMap *hashmap, char *input);
+
+static int command_quit(struct HashMap *hashmap, char *argument, size_t size);
+static int command_help(struct HashMap *hashmap, char *argument, size_t size);
+static int command_whnf(struct HashMap *hashmap, char *argument, size_t size);
+static int command_hnf(struct HashMap *hashmap, char *argument, size_t size);
+static int command_nf(struct HashMap *hashmap, char *argument, size_t size);
+static int command_cbv(struct HashMap *hashmap, char *argument, size_t size);
+
+static int command_ski(struct HashMap *hashmap, char *argument, size_t size);
+static int command_sigma(struct HashMap *hashmap, char *argument, size_t size);
+static int command_bench(struct HashMap *hashmap, char *argument, size_t size);
+static int command_profile(struct HashMap *hashmap, char *argument, size_t size);
+static int command_shared(struct HashMap *hashmap, char *argument, size_t size);
+static int command_stream(struct HashMap *hashmap, char *argument, size_t size);
+static int command_load(struct HashMap *hashmap, char *argument, size_t size);
+static int command_show(struct HashMap *hashmap, char *argument, size_t size);
+static int command_eq(struct HashMap *hashmap, char *argument, size_t size);
+static int command_blc(struct HashMap *hashmap, char *argument, size_t size);
+static int command_blcload(struct HashMap *hashmap, char *argument, size_t size);
+static int command_blcsave(struct HashMap *hashmap, char *argument, size_t size);
+static int command_type(struct HashMap *hashmap, char *argument, size_t size);
+static int command_types(struct HashMap *hashmap, char *argument, size_t size);
+
+static const struct Command commands[] = {
+	{"q",		"Quit",								command_quit},
+	{"quit",	"Quit",								command_quit},
+	{"help",	"List the available commands",					command_help},
+	{"whnf",	"Reduce an expression to weak head normal form",		command_whnf},
+	{"hnf",		"Reduce an expression to head normal form",			command_hnf},
+	{"nf",		"Reduce an expression to normal form in normal order",		command_nf},
+	{"cbv",		"Reduce an expression to normal form in applicative order",	command_cbv},
+	{"ski",		"Reduce an expression to normal form with the combinator backend",	command_ski},
+	{"sigma",	"Reduce an expression to normal form with explicit substitutions",	command_sigma},
+	{"bench",	"Compare every strategy on an expression",			command_bench},
+	{"stream",	"Print the normal form of an expression while it is being computed",	command_stream},
+	{"shared",	"Reduce an expression to normal form and print shared subterms once",	command_shared},
+	{"profile",	"Reduce an expression to normal form and break its cost down by definition",	command_profile},
+	{"load",	"Load the definitions of a file",				command_load},
+	{"show",	"Print a definition as written and as optimized",		command_show},
+	{"eq",		"Decide whether two expressions M = N are beta eta equivalent",	command_eq},
+	{"blc",		"Print an expression in binary lambda calculus",		command_blc},
+	{"blcload",	"Load the terms of a binary lambda calculus file as definitions NAME0, NAME1...",	command_blcload},
+	{"blcsave",	"Save the definitions NAME0, NAME1... to a binary lambda calculus file",	command_blcsave},
+	{"type",	"Infer the simple type of an expression",			command_type},
+	{"types",	"Toggle type inference of every line, and native evaluation of typed numerals and booleans",	command_types},
+};
+
+// Evaluation backends share the signature of lambda_evaluate()
+
+typedef struct LambdaHandle (*Evaluator)(
+	struct LambdaHandle lambda, const struct HashMap *definitions,
+	enum EvaluationMode mode, struct EvaluationStats *stats
+);
+
+struct Strategy {
+	const char *name;
+
+	Evaluator evaluate;
+	enum EvaluationMode mode;
+};
+
+static struct LambdaHandle combinators_run(
+	struct LambdaHandle lambda, const struct HashMap *definitions,
+	enum EvaluationMode mode, struct EvaluationStats *stats
+);
+
+static const struct Strategy strategies[] = {
+	{"whnf",	lambda_evaluate,	EVALUATION_WHNF},
+	{"hnf",		lambda_evaluate,	EVALUATION_HNF},
+	{"nf",		lambda_evaluate,	EVALUATION_NF},
+	{"cbv",		lambda_evaluate,	EVALUATION_CBV},
+	{"ski",		combinators_run,	EVALUATION_NF},
+	{"sigma",	sigma_evaluate,		EVALUATION_NF},
+};
+
+// Set by :types, which infers the type of every definition and expression before evaluating it
+
+static int typing = 0;
+
+static void expression_run(struct HashMap *hashmap, char *input, size_t size, const struct Strategy *strategy, int report);
+static void type_print(const struct TypeInference *inference);
+static void profile_save(const char *path, const struct Linker *linker, enum ProfileWeight weight);
+static void status_print(const struct EvaluationStats *stats);
+static char *name_split(char *argument, const char *command);
+
+int main(int argc, char **argv)
 {
 	char input[BUFFER_SIZE];
 	struct HashMap hashmap;
 
 	hashmap = hashmap_create();
+	hashmap.fingerprint = lambda_fingerprint_normal_form;
+	hashmap.optimize = lambda_optimize;
+
+	// Daemon mode: lambda --serve <socket path> [definition files...]
+
+	if (argc >= 3 && strcmp(argv[1], "--serve") == 0) {
+		for (int i = 3; i < argc; i++) {
+			if (!definitions_load(&hashmap, argv[i], NULL)) {
+				hashmap_destroy(hashmap);
+				return 1;
+			}
+		}
+
+		int status = server_run(argv[2], &hashmap);
+
+		hashmap_destroy(hashmap);
+		reclaimer_finish();
+
+		return status ? 0 : 1;
+	}
 
 	printf("λ-C: a Lambda Calculus (λ-calculus) abstraction and application interpreter.\n");
 	printf("Made by victorsavas (https://github.com/victorsavas/lambda-c)\n");
 
+	worker_install();
+
+	// Session mode: lambda --session <path>, restoring the definitions of the last run and saving every new one
+
+	if (argc >= 3 && strcmp(argv[1], "--session") == 0 && !worker_run(session_open, &hashmap, argv[2], strlen(argv[2]) + 1)) {
+		hashmap_destroy(hashmap);
+		return 1;
+	}
+
 	while (1) {
 		printf("\nλ> ");
 
 		if (fgets(input, BUFFER_SIZE, stdin) == NULL) {
 			printf("Error!\n");
+
+			journal_close(&hashmap);
 			return 1;
 		}
 		
@@ -28,26 +176,719 @@ int main()
 
 		input[null_pos] = '\0';
 
-		if (input[0] == ':') {
+		if (!worker_run(line_run, &hashmap, input, null_pos + 1)) {
 			break;
 		}
+	}
+
+	journal_close(&hashmap);
+
+	hashmap_destroy(hashmap);
+	reclaimer_finish();
+
+	return 0;
+}
+
+int line_run(struct HashMap *hashmap, char *input, size_t size)
+{
+	if (input[0] == ':') {
+		return command_run(hashmap, input + 1);
+	}
+
+	expression_run(hashmap, input, size, &strategies[2], 0);
+
+	return 1;
+}
+
+int session_open(struct HashMap *hashmap, char *path, size_t size)
+{
+	(void)size;
+
+	size_t count;
+
+	// Restored definitions are stored as they were, but journaled ones are optimized again, which may recurse deeply
+
+	if (!journal_open(path, hashmap, &count)) {
+		return 0;
+	}
+
+	printf("(%zu definitions restored from %s)\n", count, path);
 
-		struct LambdaHandle lambda = lambda_parse(input, null_pos + 1);
+	return 1;
+}
+
+int command_run(struct HashMap *hashmap, char *input)
+{
+	// A lone colon quits, as it always did
+
+	size_t name_length = strcspn(input, " ");
+
+	if (name_length == 0) {
+		return 0;
+	}
 
-		if (lambda.term == NULL) {
+	char *argument = input + name_length;
+
+	while (*argument == ' ') {
+		argument++;
+	}
+
+	for (size_t i = 0; i < sizeof(commands) / sizeof(*commands); i++) {
+		if (strlen(commands[i].name) != name_length || strncmp(commands[i].name, input, name_length) != 0) {
 			continue;
 		}
 
+		return commands[i].run(hashmap, argument, strlen(argument) + 1);
+	}
+
+	printf("ERROR: unknown command :%.*s, see :help.", (int)name_length, input);
+
+	return 1;
+}
+
+int command_quit(struct HashMap *hashmap, char *argument, size_t size)
+{
+	(void)hashmap;
+	(void)argument;
+	(void)size;
+
+	return 0;
+}
+
+int command_help(struct HashMap *hashmap, char *argument, size_t size)
+{
+	(void)hashmap;
+	(void)argument;
+	(void)size;
+
+	for (size_t i = 0; i < sizeof(commands) / sizeof(*commands); i++) {
+		printf("\n  :%-8s %s", commands[i].name, commands[i].help);
+	}
+
+	return 1;
+}
+
+int command_whnf(struct HashMap *hashmap, char *argument, size_t size)
+{
+	expression_run(hashmap, argument, size, &strategies[0], 1);
+
+	return 1;
+}
+
+int command_hnf(struct HashMap *hashmap, char *argument, size_t size)
+{
+	expression_run(hashmap, argument, size, &strategies[1], 1);
+
+	return 1;
+}
+
+int command_nf(struct HashMap *hashmap, char *argument, size_t size)
+{
+	expression_run(hashmap, argument, size, &strategies[2], 1);
+
+	return 1;
+}
+
+int command_cbv(struct HashMap *hashmap, char *argument, size_t size)
+{
+	expression_run(hashmap, argument, size, &strategies[3], 1);
+
+	return 1;
+}
+
+int command_ski(struct HashMap *hashmap, char *argument, size_t size)
+{
+	expression_run(hashmap, argument, size, &strategies[4], 1);
+
+	return 1;
+}
+
+int command_sigma(struct HashMap *hashmap, char *argument, size_t size)
+{
+	expression_run(hashmap, argument, size, &strategies[5], 1);
+
+	return 1;
+}
+
+int command_bench(struct HashMap *hashmap, char *argument, size_t size)
+{
+	struct LambdaHandle lambda = lambda_parse(argument, size);
+
+	if (lambda.term == NULL) {
+		return 1;
+	}
+
+	if (lambda.identifier.name != NULL) {
+		printf("ERROR: :bench expects an expression, not a definition.");
+		lambda_free(lambda);
+
+		return 1;
+	}
+
+	worker_progress_end();
+
+	printf("\n  %-8s %12s %12s %12s %10s", "strategy", "steps", "unfoldings", "nodes", "ms");
+
+	for (size_t i = 0; i < sizeof(strategies) / sizeof(*strategies); i++) {
+		struct EvaluationStats stats;
+
+		clock_t begin = clock();
+
+		struct LambdaHandle result = strategies[i].evaluate(lambda, hashmap, strategies[i].mode, &stats);
+
+		clock_t end = clock();
+
+		printf("\n  %-8s %12zu %12zu %12zu %10.3f", strategies[i].name, stats.beta_steps, stats.delta_steps, stats.nodes,
+			(double)(end - begin) * 1000.0 / CLOCKS_PER_SEC);
+
+		if (stats.status == EVALUATION_STEP_LIMIT) {
+			printf(" (step limit)");
+		}
+
+		if (stats.status == EVALUATION_DEPTH_LIMIT) {
+			printf(" (nesting limit)");
+		}
+
+		if (stats.status == EVALUATION_LOOP && stats.loop_period == 0) {
+			printf(" (needs its own value)");
+		} else if (stats.status == EVALUATION_LOOP) {
+			printf(" (loop of period %zu)", stats.loop_period);
+		}
+
+		lambda_free_deferred(result);
+
+		if (stats.status == EVALUATION_CANCELLED) {
+			printf(" (cancelled)");
+			break;
+		}
+	}
+
+	lambda_free(lambda);
+
+	return 1;
+}
+
+int command_profile(struct HashMap *hashmap, char *argument, size_t size)
+{
+	struct LambdaHandle lambda = lambda_parse(argument, size);
+
+	if (lambda.term == NULL) {
+		return 1;
+	}
+
+	if (lambda.identifier.name != NULL) {
+		printf("ERROR: :profile expects an expression, not a definition.");
+		lambda_free(lambda);
+
+		return 1;
+	}
+
+	struct Evaluation evaluation = evaluation_create_profiled(lambda, hashmap);
+
+	evaluation.folding = 1;
+	evaluation.loop_checking = 1;
+
+	evaluation_reduce(&evaluation, EVALUATION_NF);
+
+	worker_progress_end();
+
+	if (evaluation.stats.status == EVALUATION_CANCELLED) {
+		status_print(&evaluation.stats);
+
+		evaluation_destroy(evaluation);
+		lambda_free(lambda);
+
+		return 1;
+	}
+
+	struct LambdaHandle result = evaluation_readback(&evaluation);
+
+	lambda_print(result);
+	status_print(&evaluation.stats);
+
+	printf("\n");
+	profile_print(stdout, &evaluation.linker);
+
+	profile_save(PROFILE_BETA_PATH, &evaluation.linker, PROFILE_BETA_STEPS);
+	profile_save(PROFILE_ALLOCATIONS_PATH, &evaluation.linker, PROFILE_ALLOCATIONS);
+
+	printf("\n(collapsed stacks written to %s and %s)", PROFILE_BETA_PATH, PROFILE_ALLOCATIONS_PATH);
+
+	lambda_free_deferred(result);
+	evaluation_destroy(evaluation);
+	lambda_free(lambda);
+
+	return 1;
+}
+
+int command_stream(struct HashMap *hashmap, char *argument, size_t size)
+{
+	struct LambdaHandle lambda = lambda_parse(argument, size);
+
+	if (lambda.term == NULL) {
+		return 1;
+	}
+
+	if (lambda.identifier.name != NULL) {
+		printf("ERROR: :stream expects an expression, not a definition.");
+		lambda_free(lambda);
+
+		return 1;
+	}
+
+	// The normal form takes over the line from the start
+
+	worker_progress_end();
+
+	struct Evaluation evaluation = evaluation_create(lambda, hashmap);
+
+	evaluation.loop_checking = 1;
+
+	evaluation_stream(stdout, &evaluation);
+	status_print(&evaluation.stats);
+
+	evaluation_destroy(evaluation);
+	lambda_free(lambda);
+
+	return 1;
+}
+
+int command_shared(struct HashMap *hashmap, char *argument, size_t size)
+{
+	struct LambdaHandle lambda = lambda_parse(argument, size);
+
+	if (lambda.term == NULL) {
+		return 1;
+	}
+
+	if (lambda.identifier.name != NULL) {
+		printf("ERROR: :shared expects an expression, not a definition.");
+		lambda_free(lambda);
+
+		return 1;
+	}
+
+	struct Evaluation evaluation = evaluation_create(lambda, hashmap);
+
+	evaluation.loop_checking = 1;
+
+	evaluation_reduce(&evaluation, EVALUATION_NF);
+
+	worker_progress_end();
+
+	if (evaluation.stats.status != EVALUATION_CANCELLED) {
+		evaluation_fprint_shared(stdout, &evaluation, SHARED_PRINT_LIMIT);
+	}
+
+	status_print(&evaluation.stats);
+
+	evaluation_destroy(evaluation);
+	lambda_free(lambda);
+
+	return 1;
+}
+
+int command_load(struct HashMap *hashmap, char *argument, size_t size)
+{
+	(void)size;
+
+	size_t count;
+
+	worker_progress_end();
+
+	if (definitions_load(hashmap, argument, &count)) {
+		printf("(%zu definitions loaded from %s)", count, argument);
+
+		// One snapshot holds the whole file rather than a record per definition
+
+		journal_compact(hashmap);
+	}
+
+	return 1;
+}
+
+int command_show(struct HashMap *hashmap, char *argument, size_t size)
+{
+	struct LambdaHandle lambda = lambda_parse(argument, size);
+
+	if (lambda.term == NULL) {
+		return 1;
+	}
+
+	if (lambda.identifier.name != NULL || lambda.term->type != FREE_VARIABLE) {
+		printf("ERROR: :show expects the name of a definition.");
+		lambda_free(lambda);
+
+		return 1;
+	}
+
+	struct Identifier identifier = lambda.term->expression.variable;
+
+	struct LambdaHandle original = hashmap_get_original(hashmap, identifier);
+	struct LambdaHandle optimized = hashmap_get(hashmap, identifier);
+
+	if (original.term == NULL) {
+		printf("ERROR: %s is not defined.", identifier.name);
+	} else {
+		lambda_print(original);
+	}
+
+	// The optimized form is only shown when the optimizer rewrote the definition
+
+	if (optimized.term != original.term) {
+		printf("\n(optimized: ");
+		lambda_print(optimized);
+		printf(")");
+	}
+
+	lambda_free(lambda);
+
+	return 1;
+}
+
+int command_eq(struct HashMap *hashmap, char *argument, size_t size)
+{
+	// Both sides are parsed apart, so the equal sign can't be taken for a definition
+
+	char *separator = memchr(argument, '=', size);
+
+	if (separator == NULL) {
+		printf("ERROR: :eq expects two expressions separated by =.");
+
+		return 1;
+	}
+
+	*separator = '\0';
+
+	struct LambdaHandle left = lambda_parse(argument, separator - argument + 1);
+
+	if (left.term == NULL) {
+		return 1;
+	}
+
+	struct LambdaHandle right = lambda_parse(separator + 1, size - (separator - argument) - 1);
+
+	if (right.term == NULL) {
+		lambda_free(left);
+
+		return 1;
+	}
+
+	struct EvaluationStats stats;
+
+	int equivalent = lambda_equivalent(left, right, hashmap, &stats);
+
+	worker_progress_end();
+
+	if (equivalent == 1) {
+		printf("(equivalent)");
+	} else if (equivalent == 0) {
+		printf("(not equivalent)");
+	} else {
+		printf("(undecided)");
+		status_print(&stats);
+	}
+
+	lambda_free(left);
+	lambda_free(right);
+
+	return 1;
+}
+
+int command_blc(struct HashMap *hashmap, char *argument, size_t size)
+{
+	struct LambdaHandle lambda = lambda_parse(argument, size);
+
+	if (lambda.term == NULL) {
+		return 1;
+	}
+
+	struct BitWriter writer = bit_writer_create();
+	struct Identifier unresolved;
+
+	if (blc_write(&writer, lambda, hashmap, &unresolved)) {
+		bit_writer_fprint(stdout, &writer);
+		printf("\n(%zu bits)", writer.size);
+	} else {
+		printf("ERROR: no binary encoding, %s", unresolved.name);
+
+		if (unresolved.subscript >= 0) {
+			printf("%d", unresolved.subscript);
+		}
+
+		printf(" is undefined or recursive.");
+	}
+
+	bit_writer_destroy(writer);
+	lambda_free(lambda);
+
+	return 1;
+}
+
+int command_blcload(struct HashMap *hashmap, char *argument, size_t size)
+{
+	(void)size;
+
+	char *path = name_split(argument, "blcload");
+
+	if (path == NULL) {
+		return 1;
+	}
+
+	size_t count;
+
+	worker_progress_end();
+
+	int loaded = blc_load(hashmap, path, argument, &count);
+
+	if (loaded) {
+		printf("(%zu definitions loaded from %s)", count, path);
+	}
+
+	// One snapshot holds the whole file rather than a record per definition
+
+	if (count != 0) {
+		journal_compact(hashmap);
+	}
+
+	return 1;
+}
+
+int command_blcsave(struct HashMap *hashmap, char *argument, size_t size)
+{
+	(void)size;
+
+	char *path = name_split(argument, "blcsave");
+
+	if (path == NULL) {
+		return 1;
+	}
+
+	size_t count;
+
+	worker_progress_end();
+
+	if (blc_save(hashmap, path, argument, &count)) {
+		printf("(%zu definitions saved to %s)", count, path);
+	}
+
+	return 1;
+}
+
+char *name_split(char *argument, const char *command)
+{
+	// Splits "NAME path" in place, returning the path. NAME takes no subscript, since the definitions get one each
+
+	size_t length = strcspn(argument, " ");
+
+	char *path = argument + length;
+
+	while (*path == ' ') {
+		*path++ = '\0';
+	}
+
+	int valid = length != 0 && *path != '\0';
+
+	for (size_t i = 0; i < length; i++) {
+		valid = valid && isalpha((unsigned char)argument[i]);
+	}
+
+	if (!valid) {
+		printf("ERROR: :%s expects a name made of letters, then a path.", command);
+		return NULL;
+	}
+
+	return path;
+}
+
+int command_type(struct HashMap *hashmap, char *argument, size_t size)
+{
+	struct LambdaHandle lambda = lambda_parse(argument, size);
+
+	if (lambda.term == NULL) {
+		return 1;
+	}
+
+	if (lambda.identifier.name != NULL) {
+		printf("ERROR: :type expects an expression, not a definition.");
+		lambda_free(lambda);
+
+		return 1;
+	}
+
+	struct TypeInference inference = type_infer(lambda, hashmap);
+
+	worker_progress_end();
+
+	if (inference.type != NULL) {
+		type_fprint(stdout, inference.type);
+	} else {
+		printf("(no simple type: %s)", inference.error);
+	}
+
+	type_inference_destroy(inference);
+	lambda_free(lambda);
+
+	return 1;
+}
+
+int command_types(struct HashMap *hashmap, char *argument, size_t size)
+{
+	(void)hashmap;
+	(void)argument;
+	(void)size;
+
+	typing = !typing;
+
+	printf(typing ? "(types on)" : "(types off)");
+
+	return 1;
+}
+
+void profile_save(const char *path, const struct Linker *linker, enum ProfileWeight weight)
+{
+	FILE *file = fopen(path, "w");
+
+	if (file == NULL) {
+		printf("\nERROR: could not open %s.", path);
+		return;
+	}
+
+	profile_write_collapsed(file, linker, weight);
+
+	fclose(file);
+}
+
+struct LambdaHandle combinators_run(
+	struct LambdaHandle lambda, const struct HashMap *definitions,
+	enum EvaluationMode mode, struct EvaluationStats *stats
+)
+{
+	// The combinator backend only computes full normal forms
+
+	(void)mode;
+
+	return combinators_evaluate(lambda, definitions, stats);
+}
+
+void expression_run(struct HashMap *hashmap, char *input, size_t size, const struct Strategy *strategy, int report)
+{
+	struct LambdaHandle lambda = lambda_parse(input, size);
+
+	if (lambda.term == NULL) {
+		return;
+	}
+
+	if (lambda.identifier.name != NULL) {
+		// Definitions are stored as written and only evaluated once used
+
+		worker_progress_end();
+
 		lambda_print(lambda);
 
-		if (lambda.identifier.name == NULL) {
-			lambda_free(lambda);
-		} else {
-			hashmap_set(&hashmap, lambda);
+		if (hashmap_set(hashmap, lambda) && !journal_append(hashmap, lambda)) {
+			printf("\nERROR: the definition could not be encoded, it won't be saved in the session.");
+		}
+
+		// Typed once stored, so that a recursive definition refers to itself
+
+		if (typing) {
+			struct TypeInference inference = type_infer(lambda, hashmap);
+
+			type_print(&inference);
+			type_inference_destroy(inference);
 		}
+
+		return;
 	}
 
-	hashmap_destroy(hashmap);
+	struct EvaluationStats stats;
+	struct LambdaHandle result;
 
-	return 0;
+	struct TypeInference inference = {0};
+
+	if (typing) {
+		inference = type_infer(lambda, hashmap);
+	}
+
+	// Typed numerals and booleans are only evaluated natively when a full normal form is asked for
+
+	int native = typing && strategy->evaluate == lambda_evaluate && strategy->mode >= EVALUATION_NF
+		&& lambda_evaluate_native(lambda, hashmap, type_shape(&inference), &result, &stats);
+
+	if (!native) {
+		result = strategy->evaluate(lambda, hashmap, strategy->mode, &stats);
+	}
+
+	worker_progress_end();
+
+	lambda_print(result);
+
+	if (typing && stats.status != EVALUATION_CANCELLED) {
+		type_print(&inference);
+	}
+
+	status_print(&stats);
+
+	if (report && native) {
+		printf("\n(native, beta: %zu, delta: %zu, values: %zu)", stats.beta_steps, stats.delta_steps, stats.nodes);
+	} else if (report) {
+		printf("\n(beta: %zu, delta: %zu, nodes: %zu)", stats.beta_steps, stats.delta_steps, stats.nodes);
+	}
+
+	if (report && stats.collections != 0) {
+		printf("\n(nursery: %zu collections, %zu of %zu nodes survived, %.1f%%)", stats.collections, stats.survivors,
+			stats.collected, 100.0 * stats.survivors / stats.collected);
+	}
+
+	if (typing) {
+		type_inference_destroy(inference);
+	}
+
+	lambda_free_deferred(result);
+	lambda_free(lambda);
+}
+
+void type_print(const struct TypeInference *inference)
+{
+	if (inference->type == NULL) {
+		printf("\n(no simple type: %s)", inference->error);
+		return;
+	}
+
+	printf(" : ");
+	type_fprint(stdout, inference->type);
+}
+
+void status_print(const struct EvaluationStats *stats)
+{
+	switch (stats->status) {
+	case EVALUATION_STEP_LIMIT:
+		printf("\n(step limit reached after %zu beta steps)", stats->beta_steps);
+		break;
+
+	case EVALUATION_DEPTH_LIMIT:
+		printf("\n(argument nesting limit reached after %zu beta steps)", stats->beta_steps);
+		break;
+
+	case EVALUATION_CANCELLED:
+		printf("\n(cancelled after %zu beta steps)", stats->beta_steps);
+		break;
+
+	case EVALUATION_LOOP:
+		if (stats->loop_period == 0) {
+			printf("\n(reduction loop found after %zu beta steps, the term needs its own value)", stats->beta_steps);
+		} else {
+			printf("\n(reduction loop found after %zu beta steps, repeating every %zu)", stats->beta_steps, stats->loop_period);
+		}
+
+		break;
+
+	default:
+		break;
+	}
+
+	if (stats->truncated) {
+		printf("\n(result truncated after %zu nodes)", READBACK_NODE_LIMIT);
+	}
 }
\ No newline at end of file
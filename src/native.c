@@ -0,0 +1,438 @@
+#include <native.h>
+#include <fingerprint.h>
+#include <limits.h>
+#include <string.h>
+
+enum ValueType {
+	VALUE_CLOSURE,
+	VALUE_NUMERAL,		// Church numeral, iterating its argument number times
+	VALUE_INTEGER,		// Zero and its successors while a numeral is read, or a boolean marker
+	VALUE_ADDITION,		// Adds number to an integer, the successor adding 1
+	VALUE_ITERATION		// Applies function number times to its argument
+};
+
+struct Environment {
+	const char *variable;		// Name string of the abstraction, shared with its variables
+	struct Value *value;
+
+	struct Environment *next;
+};
+
+struct Value {
+	enum ValueType type;
+
+	int number;
+
+	union {
+		struct {
+			const struct LambdaTerm *body;
+			const char *variable;
+			struct Environment *environment;
+		} closure;
+
+		struct Value *function;
+	};
+};
+
+// Stored definitions are closed, so each one is evaluated once per run and shared by every reference
+
+struct NativeDefinition {
+	const struct LambdaTerm *term;
+	struct Value *value;
+};
+
+struct Machine {
+	struct Arena arena;
+
+	const struct HashMap *definitions;
+
+	struct NativeDefinition *evaluated;
+	size_t evaluated_size;
+	size_t evaluated_capacity;
+
+	int failed;			// An integer went past INT_MAX, or a value was applied where it can't be
+
+	struct EvaluationStats stats;
+};
+
+static struct Value *term_run(struct Machine *machine, const struct LambdaTerm *term, struct Environment *environment);
+static struct Value *definition_run(struct Machine *machine, const struct Identifier *identifier);
+static struct Value *value_apply(struct Machine *machine, struct Value *function, struct Value *argument);
+static struct Value *value_create(struct Machine *machine, enum ValueType type, int number);
+
+static int number_multiply(int left, int right, int *product);
+
+static struct LambdaHandle numeral_build(int church_numeral);
+static struct LambdaHandle boolean_build(const struct HashMap *definitions, int boolean);
+static struct LambdaTerm *term_create(enum ExpressionType type);
+static char *string_copy(const char *string);
+
+int lambda_evaluate_native(
+	struct LambdaHandle lambda, const struct HashMap *definitions, enum TypeShape shape,
+	struct LambdaHandle *result, struct EvaluationStats *stats
+)
+{
+	if (shape == TYPE_SHAPE_OTHER) {
+		return 0;
+	}
+
+	struct Machine machine = {0};
+
+	machine.arena = arena_create();
+	machine.definitions = definitions;
+
+	// Numerals are read with the integer successor, booleans with two markers
+
+	struct Value *value = term_run(&machine, lambda.term, NULL);
+
+	if (value != NULL && shape == TYPE_SHAPE_NUMERAL) {
+		value = value_apply(&machine, value, value_create(&machine, VALUE_ADDITION, 1));
+	} else if (value != NULL) {
+		value = value_apply(&machine, value, value_create(&machine, VALUE_INTEGER, 1));
+	}
+
+	if (value != NULL) {
+		value = value_apply(&machine, value, value_create(&machine, VALUE_INTEGER, 0));
+	}
+
+	int found = value != NULL && value->type == VALUE_INTEGER;
+	int number = found ? value->number : 0;
+
+	free(machine.evaluated);
+	arena_destroy(machine.arena);
+
+	// A cancelled run is reported as such rather than starting over on the graph
+
+	if (machine.stats.status == EVALUATION_CANCELLED) {
+		*result = (struct LambdaHandle){0};
+		*stats = machine.stats;
+
+		return 1;
+	}
+
+	// λf.f has the type of numerals as well and computes 1, but its normal form keeps the shorter shape
+
+	if (!found || (shape == TYPE_SHAPE_NUMERAL && number == 1)) {
+		return 0;
+	}
+
+	*result = shape == TYPE_SHAPE_NUMERAL ? numeral_build(number) : boolean_build(definitions, number);
+
+	machine.stats.status = EVALUATION_NORMAL_FORM;
+	*stats = machine.stats;
+
+	return 1;
+}
+
+struct Value *term_run(struct Machine *machine, const struct LambdaTerm *term, struct Environment *environment)
+{
+	switch (term->type) {
+	case BOUND_VARIABLE:
+		for (; environment != NULL; environment = environment->next) {
+			if (environment->variable == term->expression.variable.name) {
+				return environment->value;
+			}
+		}
+
+		machine->failed = 1;
+
+		return NULL;
+
+	case FREE_VARIABLE:
+		return definition_run(machine, &term->expression.variable);
+
+	case ABSTRACTION: {
+		struct Value *value = value_create(machine, VALUE_CLOSURE, 0);
+
+		value->closure.body = term->expression.abstraction.body;
+		value->closure.variable = term->expression.abstraction.bound_variable.name;
+		value->closure.environment = environment;
+
+		return value;
+	}
+
+	case APPLICATION: {
+		// Typed terms are strongly normalizing, so arguments are evaluated before the call whether they are used or not
+
+		struct Value *function = term_run(machine, term->expression.application.function, environment);
+
+		if (function == NULL) {
+			return NULL;
+		}
+
+		struct Value *argument = term_run(machine, term->expression.application.argument, environment);
+
+		if (argument == NULL) {
+			return NULL;
+		}
+
+		return value_apply(machine, function, argument);
+	}
+
+	case CHURCH_NUMERAL:
+		return value_create(machine, VALUE_NUMERAL, term->expression.church_numeral);
+
+	default:
+		machine->failed = 1;
+
+		return NULL;
+	}
+}
+
+struct Value *definition_run(struct Machine *machine, const struct Identifier *identifier)
+{
+	struct LambdaHandle definition = hashmap_get(machine->definitions, *identifier);
+
+	if (definition.term == NULL) {
+		machine->failed = 1;
+
+		return NULL;
+	}
+
+	for (size_t i = 0; i < machine->evaluated_size; i++) {
+		if (machine->evaluated[i].term == definition.term) {
+			return machine->evaluated[i].value;
+		}
+	}
+
+	machine->stats.delta_steps++;
+
+	struct Value *value = term_run(machine, definition.term, NULL);
+
+	if (value == NULL) {
+		return NULL;
+	}
+
+	if (machine->evaluated_capacity == machine->evaluated_size) {
+		// Scaling factor of 2
+
+		machine->evaluated_capacity = machine->evaluated_capacity == 0 ? 16 : machine->evaluated_capacity << 1;
+		machine->evaluated = realloc(machine->evaluated, sizeof(*machine->evaluated) * machine->evaluated_capacity);
+
+		if (machine->evaluated == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	machine->evaluated[machine->evaluated_size++] = (struct NativeDefinition){definition.term, value};
+
+	return value;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function definition_run().\n");
+	exit(1);
+}
+
+struct Value *value_apply(struct Machine *machine, struct Value *function, struct Value *argument)
+{
+	machine->stats.beta_steps++;
+
+	if (machine->stats.beta_steps > DEFAULT_STEP_LIMIT) {
+		machine->stats.status = EVALUATION_STEP_LIMIT;
+
+		return NULL;
+	}
+
+	if ((machine->stats.beta_steps & (EVALUATION_POLL_INTERVAL - 1)) == 0 && !evaluation_poll(&machine->stats)) {
+		return NULL;
+	}
+
+	switch (function->type) {
+	case VALUE_CLOSURE: {
+		struct Environment *environment = arena_alloc(&machine->arena, sizeof(*environment));
+
+		environment->variable = function->closure.variable;
+		environment->value = argument;
+		environment->next = function->closure.environment;
+
+		return term_run(machine, function->closure.body, environment);
+	}
+
+	case VALUE_NUMERAL: {
+		// n (λx.x + c) is λx.x + n·c and n m is m to the power n, both without iterating
+
+		int number;
+
+		if (argument->type == VALUE_ADDITION) {
+			if (!number_multiply(function->number, argument->number, &number)) {
+				machine->failed = 1;
+
+				return NULL;
+			}
+
+			return value_create(machine, VALUE_ADDITION, number);
+		}
+
+		if (argument->type == VALUE_NUMERAL && (function->number == 0 || argument->number <= 1)) {
+			return value_create(machine, VALUE_NUMERAL, function->number == 0 ? 1 : argument->number);
+		}
+
+		if (argument->type == VALUE_NUMERAL) {
+			number = 1;
+
+			// Powers of 2 or more overflow within 31 multiplications
+
+			for (int i = 0; i < function->number; i++) {
+				if (!number_multiply(number, argument->number, &number)) {
+					machine->failed = 1;
+
+					return NULL;
+				}
+			}
+
+			return value_create(machine, VALUE_NUMERAL, number);
+		}
+
+		struct Value *value = value_create(machine, VALUE_ITERATION, function->number);
+
+		value->function = argument;
+
+		return value;
+	}
+
+	case VALUE_ITERATION:
+		for (int i = 0; i < function->number && argument != NULL; i++) {
+			argument = value_apply(machine, function->function, argument);
+		}
+
+		return argument;
+
+	case VALUE_ADDITION:
+		if (argument->type != VALUE_INTEGER || argument->number > INT_MAX - function->number) {
+			machine->failed = 1;
+
+			return NULL;
+		}
+
+		return value_create(machine, VALUE_INTEGER, argument->number + function->number);
+
+	default:
+		machine->failed = 1;
+
+		return NULL;
+	}
+}
+
+struct Value *value_create(struct Machine *machine, enum ValueType type, int number)
+{
+	struct Value *value = arena_alloc(&machine->arena, sizeof(*value));
+
+	value->type = type;
+	value->number = number;
+
+	machine->stats.nodes++;
+
+	return value;
+}
+
+int number_multiply(int left, int right, int *product)
+{
+	if (left != 0 && right > INT_MAX / left) {
+		return 0;
+	}
+
+	*product = left * right;
+
+	return 1;
+}
+
+struct LambdaHandle numeral_build(int church_numeral)
+{
+	struct LambdaHandle lambda = {0};
+
+	lambda.term = term_create(CHURCH_NUMERAL);
+	lambda.term->expression.church_numeral = church_numeral;
+
+	return lambda;
+}
+
+struct LambdaHandle boolean_build(const struct HashMap *definitions, int boolean)
+{
+	// λx.λy.y reads back as 0, like the graph does, while λx.λy.x is named after a definition if one computes it
+
+	if (!boolean) {
+		return numeral_build(0);
+	}
+
+	struct LambdaHandle lambda = {0};
+
+	struct LambdaTerm *inner = term_create(ABSTRACTION);
+
+	inner->expression.abstraction.bound_variable = (struct Identifier){string_copy("y"), 0};
+	inner->expression.abstraction.body = term_create(BOUND_VARIABLE);
+
+	lambda.term = term_create(ABSTRACTION);
+	lambda.term->expression.abstraction.bound_variable = (struct Identifier){string_copy("x"), 0};
+	lambda.term->expression.abstraction.body = inner;
+
+	inner->expression.abstraction.body->expression.variable = lambda.term->expression.abstraction.bound_variable;
+
+	struct Identifier identifier;
+
+	if (definitions == NULL || !hashmap_find(definitions, lambda_fingerprint(lambda), &identifier)) {
+		return lambda;
+	}
+
+	lambda_free(lambda);
+
+	lambda = (struct LambdaHandle){0};
+
+	lambda.free_variables = malloc(sizeof(*lambda.free_variables));
+
+	if (lambda.free_variables == NULL) {
+		goto fatal_error;
+	}
+
+	lambda.free_variables[0] = (struct Identifier){string_copy(identifier.name), identifier.subscript};
+	lambda.free_variables_size = 1;
+	lambda.free_variables_capacity = 1;
+
+	lambda.term = term_create(FREE_VARIABLE);
+	lambda.term->expression.variable = lambda.free_variables[0];
+
+	return lambda;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function boolean_build().\n");
+	exit(1);
+}
+
+struct LambdaTerm *term_create(enum ExpressionType type)
+{
+	struct LambdaTerm *term = malloc(sizeof(*term));
+
+	if (term == NULL) {
+		goto fatal_error;
+	}
+
+	term->type = type;
+
+	return term;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function term_create().\n");
+	exit(1);
+}
+
+char *string_copy(const char *string)
+{
+	size_t size = strlen(string) + 1;
+
+	char *copy = malloc(size);
+
+	if (copy == NULL) {
+		goto fatal_error;
+	}
+
+	memcpy(copy, string, size);
+
+	return copy;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function string_copy().\n");
+	exit(1);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <evaluation.h>
+#include <hashmap.h>
+#include <lambda.h>
+#include <typing.h>
+
+// Native evaluation of well typed numerals and booleans
+// A closed term whose principal type is exactly that of Church numerals or booleans can only compute one, so it is run
+// by an eager environment machine on unboxed values instead of the graph. Numerals stay machine integers while they
+// are passed around: applied to each other they multiply or exponentiate at once, and they only iterate a function
+// when they are applied to a closure. The result is read by applying the value to an integer successor and zero, or
+// to the two booleans, and rebuilt as a term. Typed terms always terminate, so evaluating arguments eagerly is safe.
+// Integers past INT_MAX, which a Church numeral literal can't hold, and the step limit hand the term back to the graph,
+// and so does a result of 1, whose normal form may be λf.f as well as λf.λx.f x.
+
+int lambda_evaluate_native(
+	struct LambdaHandle lambda, const struct HashMap *definitions, enum TypeShape shape,
+	struct LambdaHandle *result, struct EvaluationStats *stats
+);	// Evaluate a closed term of shape into result. Returns 0 when the graph has to evaluate it instead
\ No newline at end of file
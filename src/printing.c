@@ -8,15 +8,20 @@ enum PrintSymbol {
 	SPACE
 };
 
-static void symbol_print(enum PrintSymbol symbol);
+static void symbol_print(FILE *stream, enum PrintSymbol symbol);
 
-static void church_numeral_print(struct LambdaTerm *term);
-static void variable_print(struct LambdaTerm *term);
-static void abstraction_print(struct LambdaTerm *term);
+static void church_numeral_print(FILE *stream, struct LambdaTerm *term);
+static void variable_print(FILE *stream, struct LambdaTerm *term);
+static void abstraction_print(FILE *stream, struct LambdaTerm *term);
 
 static void application_symbols_push(struct LambdaTerm *function, struct LambdaTerm *argument, enum PrintSymbol *symbols, size_t *symbols_size);
 
 void lambda_print(struct LambdaHandle lambda)
+{
+	lambda_fprint(stdout, lambda);
+}
+
+void lambda_fprint(FILE *stream, struct LambdaHandle lambda)
 {
 	// Minimal parenthesis printing
 
@@ -52,7 +57,7 @@ void lambda_print(struct LambdaHandle lambda)
 			// Popping the topmost symbol off the stack and printing it
 
 			symbol = symbols[--symbols_size];
-			symbol_print(symbol);
+			symbol_print(stream, symbol);
 
 			if (symbol != RIGHT_PARENTHESIS) {
 				// Once all right parenthesis are closed, go on
@@ -64,18 +69,18 @@ void lambda_print(struct LambdaHandle lambda)
 
 		switch (term->type) {
 		case CHURCH_NUMERAL:
-			church_numeral_print(term);
+			church_numeral_print(stream, term);
 
 			break;
 
 		case FREE_VARIABLE:
 		case BOUND_VARIABLE:
-			variable_print(term);
+			variable_print(stream, term);
 			
 			break;
 		
 		case ABSTRACTION:
-			abstraction_print(term);
+			abstraction_print(stream, term);
 
 			symbols[symbols_size++] = EMPTY;
 			terms[terms_size++] = term->expression.abstraction.body;
@@ -116,7 +121,7 @@ void lambda_print(struct LambdaHandle lambda)
 
 		symbol = symbols[--symbols_size];
 
-		symbol_print(symbol);
+		symbol_print(stream, symbol);
 	}
 
 	// Freeing memory before returning
@@ -169,51 +174,51 @@ void application_symbols_push(struct LambdaTerm *function, struct LambdaTerm *ar
 	}
 }
 
-void symbol_print(enum PrintSymbol symbol)
+void symbol_print(FILE *stream, enum PrintSymbol symbol)
 {
 	switch (symbol) {
 	case EMPTY:
 		break;
 
 	case RIGHT_PARENTHESIS:
-		putchar(')');
+		fputc(')', stream);
 		break;
 
 	case LEFT_PARENTHESIS:
-		putchar('(');
+		fputc('(', stream);
 		break;
 
 	case SPACE:
-		putchar(' ');
+		fputc(' ', stream);
 		break;
 	}
 }
 
-void church_numeral_print(struct LambdaTerm *term)
+void church_numeral_print(FILE *stream, struct LambdaTerm *term)
 {
 	int church_numeral = term->expression.church_numeral;
 
-	printf("%d", church_numeral);
+	fprintf(stream, "%d", church_numeral);
 }
 
-void variable_print(struct LambdaTerm *term)
+void variable_print(FILE *stream, struct LambdaTerm *term)
 {
 	struct Identifier variable = term->expression.variable;
 
 	if (variable.subscript < 0) {
-		printf("%s", variable.name);
+		fprintf(stream, "%s", variable.name);
 	} else {
-		printf("%s%d", variable.name, variable.subscript);
+		fprintf(stream, "%s%d", variable.name, variable.subscript);
 	}
 }
 
-void abstraction_print(struct LambdaTerm *term)
+void abstraction_print(FILE *stream, struct LambdaTerm *term)
 {
 	struct Identifier bound_variable = term->expression.abstraction.bound_variable;
 
 	if (bound_variable.subscript < 0) {
-		printf("λ%s.", bound_variable.name);
+		fprintf(stream, "λ%s.", bound_variable.name);
 	} else {
-		printf("λ%s%d.", bound_variable.name, bound_variable.subscript);
+		fprintf(stream, "λ%s%d.", bound_variable.name, bound_variable.subscript);
 	}
 }
\ No newline at end of file
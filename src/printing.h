@@ -1,5 +1,7 @@
 #pragma once
 
 #include <lambda.h>
+#include <stdio.h>
 
-void lambda_print(struct LambdaHandle lambda);	// Pretty-printing for a lambda term
\ No newline at end of file
+void lambda_print(struct LambdaHandle lambda);			// Pretty-printing for a lambda term
+void lambda_fprint(FILE *stream, struct LambdaHandle lambda);	// Pretty-printing for a lambda term into an arbitrary stream
\ No newline at end of file
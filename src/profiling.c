@@ -0,0 +1,129 @@
+#include <profiling.h>
+#include <stdlib.h>
+
+static void frames_print(FILE *stream, const struct Linkage *linkage);
+static void frame_print(FILE *stream, const struct Linkage *linkage);
+static void frame_name(const struct Linkage *linkage, char *buffer, size_t size);
+
+static int linkage_compare(const void *left, const void *right);
+
+void profile_print(FILE *stream, const struct Linker *linker)
+{
+	const struct Linkage **linkages = malloc(sizeof(*linkages) * (linker->size + 1));
+
+	if (linkages == NULL) {
+		goto fatal_error;
+	}
+
+	size_t size = 0;
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		if (linker->linkages[i] != NULL) {
+			linkages[size++] = linker->linkages[i];
+		}
+	}
+
+	qsort(linkages, size, sizeof(*linkages), linkage_compare);
+
+	fprintf(stream, "  %-24s %12s %12s", "definition", "beta", "allocations");
+
+	for (size_t i = 0; i < size; i++) {
+		if (linkages[i]->beta_steps == 0 && linkages[i]->allocations == 0) {
+			continue;
+		}
+
+		char name[64];
+
+		frame_name(linkages[i], name, sizeof(name));
+
+		fprintf(stream, "\n  %-24s %12zu %12zu", name, linkages[i]->beta_steps, linkages[i]->allocations);
+	}
+
+	free(linkages);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function profile_print().\n");
+	exit(1);
+}
+
+void profile_write_collapsed(FILE *stream, const struct Linker *linker, enum ProfileWeight weight)
+{
+	// One line per definition: its stack of callers, outermost first, then its own weight
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		const struct Linkage *linkage = linker->linkages[i];
+
+		if (linkage == NULL) {
+			continue;
+		}
+
+		size_t count = weight == PROFILE_BETA_STEPS ? linkage->beta_steps : linkage->allocations;
+
+		if (count == 0) {
+			continue;
+		}
+
+		frames_print(stream, linkage);
+
+		fprintf(stream, " %zu\n", count);
+	}
+}
+
+void frames_print(FILE *stream, const struct Linkage *linkage)
+{
+	// Callers are unfolded before their callees, so the chain is finite
+
+	if (linkage->caller != NULL) {
+		frames_print(stream, linkage->caller);
+		fputc(';', stream);
+	} else if (linkage->definition.identifier.name != NULL) {
+		// Unfolded outside of any application, hence directly by the evaluated term
+
+		fprintf(stream, "(query);");
+	}
+
+	frame_print(stream, linkage);
+}
+
+void frame_print(FILE *stream, const struct Linkage *linkage)
+{
+	char name[64];
+
+	frame_name(linkage, name, sizeof(name));
+
+	fputs(name, stream);
+}
+
+void frame_name(const struct Linkage *linkage, char *buffer, size_t size)
+{
+	// Longer names are truncated
+
+	const struct Identifier *identifier = &linkage->definition.identifier;
+
+	if (identifier->name == NULL) {
+		snprintf(buffer, size, "(query)");
+	} else if (identifier->subscript < 0) {
+		snprintf(buffer, size, "%s", identifier->name);
+	} else {
+		snprintf(buffer, size, "%s%d", identifier->name, identifier->subscript);
+	}
+}
+
+int linkage_compare(const void *left, const void *right)
+{
+	const struct Linkage *left_linkage = *(const struct Linkage *const *)left;
+	const struct Linkage *right_linkage = *(const struct Linkage *const *)right;
+
+	if (left_linkage->beta_steps != right_linkage->beta_steps) {
+		return left_linkage->beta_steps < right_linkage->beta_steps ? 1 : -1;
+	}
+
+	if (left_linkage->allocations != right_linkage->allocations) {
+		return left_linkage->allocations < right_linkage->allocations ? 1 : -1;
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <linking.h>
+#include <stdio.h>
+
+// Per definition cost report of a graph evaluation
+// Beta steps are charged to the definition the reduced abstraction was compiled from, allocations to the definition
+// being compiled or instantiated. Stacks follow the definition that first unfolded each one, so shared definitions
+// only appear below their first caller.
+
+enum ProfileWeight {
+	PROFILE_BETA_STEPS,
+	PROFILE_ALLOCATIONS
+};
+
+void profile_print(FILE *stream, const struct Linker *linker);	// Table of the definitions, by decreasing beta steps
+
+void profile_write_collapsed(FILE *stream, const struct Linker *linker, enum ProfileWeight weight);	// Collapsed stacks, as read by flamegraph tools
\ No newline at end of file
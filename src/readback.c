@@ -0,0 +1,1630 @@
+#include <evaluation.h>
+#include <fingerprint.h>
+#include <reclaimer.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define INITIAL_CAPACITY 8
+
+// Conversion of an evaluation graph back into a lambda term
+// Binders keep the name of the abstraction they were copied from, and get a subscript whenever that name is already
+// used by an enclosing binder or by a free variable, so the printed term never captures a variable.
+// When folding, every term is fingerprinted as it is built: Church numeral shapes become numerals again, and abstractions
+// and applications matching the normal form of a definition are replaced by its name.
+
+struct Readback {
+	struct LambdaHandle lambda;
+
+	// Enclosing binders and the names given to them
+
+	struct Node **binders;
+	struct Identifier *identifiers;
+
+	size_t scope_size;
+	size_t scope_capacity;
+
+	// Open addressing set of every name the result could refer to freely: the free variables and names of all
+	// linked definitions
+
+	const struct Identifier **names;
+	size_t names_capacity;
+
+	const struct HashMap *definitions;	// Reverse index used for folding, NULL when not folding
+	int folding;
+
+	struct EvaluationStats *stats;		// Marked cancelled when evaluation_control asks for it
+	size_t visited;				// Nodes read back, evaluation_control being polled every EVALUATION_POLL_INTERVAL
+	int cancelled;
+	int truncated;				// Past READBACK_NODE_LIMIT, the remaining subterms are elided
+
+	// Pending steps and the terms read back so far, see node_readback()
+
+	struct ReadbackTask *tasks;
+	size_t tasks_size;
+	size_t tasks_capacity;
+
+	struct ReadbackResult *results;
+	size_t results_size;
+	size_t results_capacity;
+};
+
+// What folding needs to know about a term read back
+
+struct Shape {
+	uint64_t fingerprint;
+
+	int variable;		// De Bruijn index of a bound variable, -1 for other terms
+	int chain;		// n for f (f ... (f x)) with n applications, f and x having indices 1 and 0, -1 otherwise
+	int half;		// n for an abstraction over such a chain, -1 otherwise
+};
+
+// Steps of a readback, taken off a stack
+
+enum ReadbackTaskType {
+	READBACK_NODE,		// Read back a node onto the results
+	READBACK_APPLICATION,	// Apply the function below the top of the results to the argument on top
+	READBACK_FIXPOINT,	// Likewise for the combinator and function of a fixpoint without a value
+	READBACK_ABSTRACTION,	// Close the abstraction term over the body on top of the results
+	READBACK_UNVISIT	// Leave the value of a reference or fixpoint
+};
+
+struct ReadbackTask {
+	enum ReadbackTaskType type;
+
+	struct Node *node;
+	struct LambdaTerm *term;	// Abstraction waiting for its body
+};
+
+struct ReadbackResult {
+	struct LambdaTerm *term;
+	struct Shape shape;
+};
+
+// Steps of folding a term read back by another backend, see lambda_fold()
+
+enum FoldTaskType {
+	FOLD_TERM,		// Fold a term onto the results
+	FOLD_APPLICATION,	// Give the application term the function and argument on top of the results
+	FOLD_ABSTRACTION	// Give the abstraction term the body on top of the results
+};
+
+struct FoldTask {
+	enum FoldTaskType type;
+
+	struct LambdaTerm *term;
+};
+
+static struct LambdaTerm *node_readback(struct Readback *readback, struct Node *node, struct Shape *shape);
+
+static int node_step(struct Readback *readback, struct Node *node, struct ReadbackResult *result);
+static int fixpoint_step(struct Readback *readback, const struct Fixpoint *fixpoint, struct ReadbackResult *result);
+static void task_push(struct Readback *readback, enum ReadbackTaskType type, struct Node *node, struct LambdaTerm *term);
+
+static struct LambdaTerm *variable_readback(struct Readback *readback, struct Node *node, struct Shape *shape);
+static struct LambdaTerm *free_variable_readback(struct Readback *readback, const struct Identifier *identifier);
+static struct LambdaTerm *term_fold(struct Readback *readback, struct LambdaTerm *term, struct Shape *shape);
+
+static void scope_push(struct Readback *readback, struct Node *binder, struct Identifier identifier);
+
+static struct Identifier identifier_fresh(struct Readback *readback, const struct Identifier *hint);
+static int identifier_used(struct Readback *readback, const char *name, int subscript);
+
+static void names_collect(struct Readback *readback, const struct Evaluation *evaluation);
+static void names_insert(struct Readback *readback, const struct Identifier *identifier);
+static size_t name_hash(const char *name, int subscript);
+
+static struct LambdaTerm *term_create(enum ExpressionType type);
+static char *string_copy(const char *string);
+
+// Streaming normalization
+// The head normal form of a node is printed as soon as it is known, then its arguments are normalized and printed one
+// after the other. Nothing but the evaluation graph is built, and the output is flushed regularly while reducing.
+
+enum StreamTaskType {
+	STREAM_TERM,		// Normalize and print a node
+	STREAM_CLOSE,		// Print a closing parenthesis
+	STREAM_SCOPE_POP	// Leave the body of an abstraction
+};
+
+enum StreamContext {
+	STREAM_BODY,		// Body of an abstraction or the whole term
+	STREAM_ARGUMENT,	// Last argument of an application, where abstractions need no parentheses
+	STREAM_INNER_ARGUMENT	// Any other argument
+};
+
+struct StreamTask {
+	enum StreamTaskType type;
+	enum StreamContext context;
+
+	struct Node *node;
+};
+
+// Nodes a stream holds across reductions, handed to every collection of the nursery
+
+struct StreamRoots {
+	struct StreamTask **tasks;
+	size_t *tasks_size;
+
+	struct Readback *readback;
+};
+
+#define STREAM_FLUSH_INTERVAL (CLOCKS_PER_SEC / 100)
+
+static void stream_push(struct StreamTask **tasks, size_t *size, size_t *capacity, struct StreamTask task);
+static void stream_head_print(FILE *stream, struct Readback *readback, struct Node *node);
+static void stream_roots(struct Evaluation *evaluation, void *context);
+
+// Printing with sharing
+// Nodes reached through several edges are printed once, as let bindings placed right below the innermost binder they
+// refer to, so the output grows with the graph rather than with the tree it unfolds to.
+
+struct SharedNode {
+	struct Node *node;
+
+	size_t references;		// Incoming edges within the reachable graph
+	size_t position;		// Scope depth of an abstraction during the analysis
+
+	const size_t *free;		// Ascending scope depths of the binders the node refers to
+	size_t free_size;
+
+	struct Node *placement;		// Innermost binder the node refers to, NULL for closed nodes
+	size_t name;			// Number of the let binding, 0 for unshared nodes
+
+	struct SharedNode *lets;	// Bindings placed right below this abstraction, in dependency order
+	struct SharedNode *lets_last;
+	struct SharedNode *next;	// Next binding placed below the same abstraction
+};
+
+struct Sharing {
+	struct Readback readback;	// Scope and binder naming
+	struct Arena arena;
+
+	FILE *stream;
+	size_t budget;			// Nodes left to print before truncating
+
+	// Open addressing table of the abstractions and applications, keyed by node
+
+	struct SharedNode **entries;
+	size_t entries_size;
+	size_t entries_capacity;
+
+	// Abstractions enclosing the node being analyzed
+
+	struct Node **binders;
+	size_t binders_size;
+	size_t binders_capacity;
+
+	// Entries in the order their analysis completed, so every node follows its subterms
+
+	struct SharedNode **postorder;
+	size_t postorder_size;
+	size_t postorder_capacity;
+
+	struct SharedNode top;		// Holds the closed bindings, printed before the term
+};
+
+static struct SharedNode *sharing_analyze(struct Sharing *sharing, struct Node *node);
+static void sharing_free_merge(struct Sharing *sharing, struct SharedNode *entry, struct Node *left, struct Node *right);
+static void sharing_free_get(struct Sharing *sharing, struct Node *node, const size_t **free, size_t *free_size);
+static void sharing_lets_assign(struct Sharing *sharing);
+
+static void shared_print(struct Sharing *sharing, struct Node *node);
+static void shared_term_print(struct Sharing *sharing, struct Node *node);
+static void shared_lets_print(struct Sharing *sharing, const struct SharedNode *lets);
+static int shared_is_abstraction(struct Sharing *sharing, struct Node *node);
+static int shared_is_application(struct Sharing *sharing, struct Node *node);
+static void identifier_print(FILE *stream, const struct Identifier *identifier);
+
+static struct SharedNode *sharing_get(struct Sharing *sharing, struct Node *node);
+static struct SharedNode *sharing_insert(struct Sharing *sharing, struct Node *node);
+static void sharing_scale(struct Sharing *sharing);
+static size_t node_hash(const struct Node *node);
+static void *array_push(void *array, size_t *size, size_t *capacity, size_t element_size, const void *element);
+
+struct LambdaHandle evaluation_readback(struct Evaluation *evaluation)
+{
+	struct Readback readback = {0};
+
+	if (evaluation->root == NULL) {
+		return readback.lambda;
+	}
+
+	names_collect(&readback, evaluation);
+
+	readback.lambda.free_variables_capacity = INITIAL_CAPACITY;
+	readback.lambda.free_variables = malloc(sizeof(*readback.lambda.free_variables) * readback.lambda.free_variables_capacity);
+
+	if (readback.lambda.free_variables == NULL) {
+		goto fatal_error;
+	}
+
+	if (evaluation->folding) {
+		readback.definitions = evaluation->definitions;
+		readback.folding = 1;
+	}
+
+	readback.stats = &evaluation->stats;
+
+	struct Shape shape;
+
+	readback.lambda.term = node_readback(&readback, evaluation->root, &shape);
+
+	if (readback.cancelled) {
+		lambda_free_deferred(readback.lambda);
+
+		readback.lambda = (struct LambdaHandle){0};
+	}
+
+	evaluation->stats.truncated = readback.truncated;
+
+	free(readback.binders);
+	free(readback.identifiers);
+	free(readback.names);
+	free(readback.tasks);
+	free(readback.results);
+
+	return readback.lambda;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function evaluation_readback().\n");
+	exit(1);
+}
+
+struct LambdaTerm *node_readback(struct Readback *readback, struct Node *node, struct Shape *shape)
+{
+	// Subterms are read back off a stack of tasks, and their terms wait on a stack of results until the term enclosing
+	// them is complete, so deep results don't deepen the C stack. Functions are read back before their arguments, as
+	// they would be recursively, so binders and free variables are named in the same order
+
+	task_push(readback, READBACK_NODE, node, NULL);
+
+	while (readback->tasks_size > 0) {
+		struct ReadbackTask task = readback->tasks[--readback->tasks_size];
+
+		struct ReadbackResult result;
+
+		switch (task.type) {
+		case READBACK_NODE:
+			if (!node_step(readback, task.node, &result)) {
+				continue;
+			}
+
+			break;
+
+		case READBACK_APPLICATION:
+		case READBACK_FIXPOINT: {
+			// The shape of the function becomes the shape of the application
+
+			struct ReadbackResult argument = readback->results[--readback->results_size];
+
+			result = readback->results[--readback->results_size];
+
+			struct LambdaTerm *term = term_create(APPLICATION);
+
+			term->expression.application.function = result.term;
+			term->expression.application.argument = argument.term;
+
+			result.shape.fingerprint = fingerprint_application(result.shape.fingerprint, argument.shape.fingerprint);
+
+			if (task.type == READBACK_APPLICATION && result.shape.variable == 1 && argument.shape.chain >= 0) {
+				result.shape.chain = argument.shape.chain + 1;
+			} else {
+				result.shape.chain = -1;
+			}
+
+			result.shape.variable = -1;
+			result.shape.half = -1;
+
+			result.term = term_fold(readback, term, &result.shape);
+
+			break;
+		}
+
+		case READBACK_ABSTRACTION: {
+			struct ReadbackResult body = readback->results[--readback->results_size];
+
+			readback->scope_size--;
+
+			struct LambdaTerm *term = task.term;
+
+			term->expression.abstraction.body = body.term;
+
+			result.shape.fingerprint = fingerprint_abstraction(body.shape.fingerprint);
+			result.shape.variable = -1;
+			result.shape.chain = -1;
+			result.shape.half = body.shape.chain;
+
+			if (readback->folding && body.shape.half >= 0) {
+				// λf.λx.f (f ... (f x)) is a Church numeral
+
+				lambda_free((struct LambdaHandle){.term = term});
+
+				result.term = term_create(CHURCH_NUMERAL);
+				result.term->expression.church_numeral = body.shape.half;
+
+				result.shape.half = -1;
+
+				break;
+			}
+
+			result.term = term_fold(readback, term, &result.shape);
+
+			break;
+		}
+
+		case READBACK_UNVISIT:
+			task.node->flags &= ~NODE_VISITING;
+
+			continue;
+		}
+
+		readback->results = array_push(readback->results, &readback->results_size, &readback->results_capacity, sizeof(result), &result);
+	}
+
+	struct ReadbackResult result = readback->results[--readback->results_size];
+
+	*shape = result.shape;
+
+	return result.term;
+}
+
+int node_step(struct Readback *readback, struct Node *node, struct ReadbackResult *result)
+{
+	// Reads a leaf back into result and returns 1, or pushes the tasks reading back the subterms of node and returns 0
+
+	node = node_forward(node);
+
+	struct Shape *shape = &result->shape;
+
+	shape->variable = -1;
+	shape->chain = -1;
+	shape->half = -1;
+
+	// Once cancelled, the remaining subterms are replaced by placeholders so the partial term can be released
+
+	if (!readback->cancelled && (++readback->visited & (EVALUATION_POLL_INTERVAL - 1)) == 0 && !evaluation_poll(readback->stats)) {
+		readback->cancelled = 1;
+	}
+
+	if (readback->cancelled) {
+		shape->fingerprint = 0;
+
+		result->term = term_create(CHURCH_NUMERAL);
+		result->term->expression.church_numeral = 0;
+
+		return 1;
+	}
+
+	// Past the node limit, they are elided instead, so a partial result sharing its subterms all over can still be
+	// printed
+
+	if (readback->visited > READBACK_NODE_LIMIT) {
+		static const struct Identifier elided = {"...", -1};
+
+		readback->truncated = 1;
+
+		shape->fingerprint = 0;
+
+		result->term = free_variable_readback(readback, &elided);
+
+		return 1;
+	}
+
+	switch (node->type) {
+	case NODE_CHURCH_NUMERAL:
+		result->term = term_create(CHURCH_NUMERAL);
+		result->term->expression.church_numeral = node->church_numeral;
+
+		shape->fingerprint = fingerprint_church_numeral(node->church_numeral);
+
+		return 1;
+
+	case NODE_VARIABLE:
+		result->term = variable_readback(readback, node, shape);
+
+		return 1;
+
+	case NODE_FREE_VARIABLE:
+		shape->fingerprint = fingerprint_free_variable(node->free_variable);
+
+		result->term = free_variable_readback(readback, node->free_variable);
+
+		return 1;
+
+	case NODE_REFERENCE:
+		// Definitions which were never unfolded, or which recursively refer to themselves, are printed by name
+
+		if (node->reference->unfolded == NULL || (node->flags & NODE_VISITING)) {
+			shape->fingerprint = fingerprint_free_variable(&node->reference->definition.identifier);
+
+			result->term = free_variable_readback(readback, &node->reference->definition.identifier);
+
+			return 1;
+		}
+
+		node->flags |= NODE_VISITING;
+
+		task_push(readback, READBACK_UNVISIT, node, NULL);
+		task_push(readback, READBACK_NODE, node->reference->unfolded, NULL);
+
+		return 0;
+
+	case NODE_FIXPOINT:
+		// Likewise, fixpoints without a value or met again inside it are printed as their combinator application
+
+		if (node->fixpoint->unfolded == NULL || (node->flags & NODE_VISITING)) {
+			return fixpoint_step(readback, node->fixpoint, result);
+		}
+
+		node->flags |= NODE_VISITING;
+
+		task_push(readback, READBACK_UNVISIT, node, NULL);
+		task_push(readback, READBACK_NODE, node->fixpoint->unfolded, NULL);
+
+		return 0;
+
+	case NODE_ABSTRACTION: {
+		struct LambdaTerm *term = term_create(ABSTRACTION);
+
+		term->expression.abstraction.bound_variable = identifier_fresh(readback, node->abstraction.bound_variable);
+
+		scope_push(readback, node, term->expression.abstraction.bound_variable);
+
+		task_push(readback, READBACK_ABSTRACTION, node, term);
+		task_push(readback, READBACK_NODE, node->abstraction.body, NULL);
+
+		return 0;
+	}
+
+	case NODE_APPLICATION:
+		task_push(readback, READBACK_APPLICATION, node, NULL);
+		task_push(readback, READBACK_NODE, node->application.argument, NULL);
+		task_push(readback, READBACK_NODE, node->application.function, NULL);
+
+		return 0;
+
+	default:
+		return 0;
+	}
+}
+
+struct LambdaTerm *variable_readback(struct Readback *readback, struct Node *node, struct Shape *shape)
+{
+	// The bound variable shares the name owned by its abstraction term
+
+	for (size_t i = readback->scope_size; i > 0; i--) {
+		if (readback->binders[i - 1] != node->binder) {
+			continue;
+		}
+
+		struct LambdaTerm *term = term_create(BOUND_VARIABLE);
+
+		term->expression.variable = readback->identifiers[i - 1];
+
+		shape->variable = (int)(readback->scope_size - i);
+		shape->chain = shape->variable == 0 ? 0 : -1;
+		shape->fingerprint = fingerprint_variable(readback->scope_size - i);
+
+		return term;
+	}
+
+	// A variable whose binder lies outside the graph being read back
+
+	shape->fingerprint = fingerprint_free_variable(node->binder->abstraction.bound_variable);
+
+	return free_variable_readback(readback, node->binder->abstraction.bound_variable);
+}
+
+struct LambdaTerm *free_variable_readback(struct Readback *readback, const struct Identifier *identifier)
+{
+	struct LambdaHandle *lambda = &readback->lambda;
+
+	struct LambdaTerm *term = term_create(FREE_VARIABLE);
+
+	// Reusing the free_variables entry of the same name
+
+	for (size_t i = 0; i < lambda->free_variables_size; i++) {
+		struct Identifier free_variable = lambda->free_variables[i];
+
+		if (free_variable.subscript == identifier->subscript && strcmp(free_variable.name, identifier->name) == 0) {
+			term->expression.variable = free_variable;
+
+			return term;
+		}
+	}
+
+	if (lambda->free_variables_capacity == lambda->free_variables_size) {
+		// Scaling factor of 2
+
+		lambda->free_variables_capacity <<= 1;
+		lambda->free_variables = realloc(lambda->free_variables, sizeof(*lambda->free_variables) * lambda->free_variables_capacity);
+
+		if (lambda->free_variables == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	struct Identifier free_variable;
+
+	free_variable.name = string_copy(identifier->name);
+	free_variable.subscript = identifier->subscript;
+
+	lambda->free_variables[lambda->free_variables_size++] = free_variable;
+
+	term->expression.variable = free_variable;
+
+	return term;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function free_variable_readback().\n");
+	exit(1);
+}
+
+int fixpoint_step(struct Readback *readback, const struct Fixpoint *fixpoint, struct ReadbackResult *result)
+{
+	// A combinator coming from a definition keeps its name instead of showing its graph
+
+	struct Node *combinator = node_forward(fixpoint->combinator);
+
+	task_push(readback, READBACK_FIXPOINT, NULL, NULL);
+	task_push(readback, READBACK_NODE, fixpoint->function, NULL);
+
+	if (combinator->type != NODE_REFERENCE) {
+		task_push(readback, READBACK_NODE, combinator, NULL);
+
+		return 0;
+	}
+
+	result->shape.fingerprint = fingerprint_free_variable(&combinator->reference->definition.identifier);
+	result->term = free_variable_readback(readback, &combinator->reference->definition.identifier);
+
+	return 1;
+}
+
+void task_push(struct Readback *readback, enum ReadbackTaskType type, struct Node *node, struct LambdaTerm *term)
+{
+	struct ReadbackTask task = {type, node, term};
+
+	readback->tasks = array_push(readback->tasks, &readback->tasks_size, &readback->tasks_capacity, sizeof(task), &task);
+}
+
+struct LambdaTerm *term_fold(struct Readback *readback, struct LambdaTerm *term, struct Shape *shape)
+{
+	// Lookups are constant time, so every abstraction and application can be tried
+
+	struct Identifier identifier;
+
+	if (readback->definitions == NULL || !hashmap_find(readback->definitions, shape->fingerprint, &identifier)) {
+		return term;
+	}
+
+	// The shape still describes the structure, so enclosing terms fold as if it had been kept
+
+	lambda_free((struct LambdaHandle){.term = term});
+
+	return free_variable_readback(readback, &identifier);
+}
+
+struct LambdaHandle lambda_fold(struct LambdaHandle lambda, const struct HashMap *definitions)
+{
+	// Shapes are computed as node_readback() does, bottom up off a stack of tasks, and the term is rebuilt from its
+	// folded subterms. Bound variables share the name owned by their abstraction term, which tells their binder
+
+	struct Readback readback = {0};
+
+	if (lambda.term == NULL) {
+		return lambda;
+	}
+
+	readback.lambda = lambda;
+	readback.definitions = definitions;
+	readback.folding = 1;
+
+	struct FoldTask *tasks = NULL;
+	size_t tasks_size = 0;
+	size_t tasks_capacity = 0;
+
+	const struct LambdaTerm **binders = NULL;
+	size_t binders_size = 0;
+	size_t binders_capacity = 0;
+
+	struct FoldTask task = {FOLD_TERM, lambda.term};
+
+	tasks = array_push(tasks, &tasks_size, &tasks_capacity, sizeof(task), &task);
+
+	while (tasks_size > 0) {
+		task = tasks[--tasks_size];
+
+		struct LambdaTerm *term = task.term;
+
+		struct ReadbackResult result = {term, {0, -1, -1, -1}};
+
+		switch (task.type) {
+		case FOLD_TERM:
+			switch (term->type) {
+			case ABSTRACTION:
+				binders = array_push(binders, &binders_size, &binders_capacity, sizeof(term), &term);
+
+				task = (struct FoldTask){FOLD_ABSTRACTION, term};
+				tasks = array_push(tasks, &tasks_size, &tasks_capacity, sizeof(task), &task);
+
+				task = (struct FoldTask){FOLD_TERM, term->expression.abstraction.body};
+				tasks = array_push(tasks, &tasks_size, &tasks_capacity, sizeof(task), &task);
+
+				continue;
+
+			case APPLICATION:
+				task = (struct FoldTask){FOLD_APPLICATION, term};
+				tasks = array_push(tasks, &tasks_size, &tasks_capacity, sizeof(task), &task);
+
+				task = (struct FoldTask){FOLD_TERM, term->expression.application.argument};
+				tasks = array_push(tasks, &tasks_size, &tasks_capacity, sizeof(task), &task);
+
+				task = (struct FoldTask){FOLD_TERM, term->expression.application.function};
+				tasks = array_push(tasks, &tasks_size, &tasks_capacity, sizeof(task), &task);
+
+				continue;
+
+			case BOUND_VARIABLE:
+				for (size_t i = binders_size; i > 0; i--) {
+					if (binders[i - 1]->expression.abstraction.bound_variable.name == term->expression.variable.name) {
+						result.shape.variable = (int)(binders_size - i);
+						result.shape.chain = result.shape.variable == 0 ? 0 : -1;
+						result.shape.fingerprint = fingerprint_variable(binders_size - i);
+
+						break;
+					}
+				}
+
+				break;
+
+			case FREE_VARIABLE:
+				result.shape.fingerprint = fingerprint_free_variable(&term->expression.variable);
+
+				break;
+
+			case CHURCH_NUMERAL:
+				result.shape.fingerprint = fingerprint_church_numeral(term->expression.church_numeral);
+
+				break;
+
+			default:
+				break;
+			}
+
+			break;
+
+		case FOLD_APPLICATION: {
+			struct ReadbackResult argument = readback.results[--readback.results_size];
+			struct ReadbackResult function = readback.results[--readback.results_size];
+
+			term->expression.application.function = function.term;
+			term->expression.application.argument = argument.term;
+
+			result.shape.fingerprint = fingerprint_application(function.shape.fingerprint, argument.shape.fingerprint);
+
+			if (function.shape.variable == 1 && argument.shape.chain >= 0) {
+				result.shape.chain = argument.shape.chain + 1;
+			}
+
+			result.term = term_fold(&readback, term, &result.shape);
+
+			break;
+		}
+
+		case FOLD_ABSTRACTION: {
+			struct ReadbackResult body = readback.results[--readback.results_size];
+
+			binders_size--;
+
+			term->expression.abstraction.body = body.term;
+
+			result.shape.fingerprint = fingerprint_abstraction(body.shape.fingerprint);
+			result.shape.half = body.shape.chain;
+
+			if (body.shape.half >= 0) {
+				// λf.λx.f (f ... (f x)) is a Church numeral
+
+				lambda_free((struct LambdaHandle){.term = term});
+
+				result.term = term_create(CHURCH_NUMERAL);
+				result.term->expression.church_numeral = body.shape.half;
+
+				result.shape.half = -1;
+
+				break;
+			}
+
+			result.term = term_fold(&readback, term, &result.shape);
+
+			break;
+		}
+		}
+
+		readback.results = array_push(readback.results, &readback.results_size, &readback.results_capacity, sizeof(result), &result);
+	}
+
+	readback.lambda.term = readback.results[0].term;
+
+	free(tasks);
+	free(binders);
+	free(readback.results);
+
+	return readback.lambda;
+}
+
+void scope_push(struct Readback *readback, struct Node *binder, struct Identifier identifier)
+{
+	if (readback->scope_capacity == readback->scope_size) {
+		// Scaling factor of 2
+
+		readback->scope_capacity = readback->scope_capacity == 0 ? INITIAL_CAPACITY : readback->scope_capacity << 1;
+
+		readback->binders = realloc(readback->binders, sizeof(*readback->binders) * readback->scope_capacity);
+		readback->identifiers = realloc(readback->identifiers, sizeof(*readback->identifiers) * readback->scope_capacity);
+
+		if (readback->binders == NULL || readback->identifiers == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	readback->binders[readback->scope_size] = binder;
+	readback->identifiers[readback->scope_size] = identifier;
+	readback->scope_size++;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function scope_push().\n");
+	exit(1);
+}
+
+struct Identifier identifier_fresh(struct Readback *readback, const struct Identifier *hint)
+{
+	struct Identifier identifier;
+
+	int subscript = hint->subscript;
+
+	while (identifier_used(readback, hint->name, subscript)) {
+		subscript = subscript < 0 ? 1 : subscript + 1;
+	}
+
+	identifier.name = string_copy(hint->name);
+	identifier.subscript = subscript;
+
+	return identifier;
+}
+
+int identifier_used(struct Readback *readback, const char *name, int subscript)
+{
+	// Checking the enclosing binders
+
+	for (size_t i = 0; i < readback->scope_size; i++) {
+		struct Identifier bound_variable = readback->identifiers[i];
+
+		if (bound_variable.subscript == subscript && strcmp(bound_variable.name, name) == 0) {
+			return 1;
+		}
+	}
+
+	// Checking the names the result could refer to freely
+
+	size_t mask = readback->names_capacity - 1;
+	size_t index = name_hash(name, subscript) & mask;
+
+	while (readback->names[index] != NULL) {
+		const struct Identifier *identifier = readback->names[index];
+
+		if (identifier->subscript == subscript && strcmp(identifier->name, name) == 0) {
+			return 1;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	return 0;
+}
+
+void names_collect(struct Readback *readback, const struct Evaluation *evaluation)
+{
+	// Sized for a load factor of at most one half
+
+	size_t count = 0;
+
+	const struct Linker *linker = &evaluation->linker;
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		if (linker->linkages[i] != NULL) {
+			count += linker->linkages[i]->definition.free_variables_size + 1;
+		}
+	}
+
+	readback->names_capacity = INITIAL_CAPACITY;
+
+	while (readback->names_capacity < count << 1) {
+		readback->names_capacity <<= 1;
+	}
+
+	readback->names = calloc(readback->names_capacity, sizeof(*readback->names));
+
+	if (readback->names == NULL) {
+		goto fatal_error;
+	}
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		const struct Linkage *linkage = linker->linkages[i];
+
+		if (linkage == NULL) {
+			continue;
+		}
+
+		if (linkage->definition.identifier.name != NULL) {
+			names_insert(readback, &linkage->definition.identifier);
+		}
+
+		for (size_t j = 0; j < linkage->definition.free_variables_size; j++) {
+			names_insert(readback, linkage->definition.free_variables + j);
+		}
+	}
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function names_collect().\n");
+	exit(1);
+}
+
+void names_insert(struct Readback *readback, const struct Identifier *identifier)
+{
+	size_t mask = readback->names_capacity - 1;
+	size_t index = name_hash(identifier->name, identifier->subscript) & mask;
+
+	while (readback->names[index] != NULL) {
+		const struct Identifier *entry = readback->names[index];
+
+		if (entry->subscript == identifier->subscript && strcmp(entry->name, identifier->name) == 0) {
+			return;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	readback->names[index] = identifier;
+}
+
+size_t name_hash(const char *name, int subscript)
+{
+	// FNV-1a, as in the hashmap
+
+	size_t hash = 14695981039346656037UL;
+
+	for (const char *c = name; *c != '\0'; c++) {
+		hash ^= (size_t)(unsigned char)*c;
+		hash *= 1099511628211UL;
+	}
+
+	return 31 * hash + (size_t)subscript;
+}
+
+struct LambdaTerm *term_create(enum ExpressionType type)
+{
+	struct LambdaTerm *term = malloc(sizeof(*term));
+
+	if (term == NULL) {
+		goto fatal_error;
+	}
+
+	term->type = type;
+
+	return term;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function term_create().\n");
+	exit(1);
+}
+
+char *string_copy(const char *string)
+{
+	size_t size = strlen(string) + 1;
+
+	char *copy = malloc(size);
+
+	if (copy == NULL) {
+		goto fatal_error;
+	}
+
+	memcpy(copy, string, size);
+
+	return copy;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function string_copy().\n");
+	exit(1);
+}
+
+int evaluation_stream(FILE *stream, struct Evaluation *evaluation)
+{
+	struct Readback readback = {0};
+
+	if (evaluation->root == NULL) {
+		return 1;
+	}
+
+	names_collect(&readback, evaluation);
+
+	struct StreamTask *tasks = NULL;
+
+	size_t tasks_size = 0;
+	size_t tasks_capacity = 0;
+
+	stream_push(&tasks, &tasks_size, &tasks_capacity, (struct StreamTask){STREAM_TERM, STREAM_BODY, evaluation->root});
+
+	struct StreamRoots roots = {&tasks, &tasks_size, &readback};
+
+	evaluation->roots = stream_roots;
+	evaluation->roots_context = &roots;
+
+	clock_t flushed = clock();
+
+	while (tasks_size > 0) {
+		struct StreamTask task = tasks[--tasks_size];
+
+		if (task.type == STREAM_CLOSE) {
+			fputc(')', stream);
+			continue;
+		}
+
+		if (task.type == STREAM_SCOPE_POP) {
+			free(readback.identifiers[--readback.scope_size].name);
+			continue;
+		}
+
+		// Once a limit is hit, the rest of the term is cut and only parentheses get closed
+
+		if (evaluation->stats.status != EVALUATION_PENDING) {
+			continue;
+		}
+
+		// Whatever was printed so far is shown before a reduction that may take a while
+
+		if (clock() - flushed >= STREAM_FLUSH_INTERVAL) {
+			fflush(stream);
+			flushed = clock();
+		}
+
+		struct Node *node = evaluation_whnf(evaluation, task.node);
+
+		if (evaluation->stats.status != EVALUATION_PENDING) {
+			fputs(task.context == STREAM_BODY ? "..." : " ...", stream);
+			continue;
+		}
+
+		// Arguments are separated by a space unless they are parenthesized, as in lambda_fprint()
+
+		int parentheses = task.context != STREAM_BODY &&
+			(node->type == NODE_APPLICATION || (node->type == NODE_ABSTRACTION && task.context == STREAM_INNER_ARGUMENT));
+
+		if (parentheses) {
+			fputc('(', stream);
+			stream_push(&tasks, &tasks_size, &tasks_capacity, (struct StreamTask){STREAM_CLOSE, STREAM_BODY, NULL});
+		} else if (task.context != STREAM_BODY) {
+			fputc(' ', stream);
+		}
+
+		if (node->type == NODE_ABSTRACTION) {
+			struct Identifier identifier = identifier_fresh(&readback, node->abstraction.bound_variable);
+
+			if (identifier.subscript < 0) {
+				fprintf(stream, "λ%s.", identifier.name);
+			} else {
+				fprintf(stream, "λ%s%d.", identifier.name, identifier.subscript);
+			}
+
+			scope_push(&readback, node, identifier);
+
+			stream_push(&tasks, &tasks_size, &tasks_capacity, (struct StreamTask){STREAM_SCOPE_POP, STREAM_BODY, NULL});
+			stream_push(&tasks, &tasks_size, &tasks_capacity, (struct StreamTask){STREAM_TERM, STREAM_BODY, abstraction_open(node)});
+
+			continue;
+		}
+
+		if (node->type != NODE_APPLICATION) {
+			stream_head_print(stream, &readback, node);
+			continue;
+		}
+
+		// A stuck application: its head is printed right away, its arguments are scheduled from left to right
+
+		enum StreamContext context = STREAM_ARGUMENT;
+
+		while (node->type == NODE_APPLICATION) {
+			stream_push(&tasks, &tasks_size, &tasks_capacity, (struct StreamTask){STREAM_TERM, context, node->application.argument});
+
+			context = STREAM_INNER_ARGUMENT;
+			node = node_dereference(node->application.function);
+		}
+
+		stream_head_print(stream, &readback, node);
+	}
+
+	evaluation->roots = NULL;
+	evaluation->roots_context = NULL;
+
+	free(tasks);
+	free(readback.binders);
+	free(readback.identifiers);
+	free(readback.names);
+
+	fflush(stream);
+
+	if (evaluation->stats.status != EVALUATION_PENDING) {
+		return 0;
+	}
+
+	evaluation->stats.status = EVALUATION_NORMAL_FORM;
+
+	return 1;
+}
+
+void stream_head_print(FILE *stream, struct Readback *readback, struct Node *node)
+{
+	switch (node->type) {
+	case NODE_CHURCH_NUMERAL:
+		fprintf(stream, "%d", node->church_numeral);
+		return;
+
+	case NODE_VARIABLE:
+		for (size_t i = readback->scope_size; i > 0; i--) {
+			if (readback->binders[i - 1] == node->binder) {
+				identifier_print(stream, readback->identifiers + i - 1);
+				return;
+			}
+		}
+
+		identifier_print(stream, node->binder->abstraction.bound_variable);
+		return;
+
+	case NODE_FREE_VARIABLE:
+		identifier_print(stream, node->free_variable);
+		return;
+
+	case NODE_REFERENCE:
+		identifier_print(stream, &node->reference->definition.identifier);
+		return;
+
+	default:
+		return;
+	}
+}
+
+void stream_roots(struct Evaluation *evaluation, void *context)
+{
+	// Binders in scope are compared with the binders of the variables printed, which move along with them
+
+	struct StreamRoots *roots = context;
+
+	for (size_t i = 0; i < *roots->tasks_size; i++) {
+		evaluation_evacuate(evaluation, &(*roots->tasks)[i].node);
+	}
+
+	for (size_t i = 0; i < roots->readback->scope_size; i++) {
+		evaluation_evacuate(evaluation, &roots->readback->binders[i]);
+	}
+}
+
+void stream_push(struct StreamTask **tasks, size_t *size, size_t *capacity, struct StreamTask task)
+{
+	*tasks = array_push(*tasks, size, capacity, sizeof(**tasks), &task);
+}
+
+void evaluation_fprint_shared(FILE *stream, struct Evaluation *evaluation, size_t limit)
+{
+	struct Sharing sharing = {0};
+
+	if (evaluation->root == NULL) {
+		return;
+	}
+
+	sharing.arena = arena_create();
+	sharing.stream = stream;
+	sharing.budget = limit == 0 ? SIZE_MAX : limit;
+
+	sharing.entries_capacity = INITIAL_CAPACITY;
+	sharing.entries = calloc(sharing.entries_capacity, sizeof(*sharing.entries));
+
+	if (sharing.entries == NULL) {
+		goto fatal_error;
+	}
+
+	names_collect(&sharing.readback, evaluation);
+
+	// A definition standing for the whole term is shown unfolded
+
+	struct Node *root = node_dereference(evaluation->root);
+
+	sharing_analyze(&sharing, root);
+	sharing_lets_assign(&sharing);
+
+	shared_lets_print(&sharing, sharing.top.lets);
+	shared_term_print(&sharing, root);
+
+	free(sharing.entries);
+	free(sharing.binders);
+	free(sharing.postorder);
+
+	free(sharing.readback.binders);
+	free(sharing.readback.identifiers);
+	free(sharing.readback.names);
+
+	arena_destroy(sharing.arena);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function evaluation_fprint_shared().\n");
+	exit(1);
+}
+
+struct SharedNode *sharing_analyze(struct Sharing *sharing, struct Node *node)
+{
+	// Counts the incoming edges of every abstraction and application and finds the binders each of them refers to
+	// Subterms are only visited through their first edge
+
+	node = node_forward(node);
+
+	// Fixpoints are printed as their combinator application, only its parts can be shared
+
+	if (node->type == NODE_FIXPOINT) {
+		sharing_analyze(sharing, node->fixpoint->combinator);
+		sharing_analyze(sharing, node->fixpoint->function);
+
+		return NULL;
+	}
+
+	if (node->type != NODE_ABSTRACTION && node->type != NODE_APPLICATION) {
+		return NULL;
+	}
+
+	struct SharedNode *entry = sharing_get(sharing, node);
+
+	if (entry != NULL) {
+		entry->references++;
+
+		return entry;
+	}
+
+	entry = sharing_insert(sharing, node);
+	entry->references = 1;
+
+	if (node->type == NODE_ABSTRACTION) {
+		entry->position = sharing->binders_size;
+
+		sharing->binders = array_push(sharing->binders, &sharing->binders_size, &sharing->binders_capacity, sizeof(*sharing->binders), &node);
+
+		sharing_analyze(sharing, node->abstraction.body);
+
+		sharing->binders_size--;
+
+		sharing_free_merge(sharing, entry, node->abstraction.body, NULL);
+
+		// The variable of the abstraction is bound, and being the innermost binder it comes last
+
+		if (entry->free_size > 0 && entry->free[entry->free_size - 1] == entry->position) {
+			entry->free_size--;
+		}
+	} else {
+		sharing_analyze(sharing, node->application.function);
+		sharing_analyze(sharing, node->application.argument);
+
+		sharing_free_merge(sharing, entry, node->application.function, node->application.argument);
+	}
+
+	if (entry->free_size > 0) {
+		entry->placement = sharing->binders[entry->free[entry->free_size - 1]];
+	}
+
+	sharing->postorder = array_push(sharing->postorder, &sharing->postorder_size, &sharing->postorder_capacity, sizeof(*sharing->postorder), &entry);
+
+	return entry;
+}
+
+void sharing_free_merge(struct Sharing *sharing, struct SharedNode *entry, struct Node *left, struct Node *right)
+{
+	// Union of two ascending lists, sharing either of them when the other is empty
+
+	const size_t *left_free, *right_free;
+	size_t left_size, right_size;
+
+	sharing_free_get(sharing, left, &left_free, &left_size);
+	sharing_free_get(sharing, right, &right_free, &right_size);
+
+	if (right_size == 0 || left_free == right_free) {
+		entry->free = left_free;
+		entry->free_size = left_size;
+
+		return;
+	}
+
+	if (left_size == 0) {
+		entry->free = right_free;
+		entry->free_size = right_size;
+
+		return;
+	}
+
+	size_t *free = arena_alloc(&sharing->arena, sizeof(*free) * (left_size + right_size));
+	size_t size = 0;
+
+	size_t i = 0;
+	size_t j = 0;
+
+	while (i < left_size || j < right_size) {
+		if (j == right_size || (i < left_size && left_free[i] < right_free[j])) {
+			free[size++] = left_free[i++];
+		} else if (i == left_size || right_free[j] < left_free[i]) {
+			free[size++] = right_free[j++];
+		} else {
+			free[size++] = left_free[i++];
+			j++;
+		}
+	}
+
+	entry->free = free;
+	entry->free_size = size;
+}
+
+void sharing_free_get(struct Sharing *sharing, struct Node *node, const size_t **free, size_t *free_size)
+{
+	*free = NULL;
+	*free_size = 0;
+
+	if (node == NULL) {
+		return;
+	}
+
+	node = node_forward(node);
+
+	if (node->type == NODE_VARIABLE) {
+		struct SharedNode *binder = sharing_get(sharing, node->binder);
+
+		// Binders outside the printed graph are ignored
+
+		if (binder != NULL) {
+			*free = &binder->position;
+			*free_size = 1;
+		}
+
+		return;
+	}
+
+	struct SharedNode *entry = sharing_get(sharing, node);
+
+	if (entry != NULL) {
+		*free = entry->free;
+		*free_size = entry->free_size;
+	}
+}
+
+void sharing_lets_assign(struct Sharing *sharing)
+{
+	// Bindings are numbered and attached to their placement in postorder, so each one only uses earlier ones
+
+	size_t name = 0;
+
+	for (size_t i = 0; i < sharing->postorder_size; i++) {
+		struct SharedNode *entry = sharing->postorder[i];
+
+		if (entry->references < 2) {
+			continue;
+		}
+
+		entry->name = ++name;
+
+		struct SharedNode *placement = entry->placement == NULL ? &sharing->top : sharing_get(sharing, entry->placement);
+
+		if (placement->lets == NULL) {
+			placement->lets = entry;
+		} else {
+			placement->lets_last->next = entry;
+		}
+
+		placement->lets_last = entry;
+	}
+}
+
+void shared_print(struct Sharing *sharing, struct Node *node)
+{
+	// Shared nodes are printed by name, anything else in full
+
+	node = node_forward(node);
+
+	struct SharedNode *entry = sharing_get(sharing, node);
+
+	if (entry != NULL && entry->name != 0) {
+		fprintf(sharing->stream, "$%zu", entry->name);
+
+		return;
+	}
+
+	shared_term_print(sharing, node);
+}
+
+void shared_term_print(struct Sharing *sharing, struct Node *node)
+{
+	FILE *stream = sharing->stream;
+
+	if (sharing->budget == 0) {
+		fputs("...", stream);
+
+		return;
+	}
+
+	sharing->budget--;
+
+	struct Readback *readback = &sharing->readback;
+
+	switch (node->type) {
+	case NODE_CHURCH_NUMERAL:
+		fprintf(stream, "%d", node->church_numeral);
+
+		break;
+
+	case NODE_VARIABLE:
+		for (size_t i = readback->scope_size; i > 0; i--) {
+			if (readback->binders[i - 1] == node->binder) {
+				identifier_print(stream, readback->identifiers + i - 1);
+
+				return;
+			}
+		}
+
+		identifier_print(stream, node->binder->abstraction.bound_variable);
+
+		break;
+
+	case NODE_FREE_VARIABLE:
+		identifier_print(stream, node->free_variable);
+
+		break;
+
+	case NODE_REFERENCE:
+		identifier_print(stream, &node->reference->definition.identifier);
+
+		break;
+
+	case NODE_FIXPOINT:
+		if (shared_is_abstraction(sharing, node->fixpoint->combinator)) {
+			fputc('(', stream);
+			shared_print(sharing, node->fixpoint->combinator);
+			fputc(')', stream);
+		} else {
+			shared_print(sharing, node->fixpoint->combinator);
+		}
+
+		fputs(shared_is_application(sharing, node->fixpoint->function) ? "(" : " ", stream);
+
+		shared_print(sharing, node->fixpoint->function);
+
+		if (shared_is_application(sharing, node->fixpoint->function)) {
+			fputc(')', stream);
+		}
+
+		break;
+
+	case NODE_ABSTRACTION:
+		struct Identifier identifier = identifier_fresh(readback, node->abstraction.bound_variable);
+
+		scope_push(readback, node, identifier);
+
+		fputs("λ", stream);
+		identifier_print(stream, &identifier);
+		fputc('.', stream);
+
+		shared_lets_print(sharing, sharing_get(sharing, node)->lets);
+		shared_print(sharing, node->abstraction.body);
+
+		readback->scope_size--;
+
+		free(identifier.name);
+
+		break;
+
+	case NODE_APPLICATION:
+		// Same parentheses as lambda_fprint(): abstractions extend as far right as possible
+
+		struct Node *function = node_forward(node->application.function);
+		struct Node *argument = node_forward(node->application.argument);
+
+		int function_parentheses = shared_is_abstraction(sharing, function) ||
+			(shared_is_application(sharing, function) && shared_is_abstraction(sharing, function->application.argument));
+
+		int argument_parentheses = shared_is_application(sharing, argument);
+
+		if (function_parentheses) {
+			fputc('(', stream);
+		}
+
+		shared_print(sharing, function);
+
+		fputs(function_parentheses ? ")" : "", stream);
+		fputs(argument_parentheses ? "(" : " ", stream);
+
+		shared_print(sharing, argument);
+
+		if (argument_parentheses) {
+			fputc(')', stream);
+		}
+
+		break;
+
+	default:
+		break;
+	}
+}
+
+void shared_lets_print(struct Sharing *sharing, const struct SharedNode *lets)
+{
+	for (const struct SharedNode *let = lets; let != NULL; let = let->next) {
+		fprintf(sharing->stream, "let $%zu = ", let->name);
+
+		shared_term_print(sharing, let->node);
+
+		fputs(" in ", sharing->stream);
+	}
+}
+
+int shared_is_abstraction(struct Sharing *sharing, struct Node *node)
+{
+	// Bindings print as atoms, and so does a truncated term
+
+	node = node_forward(node);
+
+	if (node->type != NODE_ABSTRACTION || sharing->budget == 0) {
+		return 0;
+	}
+
+	return sharing_get(sharing, node)->name == 0;
+}
+
+int shared_is_application(struct Sharing *sharing, struct Node *node)
+{
+	node = node_forward(node);
+
+	if (node->type != NODE_APPLICATION || sharing->budget == 0) {
+		return 0;
+	}
+
+	return sharing_get(sharing, node)->name == 0;
+}
+
+void identifier_print(FILE *stream, const struct Identifier *identifier)
+{
+	if (identifier->subscript < 0) {
+		fprintf(stream, "%s", identifier->name);
+	} else {
+		fprintf(stream, "%s%d", identifier->name, identifier->subscript);
+	}
+}
+
+struct SharedNode *sharing_get(struct Sharing *sharing, struct Node *node)
+{
+	size_t mask = sharing->entries_capacity - 1;
+	size_t index = node_hash(node) & mask;
+
+	while (sharing->entries[index] != NULL) {
+		if (sharing->entries[index]->node == node) {
+			return sharing->entries[index];
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	return NULL;
+}
+
+struct SharedNode *sharing_insert(struct Sharing *sharing, struct Node *node)
+{
+	// Load factor of at most one half
+
+	if (sharing->entries_size << 1 >= sharing->entries_capacity) {
+		sharing_scale(sharing);
+	}
+
+	struct SharedNode *entry = arena_alloc(&sharing->arena, sizeof(*entry));
+
+	memset(entry, 0, sizeof(*entry));
+	entry->node = node;
+
+	size_t mask = sharing->entries_capacity - 1;
+	size_t index = node_hash(node) & mask;
+
+	while (sharing->entries[index] != NULL) {
+		index = (index + 1) & mask;
+	}
+
+	sharing->entries[index] = entry;
+	sharing->entries_size++;
+
+	return entry;
+}
+
+void sharing_scale(struct Sharing *sharing)
+{
+	// Scaling factor of 2
+
+	struct SharedNode **entries = sharing->entries;
+	size_t capacity = sharing->entries_capacity;
+
+	sharing->entries_capacity <<= 1;
+	sharing->entries = calloc(sharing->entries_capacity, sizeof(*sharing->entries));
+
+	if (sharing->entries == NULL) {
+		goto fatal_error;
+	}
+
+	size_t mask = sharing->entries_capacity - 1;
+
+	for (size_t i = 0; i < capacity; i++) {
+		if (entries[i] == NULL) {
+			continue;
+		}
+
+		size_t index = node_hash(entries[i]->node) & mask;
+
+		while (sharing->entries[index] != NULL) {
+			index = (index + 1) & mask;
+		}
+
+		sharing->entries[index] = entries[i];
+	}
+
+	free(entries);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function sharing_scale().\n");
+	exit(1);
+}
+
+size_t node_hash(const struct Node *node)
+{
+	// Fibonacci hashing of the address, as for linkages
+
+	return (size_t)(((uintptr_t)node >> 4) * 11400714819323198485ULL);
+}
+
+void *array_push(void *array, size_t *size, size_t *capacity, size_t element_size, const void *element)
+{
+	if (*size == *capacity) {
+		// Scaling factor of 2
+
+		*capacity = *capacity == 0 ? INITIAL_CAPACITY : *capacity << 1;
+
+		array = realloc(array, element_size * *capacity);
+
+		if (array == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	memcpy((char *)array + *size * element_size, element, element_size);
+	(*size)++;
+
+	return array;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function array_push().\n");
+	exit(1);
+}
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include <reclaimer.h>
+#include <stdio.h>
+
+#define INITIAL_CAPACITY 16
+
+#ifdef __linux__
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Memory retired while readers may see it, with the epoch it was retired at
+
+struct Retired {
+	void *pointer;			// NULL when retiring a term
+	struct LambdaHandle lambda;
+
+	uint64_t epoch;
+};
+
+// Terms waiting to be freed, shared with the reclaimer thread under lock
+
+struct Reclaimer {
+	struct LambdaHandle *queue;
+	size_t queue_size;
+	size_t queue_capacity;
+
+	int started;
+	int busy;		// The thread is freeing a term it already took off the queue
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t queued;
+	pthread_cond_t drained;
+
+	// Epoch based reclamation, the retired list being shared by writers under its own lock
+
+	_Atomic uint64_t epoch;
+	_Atomic uint64_t readers[RECLAIM_READERS];	// Epoch each reader entered at, 0 for a free slot
+
+	struct Retired *retired;
+	size_t retired_size;
+	size_t retired_capacity;
+
+	pthread_mutex_t retired_lock;
+};
+
+static struct Reclaimer reclaimer = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.queued = PTHREAD_COND_INITIALIZER,
+	.drained = PTHREAD_COND_INITIALIZER,
+	.epoch = 1,
+	.retired_lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+static void *reclaimer_main(void *argument);
+static int lambda_is_small(struct LambdaHandle lambda);
+
+static void retired_push(struct Retired retired);
+static void retired_collect(void);
+
+void lambda_free_deferred(struct LambdaHandle lambda)
+{
+	if (lambda_is_small(lambda)) {
+		lambda_free(lambda);
+		return;
+	}
+
+	pthread_mutex_lock(&reclaimer.lock);
+
+	if (!reclaimer.started) {
+		// Falling back to freeing inline if no thread can be started
+
+		if (pthread_create(&reclaimer.thread, NULL, reclaimer_main, NULL) != 0) {
+			pthread_mutex_unlock(&reclaimer.lock);
+			lambda_free(lambda);
+
+			return;
+		}
+
+		reclaimer.started = 1;
+	}
+
+	if (reclaimer.queue_size == reclaimer.queue_capacity) {
+		// Scaling factor of 2
+
+		reclaimer.queue_capacity = reclaimer.queue_capacity == 0 ? INITIAL_CAPACITY : reclaimer.queue_capacity << 1;
+		reclaimer.queue = realloc(reclaimer.queue, sizeof(*reclaimer.queue) * reclaimer.queue_capacity);
+
+		if (reclaimer.queue == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	reclaimer.queue[reclaimer.queue_size++] = lambda;
+
+	pthread_cond_signal(&reclaimer.queued);
+	pthread_mutex_unlock(&reclaimer.lock);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function lambda_free_deferred().\n");
+	exit(1);
+}
+
+void reclaimer_finish(void)
+{
+	pthread_mutex_lock(&reclaimer.retired_lock);
+
+	retired_collect();
+
+	pthread_mutex_unlock(&reclaimer.retired_lock);
+
+	pthread_mutex_lock(&reclaimer.lock);
+
+	while (reclaimer.queue_size > 0 || reclaimer.busy) {
+		pthread_cond_wait(&reclaimer.drained, &reclaimer.lock);
+	}
+
+	pthread_mutex_unlock(&reclaimer.lock);
+}
+
+void *reclaimer_main(void *argument)
+{
+	(void)argument;
+
+	pthread_mutex_lock(&reclaimer.lock);
+
+	while (1) {
+		while (reclaimer.queue_size == 0) {
+			pthread_cond_wait(&reclaimer.queued, &reclaimer.lock);
+		}
+
+		struct LambdaHandle lambda = reclaimer.queue[--reclaimer.queue_size];
+
+		reclaimer.busy = 1;
+
+		pthread_mutex_unlock(&reclaimer.lock);
+
+		lambda_free(lambda);
+
+		pthread_mutex_lock(&reclaimer.lock);
+
+		reclaimer.busy = 0;
+
+		if (reclaimer.queue_size == 0) {
+			pthread_cond_broadcast(&reclaimer.drained);
+		}
+	}
+
+	return NULL;
+}
+
+int lambda_is_small(struct LambdaHandle lambda)
+{
+	// Counting stops past the limit, so sizing a huge term costs no more than freeing a small one
+
+	struct LambdaTerm *terms[RECLAIM_INLINE_LIMIT + 2];
+	size_t terms_size = 0;
+	size_t count = 0;
+
+	if (lambda.term != NULL) {
+		terms[terms_size++] = lambda.term;
+	}
+
+	while (terms_size > 0) {
+		struct LambdaTerm *term = terms[--terms_size];
+
+		if (++count > RECLAIM_INLINE_LIMIT) {
+			return 0;
+		}
+
+		switch (term->type) {
+		case ABSTRACTION:
+			terms[terms_size++] = term->expression.abstraction.body;
+			break;
+
+		case APPLICATION:
+			terms[terms_size++] = term->expression.application.function;
+			terms[terms_size++] = term->expression.application.argument;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return 1;
+}
+
+size_t reclaimer_enter(void)
+{
+	while (1) {
+		uint64_t epoch = atomic_load(&reclaimer.epoch);
+
+		for (size_t reader = 0; reader < RECLAIM_READERS; reader++) {
+			uint64_t free_slot = 0;
+
+			if (atomic_compare_exchange_strong(&reclaimer.readers[reader], &free_slot, epoch)) {
+				// Whatever is read from now on was published before the slot is seen by the writers
+
+				atomic_thread_fence(memory_order_seq_cst);
+
+				return reader;
+			}
+		}
+
+		sched_yield();
+	}
+}
+
+void reclaimer_leave(size_t reader)
+{
+	atomic_store_explicit(&reclaimer.readers[reader], 0, memory_order_release);
+}
+
+void lambda_retire(struct LambdaHandle lambda)
+{
+	if (lambda.term == NULL && lambda.free_variables == NULL) {
+		return;
+	}
+
+	retired_push((struct Retired){NULL, lambda, 0});
+}
+
+void memory_retire(void *pointer)
+{
+	if (pointer == NULL) {
+		return;
+	}
+
+	retired_push((struct Retired){pointer, {0}, 0});
+}
+
+void retired_push(struct Retired retired)
+{
+	pthread_mutex_lock(&reclaimer.retired_lock);
+
+	if (reclaimer.retired_size == reclaimer.retired_capacity) {
+		// Scaling factor of 2
+
+		reclaimer.retired_capacity = reclaimer.retired_capacity == 0 ? INITIAL_CAPACITY : reclaimer.retired_capacity << 1;
+		reclaimer.retired = realloc(reclaimer.retired, sizeof(*reclaimer.retired) * reclaimer.retired_capacity);
+
+		if (reclaimer.retired == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	// Readers entering from now on hold a later epoch, and can only reach what replaced the retired memory
+
+	retired.epoch = atomic_fetch_add(&reclaimer.epoch, 1);
+
+	reclaimer.retired[reclaimer.retired_size++] = retired;
+
+	retired_collect();
+
+	pthread_mutex_unlock(&reclaimer.retired_lock);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function retired_push().\n");
+	exit(1);
+}
+
+void retired_collect(void)
+{
+	// Releasing everything retired before the oldest reader entered, called with retired_lock held
+
+	atomic_thread_fence(memory_order_seq_cst);
+
+	uint64_t oldest = UINT64_MAX;
+
+	for (size_t reader = 0; reader < RECLAIM_READERS; reader++) {
+		uint64_t epoch = atomic_load_explicit(&reclaimer.readers[reader], memory_order_acquire);
+
+		if (epoch != 0 && epoch < oldest) {
+			oldest = epoch;
+		}
+	}
+
+	size_t kept = 0;
+
+	for (size_t i = 0; i < reclaimer.retired_size; i++) {
+		struct Retired retired = reclaimer.retired[i];
+
+		if (retired.epoch >= oldest) {
+			reclaimer.retired[kept++] = retired;
+		} else if (retired.pointer != NULL) {
+			free(retired.pointer);
+		} else {
+			lambda_free_deferred(retired.lambda);
+		}
+	}
+
+	reclaimer.retired_size = kept;
+}
+
+#else
+
+void lambda_free_deferred(struct LambdaHandle lambda)
+{
+	lambda_free(lambda);
+}
+
+void reclaimer_finish(void)
+{
+}
+
+size_t reclaimer_enter(void)
+{
+	return 0;
+}
+
+void reclaimer_leave(size_t reader)
+{
+	(void)reader;
+}
+
+void lambda_retire(struct LambdaHandle lambda)
+{
+	lambda_free(lambda);
+}
+
+void memory_retire(void *pointer)
+{
+	free(pointer);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <lambda.h>
+
+// Deferred release of lambda terms
+// Freeing a term walks every one of its nodes, which would delay the next request by as long as the previous result was
+// large. Terms above a few thousand nodes are queued to a reclaimer thread instead, started on first use, while smaller
+// ones are freed on the spot so memory stays low. Elsewhere than on Linux, every term is freed on the spot.
+// Memory that threads may still be reading is retired instead, and only released once every reader that could have
+// seen it has left. Readers announce themselves by taking a slot stamped with the current epoch, which costs a single
+// atomic exchange and never waits on writers. Every retirement advances the epoch, so what was retired at an epoch
+// is released once no slot holds that epoch or an earlier one.
+
+#define RECLAIM_INLINE_LIMIT 4096	// Largest number of nodes freed on the calling thread
+#define RECLAIM_READERS 64		// Threads reading retired memory at the same time, more of them wait for a slot
+
+void lambda_free_deferred(struct LambdaHandle lambda);	// Free lambda, on the reclaimer thread if it is large
+void reclaimer_finish(void);				// Wait until every queued term has been freed
+
+size_t reclaimer_enter(void);			// Start reading memory that may be retired meanwhile. Returns the slot to pass to reclaimer_leave()
+void reclaimer_leave(size_t reader);		// Stop reading, retired memory may be released from now on
+void lambda_retire(struct LambdaHandle lambda);	// Free lambda once no reader may see it
+void memory_retire(void *pointer);		// Free pointer once no reader may see it
\ No newline at end of file
@@ -0,0 +1,952 @@
+#include <server.h>
+#include <evaluation.h>
+#include <lambda.h>
+#include <printing.h>
+#include <reclaimer.h>
+#include <worker.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_EVENTS 64
+#define READ_SIZE 65536
+#define INITIAL_BUFFER_SIZE 4096
+
+// Growable byte buffer used for both directions of a connection
+
+struct Buffer {
+	char *data;
+
+	size_t size;
+	size_t capacity;
+};
+
+struct Connection {
+	int fd;
+	int closing;		// Set once the peer has hung up or asked to quit; the connection is closed after the output is flushed
+	int busy;		// A request of the connection is being evaluated, the connection stays open until it is answered
+	uint32_t events;	// Events currently watched by epoll, 0 once the connection is no longer watched
+
+	struct Buffer input;
+	struct Buffer output;
+
+	struct HashMap session;	// Session overlay over the shared definitions
+	size_t shared_seen;	// Changes to the shared definitions the session was refreshed against, see session_refresh()
+};
+
+// A request handed to the evaluation threads, handed back to the event loop with its response
+
+struct Job {
+	struct Connection *connection;
+
+	char *request;
+	size_t size;
+	int shared;		// The request is a definition to store in the shared definitions
+
+	struct Buffer response;
+
+	struct Job *next;
+};
+
+// Jobs waiting for an evaluation thread and jobs waiting for the event loop, shared under lock
+
+struct Pool {
+	struct Job *pending;
+	struct Job *pending_last;
+	struct Job *finished;
+
+	int event_fd;		// Signalled whenever a job is finished
+	int stopping;
+
+	pthread_t threads[SERVER_MAX_THREADS];
+	size_t threads_size;
+
+	pthread_mutex_t lock;
+	pthread_cond_t queued;
+
+	// Shared definitions, written by one thread at a time under the sharing lock, and the names of those changed so
+	// far, in order, under lock
+
+	struct HashMap *definitions;
+	pthread_mutex_t sharing;
+
+	struct Identifier *shared;
+	size_t shared_size;
+	size_t shared_capacity;
+};
+
+static struct Pool pool = {
+	.event_fd = -1,
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.queued = PTHREAD_COND_INITIALIZER,
+	.sharing = PTHREAD_MUTEX_INITIALIZER
+};
+
+static void buffer_append(struct Buffer *buffer, const char *data, size_t size);
+static void buffer_consume(struct Buffer *buffer, size_t size);
+
+static struct Connection *connection_create(int fd, const struct HashMap *definitions);
+static void connection_destroy(int epoll_fd, struct Connection *connection);
+
+static int connection_read(struct Connection *connection);
+static int connection_write(int epoll_fd, struct Connection *connection);
+static void connection_process(struct Connection *connection, struct HashMap *definitions);
+static void connection_update(int epoll_fd, struct Connection *connection);
+
+static void request_process(struct HashMap *hashmap, struct Buffer *output, char *request, size_t size, int shared);
+
+static void shared_log(struct HashMap *definitions, struct Identifier identifier);
+static void session_refresh(struct Connection *connection);
+
+static int pool_start(struct HashMap *definitions);
+static void pool_stop(void);
+static void pool_submit(struct Connection *connection, const char *request, size_t size, int shared);
+static void pool_collect(int epoll_fd, struct HashMap *definitions);
+static void *pool_main(void *argument);
+
+static int socket_listen(const char *socket_path);
+static int fd_set_nonblocking(int fd);
+
+static double elapsed_microseconds(struct timespec begin, struct timespec end);
+
+int server_run(const char *socket_path, struct HashMap *definitions)
+{
+	if (socket_path == NULL || definitions == NULL) {
+		return 0;
+	}
+
+	// A client hanging up mid-response must not kill the whole server
+
+	signal(SIGPIPE, SIG_IGN);
+
+	int listen_fd = socket_listen(socket_path);
+
+	if (listen_fd < 0) {
+		return 0;
+	}
+
+	int epoll_fd = epoll_create1(0);
+
+	if (epoll_fd < 0) {
+		perror("epoll_create1");
+		close(listen_fd);
+
+		return 0;
+	}
+
+	// The listening socket is registered with a NULL pointer, every connection with its own struct
+
+	struct epoll_event event = {0};
+
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;
+
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) < 0) {
+		perror("epoll_ctl");
+		goto error;
+	}
+
+	// Finished jobs are signalled through an eventfd registered with the pool itself
+
+	if (!pool_start(definitions)) {
+		goto error;
+	}
+
+	event.events = EPOLLIN;
+	event.data.ptr = &pool;
+
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, pool.event_fd, &event) < 0) {
+		perror("epoll_ctl");
+		goto error;
+	}
+
+	printf("Listening on %s\n", socket_path);
+	fflush(stdout);
+
+	struct epoll_event events[MAX_EVENTS];
+
+	while (1) {
+		int events_count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+		int collecting = 0;
+
+		if (events_count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			perror("epoll_wait");
+			goto error;
+		}
+
+		for (int i = 0; i < events_count; i++) {
+			struct Connection *connection = events[i].data.ptr;
+
+			if (events[i].data.ptr == &pool) {
+				collecting = 1;
+				continue;
+			}
+
+			if (connection == NULL) {
+				// Accepting every pending connection
+
+				int fd;
+
+				while ((fd = accept(listen_fd, NULL, NULL)) >= 0) {
+					fd_set_nonblocking(fd);
+
+					connection = connection_create(fd, definitions);
+
+					event.events = EPOLLIN | EPOLLRDHUP;
+					event.data.ptr = connection;
+
+					connection->events = event.events;
+
+					if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+						perror("epoll_ctl");
+						connection_destroy(epoll_fd, connection);
+					}
+				}
+
+				continue;
+			}
+
+			if (!connection->closing && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+				if (!connection_read(connection)) {
+					connection->closing = 1;
+				}
+
+				// Requests are submitted one at a time, the next one once the previous one is answered
+
+				connection_process(connection, definitions);
+			}
+
+			connection_update(epoll_fd, connection);
+		}
+
+		// Answered connections may be closed, so they are only collected once no event of the batch refers to them
+
+		if (collecting) {
+			pool_collect(epoll_fd, definitions);
+		}
+	}
+
+	error:
+
+	pool_stop();
+
+	close(epoll_fd);
+	close(listen_fd);
+	unlink(socket_path);
+
+	return 0;
+}
+
+struct Connection *connection_create(int fd, const struct HashMap *definitions)
+{
+	struct Connection *connection;
+
+	connection = calloc(1, sizeof(*connection));
+
+	if (connection == NULL) {
+		goto fatal_error;
+	}
+
+	connection->fd = fd;
+	connection->session = hashmap_create_overlay(definitions);
+
+	// The session starts out empty, so none of the changes made so far concern it
+
+	pthread_mutex_lock(&pool.lock);
+
+	connection->shared_seen = pool.shared_size;
+
+	pthread_mutex_unlock(&pool.lock);
+
+	return connection;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function connection_create().\n");
+	exit(1);
+}
+
+void connection_destroy(int epoll_fd, struct Connection *connection)
+{
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+	close(connection->fd);
+
+	hashmap_destroy(connection->session);
+
+	free(connection->input.data);
+	free(connection->output.data);
+	free(connection);
+}
+
+int connection_read(struct Connection *connection)
+{
+	// Returns 0 once the peer has hung up or an error occured
+
+	char chunk[READ_SIZE];
+
+	while (1) {
+		ssize_t count = read(connection->fd, chunk, sizeof(chunk));
+
+		if (count > 0) {
+			buffer_append(&connection->input, chunk, (size_t)count);
+			continue;
+		}
+
+		if (count == 0) {
+			return 0;
+		}
+
+		if (errno == EINTR) {
+			continue;
+		}
+
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+}
+
+int connection_write(int epoll_fd, struct Connection *connection)
+{
+	// Returns 0 upon a write error
+
+	while (connection->output.size > 0) {
+		ssize_t count = write(connection->fd, connection->output.data, connection->output.size);
+
+		if (count > 0) {
+			buffer_consume(&connection->output, (size_t)count);
+			continue;
+		}
+
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+
+		if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+
+		return 0;
+	}
+
+	// Watching EPOLLOUT only while there is pending output, and no longer reading from a closing connection, which
+	// is no longer watched at all when there is nothing to write since hangups would be reported until it is closed
+
+	uint32_t events = connection->closing ? 0 : EPOLLIN | EPOLLRDHUP;
+
+	if (connection->output.size > 0) {
+		events |= EPOLLOUT;
+	}
+
+	if (events != connection->events) {
+		struct epoll_event event = {0};
+
+		event.events = events;
+		event.data.ptr = connection;
+
+		if (events == 0) {
+			epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+		} else {
+			epoll_ctl(epoll_fd, connection->events == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, connection->fd, &event);
+		}
+
+		connection->events = events;
+	}
+
+	return 1;
+}
+
+void connection_update(int epoll_fd, struct Connection *connection)
+{
+	if (!connection_write(epoll_fd, connection)) {
+		// Nothing more can be answered, but a request being evaluated still refers to the connection
+
+		connection->closing = 1;
+		connection->input.size = 0;
+		connection->output.size = 0;
+	}
+
+	if (connection->closing && connection->output.size == 0 && !connection->busy) {
+		connection_destroy(epoll_fd, connection);
+	}
+}
+
+void connection_process(struct Connection *connection, struct HashMap *definitions)
+{
+	size_t begin = 0;
+
+	// Once the peer has hung up, an unterminated trailing request is answered as well
+
+	if (connection->closing && connection->input.size > 0 && connection->input.data[connection->input.size - 1] != '\n') {
+		buffer_append(&connection->input, "\n", 1);
+	}
+
+	while (!connection->busy && begin < connection->input.size) {
+		char *line = connection->input.data + begin;
+		char *newline = memchr(line, '\n', connection->input.size - begin);
+
+		if (newline == NULL) {
+			break;
+		}
+
+		size_t length = newline - line;
+
+		// Tolerating CRLF line endings
+
+		if (length > 0 && line[length - 1] == '\r') {
+			length--;
+		}
+
+		line[length] = '\0';
+
+		begin = newline - connection->input.data + 1;
+
+		if (length == 0) {
+			continue;
+		}
+
+		// Shared definitions are stored by the pool like any request, since the definitions depending on them are
+		// optimized again, and the event loop keeps serving the other connections meanwhile
+
+		int shared = strncmp(line, ":share ", 7) == 0;
+
+		if (shared) {
+			line += 7;
+			length -= 7;
+		}
+
+		if (!shared && strcmp(line, ":quit") == 0) {
+			connection->closing = 1;
+		} else if (!shared && line[0] == ':') {
+			const char *error = "ERROR unknown command\n";
+
+			buffer_append(&connection->output, error, strlen(error));
+		} else if (pool.threads_size > 0) {
+			pool_submit(connection, line, length, shared);
+		} else if (shared) {
+			request_process(definitions, &connection->output, line, length, 1);
+		} else {
+			session_refresh(connection);
+			request_process(&connection->session, &connection->output, line, length, 0);
+		}
+	}
+
+	buffer_consume(&connection->input, begin);
+}
+
+void request_process(struct HashMap *hashmap, struct Buffer *output, char *request, size_t size, int shared)
+{
+	// Expressions are evaluated against hashmap and definitions stored in it, shared ones only being definitions
+
+	struct timespec parse_begin, parse_end, evaluation_end, print_end;
+
+	clock_gettime(CLOCK_MONOTONIC, &parse_begin);
+
+	struct LambdaHandle lambda = lambda_parse(request, size + 1);
+
+	clock_gettime(CLOCK_MONOTONIC, &parse_end);
+
+	if (lambda.term == NULL) {
+		const char *error = "ERROR invalid expression\n";
+
+		buffer_append(output, error, strlen(error));
+
+		return;
+	}
+
+	if (shared && lambda.identifier.name == NULL) {
+		const char *error = "ERROR only definitions can be shared\n";
+
+		buffer_append(output, error, strlen(error));
+		lambda_free(lambda);
+
+		return;
+	}
+
+	// Definitions are echoed as written, expressions are answered with their normal form
+
+	struct EvaluationStats stats = {0};
+	struct LambdaHandle result = lambda;
+
+	if (lambda.identifier.name == NULL) {
+		result = lambda_evaluate(lambda, hashmap, EVALUATION_NF, &stats);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &evaluation_end);
+
+	// Printing through a memory stream straight into the response
+
+	char *printed = NULL;
+	size_t printed_size = 0;
+
+	FILE *stream = open_memstream(&printed, &printed_size);
+
+	if (stream == NULL) {
+		goto fatal_error;
+	}
+
+	fputs("OK ", stream);
+	lambda_fprint(stream, result);
+
+	clock_gettime(CLOCK_MONOTONIC, &print_end);
+
+	fprintf(stream, "\tparse_us=%.1f eval_us=%.1f print_us=%.1f beta=%zu delta=%zu nodes=%zu%s%s\n",
+		elapsed_microseconds(parse_begin, parse_end),
+		elapsed_microseconds(parse_end, evaluation_end),
+		elapsed_microseconds(evaluation_end, print_end),
+		stats.beta_steps, stats.delta_steps, stats.nodes,
+		stats.status == EVALUATION_STEP_LIMIT ? " step_limit" : stats.status == EVALUATION_DEPTH_LIMIT ? " depth_limit" :
+		stats.status == EVALUATION_LOOP ? " loop" : "",
+		stats.truncated ? " truncated" : ""
+	);
+
+	fclose(stream);
+
+	buffer_append(output, printed, printed_size);
+	free(printed);
+
+	if (lambda.identifier.name == NULL) {
+		lambda_free_deferred(result);
+		lambda_free(lambda);
+	} else {
+		// Definitions land in the session overlay, unless they were explicitly shared
+		hashmap_set(hashmap, lambda);
+
+		if (shared) {
+			shared_log(hashmap, lambda.identifier);
+		}
+	}
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: open_memstream() returned NULL in function request_process().\n");
+	exit(1);
+}
+
+void shared_log(struct HashMap *definitions, struct Identifier identifier)
+{
+	// Called by the writer of the shared definitions once identifier is stored. Definitions of the sessions may have
+	// inlined it or any shared definition depending on it, so all of them are logged.
+
+	size_t size;
+	struct Identifier *dependents = hashmap_dependents(definitions, &identifier, 1, &size);
+
+	pthread_mutex_lock(&pool.lock);
+
+	for (size_t i = 0; i <= size; i++) {
+		struct Identifier name = i == size ? identifier : dependents[i];
+
+		if (pool.shared_size == pool.shared_capacity) {
+			// Scaling factor of 2
+
+			pool.shared_capacity = pool.shared_capacity == 0 ? INITIAL_BUFFER_SIZE : pool.shared_capacity << 1;
+			pool.shared = realloc(pool.shared, sizeof(*pool.shared) * pool.shared_capacity);
+
+			if (pool.shared == NULL) {
+				goto fatal_error;
+			}
+		}
+
+		// The log keeps its own copy of the names, which lives as long as the server
+
+		name.name = strdup(name.name);
+
+		if (name.name == NULL) {
+			goto fatal_error;
+		}
+
+		pool.shared[pool.shared_size++] = name;
+	}
+
+	pthread_mutex_unlock(&pool.lock);
+
+	free(dependents);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: memory allocation failed in function shared_log().\n");
+	exit(1);
+}
+
+void session_refresh(struct Connection *connection)
+{
+	// Called by the thread about to evaluate a request of the connection, the only one writing its session. The
+	// definitions of the session depending on the shared ones changed since its last request are optimized and
+	// indexed again, as they may have inlined what was replaced.
+
+	pthread_mutex_lock(&pool.lock);
+
+	size_t begin = connection->shared_seen;
+	size_t end = pool.shared_size;
+
+	struct Identifier *names = NULL;
+
+	// The log may be scaled meanwhile, but not the names it points to
+
+	if (end > begin && connection->session.size > 0) {
+		names = malloc(sizeof(*names) * (end - begin));
+
+		if (names == NULL) {
+			goto fatal_error;
+		}
+
+		memcpy(names, pool.shared + begin, sizeof(*names) * (end - begin));
+	}
+
+	connection->shared_seen = end;
+
+	pthread_mutex_unlock(&pool.lock);
+
+	for (size_t i = 0; names != NULL && i < end - begin; i++) {
+		hashmap_refresh(&connection->session, names + i, 1);
+	}
+
+	free(names);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function session_refresh().\n");
+	exit(1);
+}
+
+int pool_start(struct HashMap *definitions)
+{
+	pool.definitions = definitions;
+
+	pool.event_fd = eventfd(0, EFD_NONBLOCK);
+
+	if (pool.event_fd < 0) {
+		perror("eventfd");
+		return 0;
+	}
+
+	size_t threads_size = SERVER_MAX_THREADS;
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (processors > 0 && threads_size > (size_t)processors) {
+		threads_size = (size_t)processors;
+	}
+
+	// Pool threads get the same large stack as the REPL's worker thread. Requests are evaluated by the event loop
+	// itself if no thread can be started
+
+	pthread_attr_t attributes;
+
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, WORKER_STACK_SIZE);
+
+	while (pool.threads_size < threads_size && pthread_create(&pool.threads[pool.threads_size], &attributes, pool_main, NULL) == 0) {
+		pool.threads_size++;
+	}
+
+	pthread_attr_destroy(&attributes);
+
+	return 1;
+}
+
+void pool_stop(void)
+{
+	// Pending requests are still evaluated, their responses are dropped
+
+	pthread_mutex_lock(&pool.lock);
+
+	pool.stopping = 1;
+
+	pthread_cond_broadcast(&pool.queued);
+	pthread_mutex_unlock(&pool.lock);
+
+	for (size_t i = 0; i < pool.threads_size; i++) {
+		pthread_join(pool.threads[i], NULL);
+	}
+
+	pool.threads_size = 0;
+
+	if (pool.event_fd >= 0) {
+		close(pool.event_fd);
+	}
+
+	for (size_t i = 0; i < pool.shared_size; i++) {
+		free(pool.shared[i].name);
+	}
+
+	free(pool.shared);
+
+	pool.shared = NULL;
+	pool.shared_size = 0;
+	pool.shared_capacity = 0;
+}
+
+void pool_submit(struct Connection *connection, const char *request, size_t size, int shared)
+{
+	struct Job *job = calloc(1, sizeof(*job));
+
+	if (job == NULL) {
+		goto fatal_error;
+	}
+
+	// The input buffer moves as more requests are read, so the job keeps its own copy
+
+	job->connection = connection;
+	job->request = malloc(size + 1);
+	job->size = size;
+	job->shared = shared;
+
+	if (job->request == NULL) {
+		goto fatal_error;
+	}
+
+	memcpy(job->request, request, size + 1);
+
+	connection->busy = 1;
+
+	pthread_mutex_lock(&pool.lock);
+
+	if (pool.pending == NULL) {
+		pool.pending = job;
+	} else {
+		pool.pending_last->next = job;
+	}
+
+	pool.pending_last = job;
+
+	pthread_cond_signal(&pool.queued);
+	pthread_mutex_unlock(&pool.lock);
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function pool_submit().\n");
+	exit(1);
+}
+
+void pool_collect(int epoll_fd, struct HashMap *definitions)
+{
+	uint64_t count;
+
+	while (read(pool.event_fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+	}
+
+	pthread_mutex_lock(&pool.lock);
+
+	struct Job *job = pool.finished;
+
+	pool.finished = NULL;
+
+	pthread_mutex_unlock(&pool.lock);
+
+	// Each connection has a single job at a time, so the order jobs finished in doesn't matter
+
+	while (job != NULL) {
+		struct Job *next = job->next;
+		struct Connection *connection = job->connection;
+
+		buffer_append(&connection->output, job->response.data, job->response.size);
+		connection->busy = 0;
+
+		free(job->response.data);
+		free(job->request);
+		free(job);
+
+		connection_process(connection, definitions);
+		connection_update(epoll_fd, connection);
+
+		job = next;
+	}
+}
+
+void *pool_main(void *argument)
+{
+	(void)argument;
+
+	pthread_mutex_lock(&pool.lock);
+
+	while (1) {
+		while (pool.pending == NULL && !pool.stopping) {
+			pthread_cond_wait(&pool.queued, &pool.lock);
+		}
+
+		struct Job *job = pool.pending;
+
+		if (job == NULL) {
+			break;
+		}
+
+		pool.pending = job->next;
+
+		pthread_mutex_unlock(&pool.lock);
+
+		// Definitions shared meanwhile are only released once the evaluation is done with the ones it saw
+
+		size_t reader = reclaimer_enter();
+
+		if (job->shared) {
+			pthread_mutex_lock(&pool.sharing);
+
+			request_process(pool.definitions, &job->response, job->request, job->size, 1);
+
+			pthread_mutex_unlock(&pool.sharing);
+		} else {
+			session_refresh(job->connection);
+
+			request_process(&job->connection->session, &job->response, job->request, job->size, 0);
+		}
+
+		reclaimer_leave(reader);
+
+		pthread_mutex_lock(&pool.lock);
+
+		job->next = pool.finished;
+		pool.finished = job;
+
+		uint64_t count = 1;
+
+		if (write(pool.event_fd, &count, sizeof(count)) < 0) {
+			perror("write");
+		}
+	}
+
+	pthread_mutex_unlock(&pool.lock);
+
+	return NULL;
+}
+
+int socket_listen(const char *socket_path)
+{
+	struct sockaddr_un address = {0};
+
+	if (strlen(socket_path) >= sizeof(address.sun_path)) {
+		printf("ERROR: socket path too long.\n");
+		return -1;
+	}
+
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, socket_path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+	if (fd < 0) {
+		perror("socket");
+		return -1;
+	}
+
+	// Removing a stale socket left behind by a previous server
+
+	unlink(socket_path);
+
+	if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+		perror("bind");
+		goto error;
+	}
+
+	if (listen(fd, SOMAXCONN) < 0) {
+		perror("listen");
+		goto error;
+	}
+
+	if (!fd_set_nonblocking(fd)) {
+		goto error;
+	}
+
+	return fd;
+
+	error:
+
+	close(fd);
+
+	return -1;
+}
+
+int fd_set_nonblocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL, 0);
+
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+		perror("fcntl");
+		return 0;
+	}
+
+	return 1;
+}
+
+void buffer_append(struct Buffer *buffer, const char *data, size_t size)
+{
+	if (buffer->capacity - buffer->size <= size) {
+		size_t capacity = buffer->capacity == 0 ? INITIAL_BUFFER_SIZE : buffer->capacity;
+
+		// Scaling factor of 2, keeping one spare byte for a null terminator
+
+		while (capacity - buffer->size <= size) {
+			capacity <<= 1;
+		}
+
+		buffer->data = realloc(buffer->data, capacity);
+
+		if (buffer->data == NULL) {
+			goto fatal_error;
+		}
+
+		buffer->capacity = capacity;
+	}
+
+	memcpy(buffer->data + buffer->size, data, size);
+	buffer->size += size;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function buffer_append().\n");
+	exit(1);
+}
+
+void buffer_consume(struct Buffer *buffer, size_t size)
+{
+	if (size == 0) {
+		return;
+	}
+
+	memmove(buffer->data, buffer->data + size, buffer->size - size);
+	buffer->size -= size;
+}
+
+double elapsed_microseconds(struct timespec begin, struct timespec end)
+{
+	return (double)(end.tv_sec - begin.tv_sec) * 1e6 + (double)(end.tv_nsec - begin.tv_nsec) / 1e3;
+}
+
+#else
+
+int server_run(const char *socket_path, struct HashMap *definitions)
+{
+	(void)socket_path;
+	(void)definitions;
+
+	printf("ERROR: the evaluation server is only supported on Linux.\n");
+
+	return 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <hashmap.h>
+
+// A local evaluation server listening on a Unix domain socket
+// Every connection owns a session overlay layered over the shared definitions, so the definitions stay warm across requests
+// Requests are newline terminated expressions or definitions, and every request is answered with exactly one line:
+//	OK <printed term>\t<timing counters>
+//	ERROR <message>
+// Requests are answered in order, so clients may pipeline several of them without waiting for each response
+// Requests are evaluated by a pool of threads, one request of each connection at a time, while the event loop keeps
+// serving the other connections. A definition sent as ":share <definition>" is stored in the shared definitions instead
+// of the session, by a pool thread holding the lock that lets one thread at a time write them, and evaluations already
+// running keep the definitions they started with. The definitions of a session depending on it are optimized again
+// before the next request of the session.
+
+#define SERVER_MAX_THREADS 16	// Evaluation threads, no more than the processors
+
+int server_run(const char *socket_path, struct HashMap *definitions);	// Serve requests until a fatal error occurs. Returns 0 upon failure
\ No newline at end of file
@@ -0,0 +1,1530 @@
+#include <sigma.h>
+#include <reclaimer.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+enum SigmaNodeType {
+	SIGMA_VARIABLE,		// De Bruijn index
+	SIGMA_ABSTRACTION,
+	SIGMA_APPLICATION,
+	SIGMA_CLOSURE,		// Term under a substitution, pushed inward once examined
+	SIGMA_FREE_VARIABLE,
+	SIGMA_REFERENCE,	// Linked definition, compiled only once it reaches the head position and forwarding to it afterwards
+	SIGMA_CHURCH_NUMERAL,	// Primitive of arity 2
+	SIGMA_INDIRECTION
+};
+
+enum SigmaNodeFlags {
+	SIGMA_CLOSED = 1,	// No loose index, so every substitution leaves the node as it is
+	SIGMA_SPINE = 2,	// The application lies on the spine being unwound, meeting it again means a loop
+	SIGMA_VISITING = 4	// The node is being read back, meeting it again means a cycle
+};
+
+struct SigmaNode {
+	enum SigmaNodeType type;
+	unsigned int flags;
+
+	union {
+		int church_numeral;
+
+		size_t index;
+
+		const struct Identifier *free_variable;
+
+		struct SigmaNode *indirection;
+
+		struct SigmaReference {
+			struct Linkage *linkage;
+			struct SigmaNode *unfolded;		// The compiled definition, NULL until it is first needed
+		} reference;
+
+		struct SigmaAbstraction {
+			const struct Identifier *bound_variable;	// Name hint for readback, NULL for expanded numerals
+			struct SigmaNode *body;
+		} abstraction;
+
+		struct SigmaApplication {
+			struct SigmaNode *function;
+			struct SigmaNode *argument;
+		} application;
+
+		struct SigmaClosure {
+			struct SigmaNode *term;
+			struct Substitution *substitution;
+		} closure;
+	};
+};
+
+enum SubstitutionType {
+	SUBSTITUTION_SHIFT,		// ↑k, the identity for k = 0
+	SUBSTITUTION_CONS,		// N·s, replacing index 0 by N and index n + 1 by n[s]
+	SUBSTITUTION_COMPOSITION	// s∘t, applying s then t
+};
+
+// Substitutions are never modified, so they are shared freely
+
+struct Substitution {
+	enum SubstitutionType type;
+
+	union {
+		size_t shift;
+
+		struct SubstitutionCons {
+			struct SigmaNode *term;
+			struct Substitution *next;
+		} cons;
+
+		struct SubstitutionComposition {
+			struct Substitution *first;
+			struct Substitution *second;
+		} composition;
+	};
+};
+
+struct SigmaMachine {
+	struct Arena arena;
+	struct Linker linker;
+
+	enum EvaluationMode mode;
+
+	struct SigmaNode **stack;	// Spine stack
+	size_t stack_size;
+	size_t stack_capacity;
+
+	struct Substitution **pending;	// Substitutions left to apply to the result of a lookup
+	size_t pending_size;
+	size_t pending_capacity;
+
+	struct SigmaNode **variables;	// Variable nodes by index, shared since they never change
+	size_t variables_size;
+
+	struct Substitution *identity;
+	struct Substitution *shift;	// ↑1
+
+	size_t step_limit;		// Maximum number of beta steps, 0 meaning unlimited
+
+	struct EvaluationStats stats;	// nodes counts substitutions as well
+};
+
+// Compilation keeps the enclosing binders, the innermost last
+
+struct Scope {
+	const struct Identifier **identifiers;
+
+	size_t size;
+	size_t capacity;
+};
+
+struct SigmaReadback {
+	struct LambdaHandle lambda;
+
+	// Names given to the enclosing binders, the innermost last
+
+	struct Identifier *identifiers;
+	size_t scope_size;
+	size_t scope_capacity;
+
+	// Open addressing set of every name the result could refer to freely: the names of all linked definitions and
+	// their free variables
+
+	const struct Identifier **names;
+	size_t names_capacity;
+
+	size_t visited;		// Nodes read back raw, evaluation_control being polled every EVALUATION_POLL_INTERVAL
+
+	// Pending steps and the terms read back so far, see machine_readback()
+
+	struct SigmaReadbackTask *tasks;
+	size_t tasks_size;
+	size_t tasks_capacity;
+
+	struct LambdaTerm **results;
+	size_t results_size;
+	size_t results_capacity;
+};
+
+// Steps of a readback, taken off a stack
+
+enum SigmaReadbackTaskType {
+	SIGMA_READBACK_NODE,		// Reduce a node and read it back onto the results
+	SIGMA_READBACK_RAW,		// Read a node back onto the results as it stands
+	SIGMA_READBACK_APPLICATION,	// Apply the function below the top of the results to the argument on top
+	SIGMA_READBACK_ABSTRACTION,	// Close the abstraction term over the body on top of the results
+	SIGMA_READBACK_UNVISIT		// Leave a node whose subterms have been read back
+};
+
+struct SigmaReadbackTask {
+	enum SigmaReadbackTaskType type;
+
+	struct SigmaNode *node;
+	struct LambdaTerm *term;	// Abstraction waiting for its body
+};
+
+static struct SigmaNode *term_compile(struct SigmaMachine *machine, struct Scope *scope, const struct LambdaTerm *term, struct Linkage *linkage, size_t *loose);
+
+static struct SigmaNode *machine_whnf(struct SigmaMachine *machine, struct SigmaNode *node);
+static struct SigmaNode *machine_contract(struct SigmaMachine *machine, struct SigmaNode *head, size_t arguments);
+static struct SigmaNode *reference_unfold(struct SigmaMachine *machine, struct SigmaNode *node);
+static void closure_push(struct SigmaMachine *machine, struct SigmaNode *node);
+
+static struct SigmaNode *substitution_lookup(struct SigmaMachine *machine, size_t index, struct Substitution *substitution);
+static struct Substitution *substitution_compose(struct SigmaMachine *machine, struct Substitution *first, struct Substitution *second);
+static struct Substitution *substitution_lift(struct SigmaMachine *machine, struct Substitution *substitution);
+
+static struct LambdaTerm *machine_readback(struct SigmaMachine *machine, struct SigmaReadback *readback, struct SigmaNode *node, int raw);
+static int node_step(struct SigmaMachine *machine, struct SigmaReadback *readback, struct SigmaNode *node, struct LambdaTerm **term);
+static int raw_step(struct SigmaMachine *machine, struct SigmaReadback *readback, struct SigmaNode *node, struct LambdaTerm **term);
+static void abstraction_step(struct SigmaReadback *readback, struct SigmaNode *node, int raw);
+static void task_push(struct SigmaReadback *readback, enum SigmaReadbackTaskType type, struct SigmaNode *node, struct LambdaTerm *term);
+static struct LambdaTerm *variable_readback(struct SigmaReadback *readback, size_t index);
+static struct LambdaTerm *free_variable_readback(struct SigmaReadback *readback, const char *name, int subscript);
+
+static struct Identifier identifier_fresh(struct SigmaReadback *readback, const struct Identifier *hint);
+static int identifier_used(struct SigmaReadback *readback, const char *name, int subscript);
+static void names_collect(struct SigmaReadback *readback, const struct Linker *linker);
+static void names_insert(struct SigmaReadback *readback, const struct Identifier *identifier);
+static size_t name_hash(const char *name, int subscript);
+
+static struct SigmaNode *node_create(struct SigmaMachine *machine, enum SigmaNodeType type);
+static struct SigmaNode *sigma_forward(struct SigmaNode *node);
+static struct SigmaNode *node_follow(struct SigmaNode *node);
+static struct SigmaNode *variable_get(struct SigmaMachine *machine, size_t index);
+static struct SigmaNode *closure_create(struct SigmaMachine *machine, struct SigmaNode *term, struct Substitution *substitution);
+static struct Substitution *substitution_create(struct SigmaMachine *machine, enum SubstitutionType type);
+static struct Substitution *shift_create(struct SigmaMachine *machine, size_t shift);
+static struct Substitution *cons_create(struct SigmaMachine *machine, struct SigmaNode *term, struct Substitution *next);
+
+static void scope_push(struct SigmaReadback *readback, struct Identifier identifier);
+static void stack_push(struct SigmaNode ***stack, size_t *size, size_t *capacity, struct SigmaNode *node);
+static void pending_push(struct SigmaMachine *machine, struct Substitution *substitution);
+static struct LambdaTerm *term_create(enum ExpressionType type);
+static char *string_copy(const char *string);
+static void *array_push(void *array, size_t *size, size_t *capacity, size_t element_size, const void *element);
+
+struct LambdaHandle sigma_evaluate(
+	struct LambdaHandle lambda, const struct HashMap *definitions,
+	enum EvaluationMode mode, struct EvaluationStats *stats
+)
+{
+	struct SigmaMachine machine = {0};
+
+	machine.arena = arena_create();
+	machine.mode = mode;
+	machine.step_limit = DEFAULT_STEP_LIMIT;
+	machine.stats.status = EVALUATION_PENDING;
+
+	machine.identity = shift_create(&machine, 0);
+	machine.shift = shift_create(&machine, 1);
+
+	// Index 0 is compared by address when composing substitutions
+
+	variable_get(&machine, 0);
+
+	struct SigmaReadback readback = {0};
+
+	if (lambda.term != NULL) {
+		machine.linker = linker_create(&machine.arena);
+
+		struct Linkage *linkage = linker_link(&machine.linker, lambda, definitions);
+
+		struct Scope scope = {0};
+		size_t loose;
+
+		struct SigmaNode *root = term_compile(&machine, &scope, lambda.term, linkage, &loose);
+
+		free(scope.identifiers);
+
+		names_collect(&readback, &machine.linker);
+
+		readback.lambda.free_variables_capacity = INITIAL_CAPACITY;
+		readback.lambda.free_variables = malloc(sizeof(*readback.lambda.free_variables) * readback.lambda.free_variables_capacity);
+
+		if (readback.lambda.free_variables == NULL) {
+			goto fatal_error;
+		}
+
+		// Weak head normal forms are printed as they stand, without reducing anything below the head
+
+		if (mode == EVALUATION_WHNF) {
+			readback.lambda.term = machine_readback(&machine, &readback, machine_whnf(&machine, root), 1);
+		} else {
+			readback.lambda.term = machine_readback(&machine, &readback, root, 0);
+		}
+
+		if (machine.stats.status == EVALUATION_PENDING) {
+			machine.stats.status = EVALUATION_NORMAL_FORM;
+		}
+	}
+
+	// Numerals and definitions are folded back as lambda_evaluate() does
+
+	if (machine.stats.status == EVALUATION_CANCELLED) {
+		lambda_free_deferred(readback.lambda);
+
+		readback.lambda = (struct LambdaHandle){0};
+	} else {
+		readback.lambda = lambda_fold(readback.lambda, definitions);
+	}
+
+	if (stats != NULL) {
+		*stats = machine.stats;
+	}
+
+	free(readback.identifiers);
+	free(readback.names);
+	free(readback.tasks);
+	free(readback.results);
+
+	linker_destroy(machine.linker);
+
+	free(machine.stack);
+	free(machine.pending);
+	free(machine.variables);
+
+	arena_destroy(machine.arena);
+
+	return readback.lambda;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function sigma_evaluate().\n");
+	exit(1);
+}
+
+// Compilation
+
+struct SigmaNode *term_compile(struct SigmaMachine *machine, struct Scope *scope, const struct LambdaTerm *term, struct Linkage *linkage, size_t *loose)
+{
+	// loose is set to the number of enclosing binders the term refers to
+
+	struct SigmaNode *node;
+
+	*loose = 0;
+
+	switch (term->type) {
+	case CHURCH_NUMERAL:
+		node = node_create(machine, SIGMA_CHURCH_NUMERAL);
+		node->church_numeral = term->expression.church_numeral;
+		node->flags = SIGMA_CLOSED;
+
+		return node;
+
+	case BOUND_VARIABLE:
+		// Innermost binders shadow outer ones
+
+		for (size_t level = scope->size; level > 0; level--) {
+			const struct Identifier *identifier = scope->identifiers[level - 1];
+
+			if (identifier->subscript != term->expression.variable.subscript) {
+				continue;
+			}
+
+			if (identifier->name != term->expression.variable.name && strcmp(identifier->name, term->expression.variable.name) != 0) {
+				continue;
+			}
+
+			*loose = scope->size - level + 1;
+
+			return variable_get(machine, scope->size - level);
+		}
+
+		node = node_create(machine, SIGMA_FREE_VARIABLE);
+		node->free_variable = &term->expression.variable;
+		node->flags = SIGMA_CLOSED;
+
+		return node;
+
+	case FREE_VARIABLE:
+		const struct Identifier *free_variable;
+
+		struct Linkage *target = linkage_target(linkage, &term->expression.variable, &free_variable);
+
+		if (target == NULL) {
+			node = node_create(machine, SIGMA_FREE_VARIABLE);
+			node->free_variable = free_variable;
+			node->flags = SIGMA_CLOSED;
+
+			return node;
+		}
+
+		if (target->sigma == NULL) {
+			target->sigma = node_create(machine, SIGMA_REFERENCE);
+			target->sigma->reference.linkage = target;
+			target->sigma->reference.unfolded = NULL;
+			target->sigma->flags = SIGMA_CLOSED;
+		}
+
+		return target->sigma;
+
+	case ABSTRACTION:
+		if (scope->size == scope->capacity) {
+			// Scaling factor of 2
+
+			scope->capacity = scope->capacity == 0 ? INITIAL_CAPACITY : scope->capacity << 1;
+			scope->identifiers = realloc(scope->identifiers, sizeof(*scope->identifiers) * scope->capacity);
+
+			if (scope->identifiers == NULL) {
+				goto fatal_error;
+			}
+		}
+
+		scope->identifiers[scope->size++] = &term->expression.abstraction.bound_variable;
+
+		struct SigmaNode *body = term_compile(machine, scope, term->expression.abstraction.body, linkage, loose);
+
+		scope->size--;
+
+		node = node_create(machine, SIGMA_ABSTRACTION);
+		node->abstraction.bound_variable = &term->expression.abstraction.bound_variable;
+		node->abstraction.body = body;
+
+		if (*loose > 0) {
+			(*loose)--;
+		}
+
+		node->flags = *loose == 0 ? SIGMA_CLOSED : 0;
+
+		return node;
+
+	case APPLICATION:
+		size_t function_loose;
+		size_t argument_loose;
+
+		struct SigmaNode *function = term_compile(machine, scope, term->expression.application.function, linkage, &function_loose);
+		struct SigmaNode *argument = term_compile(machine, scope, term->expression.application.argument, linkage, &argument_loose);
+
+		node = node_create(machine, SIGMA_APPLICATION);
+		node->application.function = function;
+		node->application.argument = argument;
+
+		*loose = function_loose > argument_loose ? function_loose : argument_loose;
+
+		node->flags = *loose == 0 ? SIGMA_CLOSED : 0;
+
+		return node;
+
+	default:
+		return NULL;
+	}
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function term_compile().\n");
+	exit(1);
+}
+
+// Reduction
+
+struct SigmaNode *machine_whnf(struct SigmaMachine *machine, struct SigmaNode *node)
+{
+	// Unwinds the spine onto the stack, pushing closures met on the way, and contracts head redexes until the head lacks
+	// arguments or is a variable
+
+	size_t base = machine->stack_size;
+
+	struct SigmaNode *head = sigma_forward(node);
+
+	while (1) {
+		switch (head->type) {
+		case SIGMA_CLOSURE:
+			closure_push(machine, head);
+
+			head = sigma_forward(head);
+
+			continue;
+
+		case SIGMA_APPLICATION:
+			// The application reduces to itself applied to arguments, so it needs its own value
+
+			if (head->flags & SIGMA_SPINE) {
+				machine->stats.status = EVALUATION_LOOP;
+				machine->stats.loop_period = 0;
+
+				goto end;
+			}
+
+			head->flags |= SIGMA_SPINE;
+
+			stack_push(&machine->stack, &machine->stack_size, &machine->stack_capacity, head);
+
+			head = sigma_forward(head->application.function);
+
+			continue;
+
+		case SIGMA_REFERENCE:
+			head = reference_unfold(machine, head);
+
+			if (head == NULL) {
+				goto end;
+			}
+
+			continue;
+
+		case SIGMA_ABSTRACTION:
+		case SIGMA_CHURCH_NUMERAL:
+			if (machine->stack_size == base) {
+				goto end;
+			}
+
+			if (machine->step_limit != 0 && machine->stats.beta_steps >= machine->step_limit) {
+				machine->stats.status = EVALUATION_STEP_LIMIT;
+				goto end;
+			}
+
+			if ((machine->stats.beta_steps & (EVALUATION_POLL_INTERVAL - 1)) == 0 && !evaluation_poll(&machine->stats)) {
+				goto end;
+			}
+
+			head = machine_contract(machine, head, machine->stack_size - base);
+
+			if (head == NULL) {
+				goto end;
+			}
+
+			continue;
+
+		default:
+			goto end;
+		}
+	}
+
+	end:
+
+	for (size_t i = base; i < machine->stack_size; i++) {
+		machine->stack[i]->flags &= ~SIGMA_SPINE;
+	}
+
+	machine->stack_size = base;
+
+	return sigma_forward(node);
+}
+
+struct SigmaNode *machine_contract(struct SigmaMachine *machine, struct SigmaNode *head, size_t arguments)
+{
+	// Rewrites the root of the redex in place, pops its arguments and returns the root
+	// Returns NULL upon a black hole: a term reducing to itself through an indirection
+
+	struct SigmaNode *root = machine->stack[--machine->stack_size];
+	struct SigmaNode *argument = root->application.argument;
+
+	// Reduction never adds free variables, so a closed root stays closed
+
+	root->flags &= ~SIGMA_SPINE;
+
+	machine->stats.beta_steps++;
+
+	if (head->type == SIGMA_ABSTRACTION) {
+		// (λM) N = M[N·id], where a closed body is left as it is
+
+		struct SigmaNode *body = head->abstraction.body;
+
+		if (body->flags & SIGMA_CLOSED) {
+			if (sigma_forward(body) == root) {
+				machine->stats.status = EVALUATION_LOOP;
+				machine->stats.loop_period = 0;
+
+				return NULL;
+			}
+
+			root->type = SIGMA_INDIRECTION;
+			root->indirection = body;
+
+			return sigma_forward(root);
+		}
+
+		root->type = SIGMA_CLOSURE;
+		root->closure.term = body;
+		root->closure.substitution = cons_create(machine, argument, machine->identity);
+
+		return root;
+	}
+
+	int church_numeral = head->church_numeral;
+
+	if (arguments == 1) {
+		// n f = λx.f (f ... (f x)), where f is shifted past the new binder
+
+		struct SigmaNode *function = closure_create(machine, argument, machine->shift);
+		struct SigmaNode *body = variable_get(machine, 0);
+
+		for (int i = 0; i < church_numeral; i++) {
+			struct SigmaNode *application = node_create(machine, SIGMA_APPLICATION);
+
+			application->application.function = function;
+			application->application.argument = body;
+
+			body = application;
+		}
+
+		root->type = SIGMA_ABSTRACTION;
+		root->abstraction.bound_variable = NULL;
+		root->abstraction.body = body;
+
+		return root;
+	}
+
+	// n f x = f (f ... (f x)), sharing f
+
+	struct SigmaNode *function = argument;
+
+	root = machine->stack[--machine->stack_size];
+	argument = root->application.argument;
+
+	root->flags &= ~SIGMA_SPINE;
+
+	if (church_numeral == 0) {
+		if (sigma_forward(argument) == root) {
+			machine->stats.status = EVALUATION_LOOP;
+			machine->stats.loop_period = 0;
+
+			return NULL;
+		}
+
+		root->type = SIGMA_INDIRECTION;
+		root->indirection = argument;
+
+		return sigma_forward(root);
+	}
+
+	for (int i = 1; i < church_numeral; i++) {
+		struct SigmaNode *application = node_create(machine, SIGMA_APPLICATION);
+
+		application->application.function = function;
+		application->application.argument = argument;
+
+		argument = application;
+	}
+
+	root->application.function = function;
+	root->application.argument = argument;
+
+	return root;
+}
+
+struct SigmaNode *reference_unfold(struct SigmaMachine *machine, struct SigmaNode *node)
+{
+	// Every occurrence shares the compiled definition, and recursive definitions become cycles
+	// Returns NULL when the definition only names itself
+
+	struct Linkage *linkage = node->reference.linkage;
+
+	struct Scope scope = {0};
+	size_t loose;
+
+	struct SigmaNode *compiled = term_compile(machine, &scope, linkage->definition.term, linkage, &loose);
+
+	free(scope.identifiers);
+
+	machine->stats.delta_steps++;
+
+	if (sigma_forward(compiled) == node) {
+		machine->stats.status = EVALUATION_LOOP;
+		machine->stats.loop_period = 0;
+
+		return NULL;
+	}
+
+	node->reference.unfolded = compiled;
+
+	return sigma_forward(compiled);
+}
+
+void closure_push(struct SigmaMachine *machine, struct SigmaNode *node)
+{
+	// Pushes the substitution of a closure one constructor down, overwriting the closure with the result
+
+	struct SigmaNode *term = sigma_forward(node->closure.term);
+	struct Substitution *substitution = node->closure.substitution;
+
+	switch (term->type) {
+	case SIGMA_CLOSURE:
+		node->closure.term = term->closure.term;
+		node->closure.substitution = substitution_compose(machine, term->closure.substitution, substitution);
+
+		return;
+
+	case SIGMA_APPLICATION:
+		struct SigmaNode *function = closure_create(machine, term->application.function, substitution);
+		struct SigmaNode *argument = closure_create(machine, term->application.argument, substitution);
+
+		node->type = SIGMA_APPLICATION;
+		node->flags = function->flags & argument->flags & SIGMA_CLOSED;
+		node->application.function = function;
+		node->application.argument = argument;
+
+		return;
+
+	case SIGMA_ABSTRACTION:
+		struct SigmaNode *body = closure_create(machine, term->abstraction.body, substitution_lift(machine, substitution));
+
+		node->type = SIGMA_ABSTRACTION;
+		node->abstraction.bound_variable = term->abstraction.bound_variable;
+		node->abstraction.body = body;
+
+		return;
+
+	case SIGMA_VARIABLE:
+		node->type = SIGMA_INDIRECTION;
+		node->indirection = substitution_lookup(machine, term->index, substitution);
+
+		return;
+
+	default:
+		node->type = SIGMA_INDIRECTION;
+		node->indirection = term;
+
+		return;
+	}
+}
+
+// Substitutions
+
+struct SigmaNode *substitution_lookup(struct SigmaMachine *machine, size_t index, struct Substitution *substitution)
+{
+	// Compositions are walked through their first substitution, the second one being left to apply to the result
+
+	size_t base = machine->pending_size;
+
+	while (1) {
+		switch (substitution->type) {
+		case SUBSTITUTION_SHIFT:
+			index += substitution->shift;
+
+			if (machine->pending_size == base) {
+				return variable_get(machine, index);
+			}
+
+			substitution = machine->pending[--machine->pending_size];
+
+			continue;
+
+		case SUBSTITUTION_CONS:
+			if (index != 0) {
+				index--;
+				substitution = substitution->cons.next;
+
+				continue;
+			}
+
+			struct SigmaNode *term = sigma_forward(substitution->cons.term);
+
+			// A variable is looked up in what is left to apply rather than wrapped in a closure
+
+			if (term->type == SIGMA_VARIABLE && machine->pending_size > base) {
+				index = term->index;
+				substitution = machine->pending[--machine->pending_size];
+
+				continue;
+			}
+
+			if (machine->pending_size == base) {
+				return term;
+			}
+
+			// The substitution met last applies first
+
+			struct Substitution *remaining = machine->pending[base];
+
+			for (size_t i = base + 1; i < machine->pending_size; i++) {
+				remaining = substitution_compose(machine, machine->pending[i], remaining);
+			}
+
+			machine->pending_size = base;
+
+			return closure_create(machine, term, remaining);
+
+		case SUBSTITUTION_COMPOSITION:
+			pending_push(machine, substitution->composition.second);
+
+			substitution = substitution->composition.first;
+
+			continue;
+		}
+	}
+}
+
+struct Substitution *substitution_compose(struct SigmaMachine *machine, struct Substitution *first, struct Substitution *second)
+{
+	// Simplifications:
+	//	id∘t = t		s∘id = s		↑j∘↑k = ↑(j+k)		↑(j+1)∘(N·t) = ↑j∘t
+	//	(0·s)∘(N·t) = N·(s∘(N·t))				(s∘↑j)∘(N·t) = s∘(↑j∘(N·t))
+
+	while (1) {
+		if (first == machine->identity) {
+			return second;
+		}
+
+		if (second == machine->identity) {
+			return first;
+		}
+
+		if (first->type == SUBSTITUTION_SHIFT) {
+			size_t shift = first->shift;
+
+			while (shift > 0 && second->type == SUBSTITUTION_CONS) {
+				second = second->cons.next;
+				shift--;
+			}
+
+			if (shift == 0) {
+				return second;
+			}
+
+			if (second->type == SUBSTITUTION_SHIFT) {
+				return shift_create(machine, shift + second->shift);
+			}
+
+			first = shift == first->shift ? first : shift_create(machine, shift);
+
+			break;
+		}
+
+		if (second->type != SUBSTITUTION_CONS) {
+			break;
+		}
+
+		if (first->type == SUBSTITUTION_CONS && first->cons.term == machine->variables[0]) {
+			return cons_create(machine, second->cons.term, substitution_compose(machine, first->cons.next, second));
+		}
+
+		if (first->type == SUBSTITUTION_COMPOSITION && first->composition.second->type == SUBSTITUTION_SHIFT) {
+			second = substitution_compose(machine, first->composition.second, second);
+			first = first->composition.first;
+
+			continue;
+		}
+
+		break;
+	}
+
+	struct Substitution *composition = substitution_create(machine, SUBSTITUTION_COMPOSITION);
+
+	composition->composition.first = first;
+	composition->composition.second = second;
+
+	return composition;
+}
+
+struct Substitution *substitution_lift(struct SigmaMachine *machine, struct Substitution *substitution)
+{
+	// The substitution under one more binder: 0·(s∘↑)
+
+	if (substitution == machine->identity) {
+		return substitution;
+	}
+
+	return cons_create(machine, variable_get(machine, 0), substitution_compose(machine, substitution, machine->shift));
+}
+
+// Readback
+
+struct LambdaTerm *machine_readback(struct SigmaMachine *machine, struct SigmaReadback *readback, struct SigmaNode *node, int raw)
+{
+	// Subterms are read back off a stack of tasks, and their terms wait on a stack of results until the term enclosing
+	// them is complete, so deep results don't deepen the C stack. Functions are read back before their arguments, as
+	// they would be recursively, so binders are named and arguments reduced in the same order
+
+	task_push(readback, raw ? SIGMA_READBACK_RAW : SIGMA_READBACK_NODE, node, NULL);
+
+	while (readback->tasks_size > 0) {
+		struct SigmaReadbackTask task = readback->tasks[--readback->tasks_size];
+
+		struct LambdaTerm *term;
+
+		switch (task.type) {
+		case SIGMA_READBACK_NODE:
+			if (!node_step(machine, readback, task.node, &term)) {
+				continue;
+			}
+
+			break;
+
+		case SIGMA_READBACK_RAW:
+			if (!raw_step(machine, readback, task.node, &term)) {
+				continue;
+			}
+
+			break;
+
+		case SIGMA_READBACK_APPLICATION:
+			term = term_create(APPLICATION);
+
+			term->expression.application.argument = readback->results[--readback->results_size];
+			term->expression.application.function = readback->results[--readback->results_size];
+
+			break;
+
+		case SIGMA_READBACK_ABSTRACTION:
+			readback->scope_size--;
+
+			term = task.term;
+			term->expression.abstraction.body = readback->results[--readback->results_size];
+
+			break;
+
+		case SIGMA_READBACK_UNVISIT:
+			task.node->flags &= ~SIGMA_VISITING;
+
+			continue;
+		}
+
+		readback->results = array_push(readback->results, &readback->results_size, &readback->results_capacity, sizeof(term), &term);
+	}
+
+	return readback->results[--readback->results_size];
+}
+
+int node_step(struct SigmaMachine *machine, struct SigmaReadback *readback, struct SigmaNode *node, struct LambdaTerm **term)
+{
+	// Normal order readback: the head is reduced first, then every argument is read back from left to right. Reads a
+	// leaf back into term and returns 1, or pushes the tasks reading back the subterms of node and returns 0
+
+	struct SigmaNode *reference = node_follow(node);
+
+	node = machine_whnf(machine, node);
+
+	if (machine->stats.status != EVALUATION_PENDING) {
+		return raw_step(machine, readback, node, term);
+	}
+
+	// A node met again below itself stands for an infinite term, cut at the name of the definition it came from
+
+	if (node->flags & SIGMA_VISITING) {
+		if (reference->type == SIGMA_REFERENCE) {
+			const struct Identifier *identifier = &reference->reference.linkage->definition.identifier;
+
+			*term = free_variable_readback(readback, identifier->name, identifier->subscript);
+
+			return 1;
+		}
+
+		*term = free_variable_readback(readback, "...", -1);
+
+		return 1;
+	}
+
+	switch (node->type) {
+	case SIGMA_ABSTRACTION:
+		node->flags |= SIGMA_VISITING;
+
+		task_push(readback, SIGMA_READBACK_UNVISIT, node, NULL);
+
+		abstraction_step(readback, node, 0);
+
+		return 0;
+
+	case SIGMA_CHURCH_NUMERAL:
+		*term = term_create(CHURCH_NUMERAL);
+		(*term)->expression.church_numeral = node->church_numeral;
+
+		return 1;
+
+	case SIGMA_APPLICATION:
+		break;
+
+	default:
+		return raw_step(machine, readback, node, term);
+	}
+
+	// Stuck application: the head is read back as it stands, then the arguments from left to right, so their tasks are
+	// pushed from the last argument to the head. Head normal forms leave their arguments as they are
+
+	enum SigmaReadbackTaskType argument = machine->mode == EVALUATION_HNF ? SIGMA_READBACK_RAW : SIGMA_READBACK_NODE;
+
+	node->flags |= SIGMA_VISITING;
+
+	task_push(readback, SIGMA_READBACK_UNVISIT, node, NULL);
+
+	struct SigmaNode *spine = node;
+
+	while (spine->type == SIGMA_APPLICATION) {
+		task_push(readback, SIGMA_READBACK_APPLICATION, NULL, NULL);
+		task_push(readback, argument, spine->application.argument, NULL);
+
+		spine = sigma_forward(spine->application.function);
+	}
+
+	task_push(readback, SIGMA_READBACK_RAW, spine, NULL);
+
+	return 0;
+}
+
+int raw_step(struct SigmaMachine *machine, struct SigmaReadback *readback, struct SigmaNode *node, struct LambdaTerm **term)
+{
+	// Reads a node back as it stands, only pushing closures. Definitions are read back as their names, and cycles are cut
+	// with an ellipsis
+
+	// Once cancelled, the remaining subterms are replaced by placeholders so the partial term can be released
+
+	if (machine->stats.status != EVALUATION_CANCELLED && (++readback->visited & (EVALUATION_POLL_INTERVAL - 1)) == 0) {
+		evaluation_poll(&machine->stats);
+	}
+
+	if (machine->stats.status == EVALUATION_CANCELLED) {
+		*term = term_create(CHURCH_NUMERAL);
+		(*term)->expression.church_numeral = 0;
+
+		return 1;
+	}
+
+	node = node_follow(node);
+
+	while (node->type == SIGMA_CLOSURE) {
+		closure_push(machine, node);
+
+		node = node_follow(node);
+	}
+
+	if ((node->type == SIGMA_APPLICATION || node->type == SIGMA_ABSTRACTION) && (node->flags & SIGMA_VISITING)) {
+		*term = free_variable_readback(readback, "...", -1);
+
+		return 1;
+	}
+
+	switch (node->type) {
+	case SIGMA_APPLICATION:
+		node->flags |= SIGMA_VISITING;
+
+		task_push(readback, SIGMA_READBACK_UNVISIT, node, NULL);
+		task_push(readback, SIGMA_READBACK_APPLICATION, NULL, NULL);
+		task_push(readback, SIGMA_READBACK_RAW, node->application.argument, NULL);
+		task_push(readback, SIGMA_READBACK_RAW, node->application.function, NULL);
+
+		return 0;
+
+	case SIGMA_ABSTRACTION:
+		node->flags |= SIGMA_VISITING;
+
+		task_push(readback, SIGMA_READBACK_UNVISIT, node, NULL);
+
+		abstraction_step(readback, node, 1);
+
+		return 0;
+
+	case SIGMA_CHURCH_NUMERAL:
+		*term = term_create(CHURCH_NUMERAL);
+		(*term)->expression.church_numeral = node->church_numeral;
+
+		return 1;
+
+	case SIGMA_VARIABLE:
+		*term = variable_readback(readback, node->index);
+
+		return 1;
+
+	case SIGMA_FREE_VARIABLE:
+		*term = free_variable_readback(readback, node->free_variable->name, node->free_variable->subscript);
+
+		return 1;
+
+	case SIGMA_REFERENCE:
+		const struct Identifier *identifier = &node->reference.linkage->definition.identifier;
+
+		*term = free_variable_readback(readback, identifier->name, identifier->subscript);
+
+		return 1;
+
+	default:
+		*term = NULL;
+
+		return 1;
+	}
+}
+
+void abstraction_step(struct SigmaReadback *readback, struct SigmaNode *node, int raw)
+{
+	// Binders keep the name they were written with, and get a subscript whenever it is already taken by an enclosing
+	// binder or a name the result could refer to freely. The binder stays in scope until its body is complete
+
+	static const struct Identifier numeral_binder = {"x", -1};
+
+	const struct Identifier *hint = node->abstraction.bound_variable != NULL ? node->abstraction.bound_variable : &numeral_binder;
+
+	struct LambdaTerm *term = term_create(ABSTRACTION);
+
+	term->expression.abstraction.bound_variable = identifier_fresh(readback, hint);
+
+	scope_push(readback, term->expression.abstraction.bound_variable);
+
+	task_push(readback, SIGMA_READBACK_ABSTRACTION, node, term);
+	task_push(readback, raw ? SIGMA_READBACK_RAW : SIGMA_READBACK_NODE, node->abstraction.body, NULL);
+}
+
+void task_push(struct SigmaReadback *readback, enum SigmaReadbackTaskType type, struct SigmaNode *node, struct LambdaTerm *term)
+{
+	struct SigmaReadbackTask task = {type, node, term};
+
+	readback->tasks = array_push(readback->tasks, &readback->tasks_size, &readback->tasks_capacity, sizeof(task), &task);
+}
+
+struct LambdaTerm *variable_readback(struct SigmaReadback *readback, size_t index)
+{
+	// Indices past the enclosing binders only show up in a term cut short
+
+	if (index >= readback->scope_size) {
+		return free_variable_readback(readback, "x", (int)index);
+	}
+
+	struct LambdaTerm *term = term_create(BOUND_VARIABLE);
+
+	term->expression.variable = readback->identifiers[readback->scope_size - 1 - index];
+
+	return term;
+}
+
+struct LambdaTerm *free_variable_readback(struct SigmaReadback *readback, const char *name, int subscript)
+{
+	struct LambdaHandle *lambda = &readback->lambda;
+
+	struct LambdaTerm *term = term_create(FREE_VARIABLE);
+
+	for (size_t i = 0; i < lambda->free_variables_size; i++) {
+		struct Identifier free_variable = lambda->free_variables[i];
+
+		if (free_variable.subscript == subscript && strcmp(free_variable.name, name) == 0) {
+			term->expression.variable = free_variable;
+
+			return term;
+		}
+	}
+
+	if (lambda->free_variables_capacity == lambda->free_variables_size) {
+		// Scaling factor of 2
+
+		lambda->free_variables_capacity <<= 1;
+		lambda->free_variables = realloc(lambda->free_variables, sizeof(*lambda->free_variables) * lambda->free_variables_capacity);
+
+		if (lambda->free_variables == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	struct Identifier free_variable = {string_copy(name), subscript};
+
+	lambda->free_variables[lambda->free_variables_size++] = free_variable;
+
+	term->expression.variable = free_variable;
+
+	return term;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function free_variable_readback().\n");
+	exit(1);
+}
+
+struct Identifier identifier_fresh(struct SigmaReadback *readback, const struct Identifier *hint)
+{
+	int subscript = hint->subscript;
+
+	while (identifier_used(readback, hint->name, subscript)) {
+		subscript = subscript < 0 ? 1 : subscript + 1;
+	}
+
+	return (struct Identifier){string_copy(hint->name), subscript};
+}
+
+int identifier_used(struct SigmaReadback *readback, const char *name, int subscript)
+{
+	// Checking the enclosing binders
+
+	for (size_t i = 0; i < readback->scope_size; i++) {
+		struct Identifier bound_variable = readback->identifiers[i];
+
+		if (bound_variable.subscript == subscript && strcmp(bound_variable.name, name) == 0) {
+			return 1;
+		}
+	}
+
+	// Checking the names the result could refer to freely
+
+	size_t mask = readback->names_capacity - 1;
+	size_t index = name_hash(name, subscript) & mask;
+
+	while (readback->names[index] != NULL) {
+		const struct Identifier *identifier = readback->names[index];
+
+		if (identifier->subscript == subscript && strcmp(identifier->name, name) == 0) {
+			return 1;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	return 0;
+}
+
+void names_collect(struct SigmaReadback *readback, const struct Linker *linker)
+{
+	// Sized for a load factor of at most one half
+
+	size_t count = 0;
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		if (linker->linkages[i] != NULL) {
+			count += linker->linkages[i]->definition.free_variables_size + 1;
+		}
+	}
+
+	readback->names_capacity = INITIAL_CAPACITY;
+
+	while (readback->names_capacity < count << 1) {
+		readback->names_capacity <<= 1;
+	}
+
+	readback->names = calloc(readback->names_capacity, sizeof(*readback->names));
+
+	if (readback->names == NULL) {
+		goto fatal_error;
+	}
+
+	for (size_t i = 0; i < linker->capacity; i++) {
+		const struct Linkage *linkage = linker->linkages[i];
+
+		if (linkage == NULL) {
+			continue;
+		}
+
+		if (linkage->definition.identifier.name != NULL) {
+			names_insert(readback, &linkage->definition.identifier);
+		}
+
+		for (size_t j = 0; j < linkage->definition.free_variables_size; j++) {
+			names_insert(readback, linkage->definition.free_variables + j);
+		}
+	}
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: calloc() returned NULL in function names_collect().\n");
+	exit(1);
+}
+
+void names_insert(struct SigmaReadback *readback, const struct Identifier *identifier)
+{
+	size_t mask = readback->names_capacity - 1;
+	size_t index = name_hash(identifier->name, identifier->subscript) & mask;
+
+	while (readback->names[index] != NULL) {
+		const struct Identifier *entry = readback->names[index];
+
+		if (entry->subscript == identifier->subscript && strcmp(entry->name, identifier->name) == 0) {
+			return;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	readback->names[index] = identifier;
+}
+
+size_t name_hash(const char *name, int subscript)
+{
+	// FNV-1a, as in the hashmap
+
+	size_t hash = 14695981039346656037UL;
+
+	for (const char *c = name; *c != '\0'; c++) {
+		hash ^= (size_t)(unsigned char)*c;
+		hash *= 1099511628211UL;
+	}
+
+	return 31 * hash + (size_t)subscript;
+}
+
+// Helpers
+
+struct SigmaNode *node_create(struct SigmaMachine *machine, enum SigmaNodeType type)
+{
+	struct SigmaNode *node = arena_alloc(&machine->arena, sizeof(*node));
+
+	node->type = type;
+	node->flags = 0;
+
+	machine->stats.nodes++;
+
+	return node;
+}
+
+struct SigmaNode *sigma_forward(struct SigmaNode *node)
+{
+	// Follows indirections, halving the path on the way, and unfolded definitions
+
+	while (1) {
+		if (node->type == SIGMA_INDIRECTION) {
+			struct SigmaNode *target = node->indirection;
+
+			if (target->type == SIGMA_INDIRECTION) {
+				node->indirection = target->indirection;
+			}
+
+			node = target;
+
+			continue;
+		}
+
+		if (node->type == SIGMA_REFERENCE && node->reference.unfolded != NULL) {
+			node = node->reference.unfolded;
+
+			continue;
+		}
+
+		return node;
+	}
+}
+
+struct SigmaNode *node_follow(struct SigmaNode *node)
+{
+	// Follows indirections only, so that a definition is still known by its name
+
+	while (node->type == SIGMA_INDIRECTION) {
+		node = node->indirection;
+	}
+
+	return node;
+}
+
+struct SigmaNode *variable_get(struct SigmaMachine *machine, size_t index)
+{
+	if (index >= machine->variables_size) {
+		// Scaling factor of 2
+
+		size_t size = machine->variables_size == 0 ? INITIAL_CAPACITY : machine->variables_size;
+
+		while (size <= index) {
+			size <<= 1;
+		}
+
+		machine->variables = realloc(machine->variables, sizeof(*machine->variables) * size);
+
+		if (machine->variables == NULL) {
+			goto fatal_error;
+		}
+
+		memset(machine->variables + machine->variables_size, 0, sizeof(*machine->variables) * (size - machine->variables_size));
+
+		machine->variables_size = size;
+	}
+
+	if (machine->variables[index] == NULL) {
+		machine->variables[index] = node_create(machine, SIGMA_VARIABLE);
+		machine->variables[index]->index = index;
+	}
+
+	return machine->variables[index];
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function variable_get().\n");
+	exit(1);
+}
+
+struct SigmaNode *closure_create(struct SigmaMachine *machine, struct SigmaNode *term, struct Substitution *substitution)
+{
+	if ((term->flags & SIGMA_CLOSED) || substitution == machine->identity) {
+		return term;
+	}
+
+	// A variable is looked up at once as long as only conses and a shift stand in the way, which costs no more than the
+	// closure it saves
+
+	if (term->type == SIGMA_VARIABLE) {
+		size_t index = term->index;
+
+		while (substitution->type == SUBSTITUTION_CONS && index > 0) {
+			substitution = substitution->cons.next;
+			index--;
+		}
+
+		if (substitution->type == SUBSTITUTION_CONS) {
+			return substitution->cons.term;
+		}
+
+		if (substitution->type == SUBSTITUTION_SHIFT) {
+			return variable_get(machine, index + substitution->shift);
+		}
+
+		term = variable_get(machine, index);
+	}
+
+	struct SigmaNode *node = node_create(machine, SIGMA_CLOSURE);
+
+	node->closure.term = term;
+	node->closure.substitution = substitution;
+
+	return node;
+}
+
+struct Substitution *substitution_create(struct SigmaMachine *machine, enum SubstitutionType type)
+{
+	struct Substitution *substitution = arena_alloc(&machine->arena, sizeof(*substitution));
+
+	substitution->type = type;
+
+	machine->stats.nodes++;
+
+	return substitution;
+}
+
+struct Substitution *shift_create(struct SigmaMachine *machine, size_t shift)
+{
+	if (shift == 0 && machine->identity != NULL) {
+		return machine->identity;
+	}
+
+	if (shift == 1 && machine->shift != NULL) {
+		return machine->shift;
+	}
+
+	struct Substitution *substitution = substitution_create(machine, SUBSTITUTION_SHIFT);
+
+	substitution->shift = shift;
+
+	return substitution;
+}
+
+struct Substitution *cons_create(struct SigmaMachine *machine, struct SigmaNode *term, struct Substitution *next)
+{
+	struct Substitution *substitution = substitution_create(machine, SUBSTITUTION_CONS);
+
+	substitution->cons.term = term;
+	substitution->cons.next = next;
+
+	return substitution;
+}
+
+void scope_push(struct SigmaReadback *readback, struct Identifier identifier)
+{
+	if (readback->scope_size == readback->scope_capacity) {
+		// Scaling factor of 2
+
+		readback->scope_capacity = readback->scope_capacity == 0 ? INITIAL_CAPACITY : readback->scope_capacity << 1;
+		readback->identifiers = realloc(readback->identifiers, sizeof(*readback->identifiers) * readback->scope_capacity);
+
+		if (readback->identifiers == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	readback->identifiers[readback->scope_size++] = identifier;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function scope_push().\n");
+	exit(1);
+}
+
+void stack_push(struct SigmaNode ***stack, size_t *size, size_t *capacity, struct SigmaNode *node)
+{
+	if (*size == *capacity) {
+		// Scaling factor of 2
+
+		*capacity = *capacity == 0 ? INITIAL_CAPACITY : *capacity << 1;
+		*stack = realloc(*stack, sizeof(**stack) * *capacity);
+
+		if (*stack == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	(*stack)[(*size)++] = node;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function stack_push().\n");
+	exit(1);
+}
+
+void pending_push(struct SigmaMachine *machine, struct Substitution *substitution)
+{
+	if (machine->pending_size == machine->pending_capacity) {
+		// Scaling factor of 2
+
+		machine->pending_capacity = machine->pending_capacity == 0 ? INITIAL_CAPACITY : machine->pending_capacity << 1;
+		machine->pending = realloc(machine->pending, sizeof(*machine->pending) * machine->pending_capacity);
+
+		if (machine->pending == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	machine->pending[machine->pending_size++] = substitution;
+
+	return;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function pending_push().\n");
+	exit(1);
+}
+
+struct LambdaTerm *term_create(enum ExpressionType type)
+{
+	struct LambdaTerm *term = malloc(sizeof(*term));
+
+	if (term == NULL) {
+		goto fatal_error;
+	}
+
+	term->type = type;
+
+	return term;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function term_create().\n");
+	exit(1);
+}
+
+char *string_copy(const char *string)
+{
+	size_t size = strlen(string) + 1;
+
+	char *copy = malloc(size);
+
+	if (copy == NULL) {
+		goto fatal_error;
+	}
+
+	memcpy(copy, string, size);
+
+	return copy;
+
+	fatal_error:
+
+	printf("Fatal error: malloc() returned NULL in function string_copy().\n");
+	exit(1);
+}
+
+void *array_push(void *array, size_t *size, size_t *capacity, size_t element_size, const void *element)
+{
+	if (*size == *capacity) {
+		// Scaling factor of 2
+
+		*capacity = *capacity == 0 ? INITIAL_CAPACITY : *capacity << 1;
+
+		array = realloc(array, element_size * *capacity);
+
+		if (array == NULL) {
+			goto fatal_error;
+		}
+	}
+
+	memcpy((char *)array + *size * element_size, element, element_size);
+	(*size)++;
+
+	return array;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function array_push().\n");
+	exit(1);
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <evaluation.h>
+#include <hashmap.h>
+#include <lambda.h>
+
+// Explicit substitution backend
+// Terms use de Bruijn indices, and a beta step doesn't walk the body of the abstraction: it only wraps it in a closure
+// M[s] pairing it with a substitution, the argument consed onto the identity. Closures are pushed inward one constructor
+// at a time, and only once reduction or readback examines them:
+//	(M N)[s] = M[s] N[s]		(λM)[s] = λM[0·(s∘↑)]		M[s][t] = M[s∘t]
+//	0[N·s] = N			n+1[N·s] = n[s]			n[↑k] = n+k
+// Pushing a closure overwrites it in place, so a closure shared by several occurrences is pushed once and the parts
+// nobody looks at are never substituted. Adjacent substitutions are composed rather than applied one after the other,
+// and compositions are simplified as they are built: shifts cancel conses and add up, and a lifted substitution
+// composed with a cons takes the argument at once. Subterms without loose indices, found at compilation, are shared
+// by every substitution as they are.
+// Arguments are shared between their occurrences and reduced in place, so reduction is lazy. Every mode reduces in
+// normal order, EVALUATION_CBV included.
+
+struct LambdaHandle sigma_evaluate(
+	struct LambdaHandle lambda, const struct HashMap *definitions,
+	enum EvaluationMode mode, struct EvaluationStats *stats
+);	// Evaluate a term to the normal form of mode with explicit substitutions
\ No newline at end of file
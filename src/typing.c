@@ -0,0 +1,455 @@
+#include <typing.h>
+#include <string.h>
+
+#define TYPE_NAMES_SIZE 12
+
+// Variables of the enclosing abstractions, innermost last, like the scope of term_compile()
+
+struct TypeBinding {
+	const struct Identifier *variable;
+	struct Type *type;
+};
+
+// Definitions are typed once per inference, then instantiated at every reference
+
+struct TypedDefinition {
+	const struct LambdaTerm *term;
+	struct Type *type;		// NULL while the definition is being typed, or when it has no type
+
+	int typing;			// The definition is being typed, so referring to it again is recursion
+};
+
+struct Inference {
+	struct TypeInference *result;
+
+	const struct HashMap *definitions;
+
+	struct TypeBinding *scope;
+	size_t scope_size;
+	size_t scope_capacity;
+	size_t scope_base;		// First binding of the definition being typed, those below belong to its referrer
+
+	struct TypeBinding *unknowns;	// Names which aren't defined, one type variable each
+	size_t unknowns_size;
+	size_t unknowns_capacity;
+
+	struct TypedDefinition *typed;
+	size_t typed_size;
+	size_t typed_capacity;
+
+	struct Type **copies;		// Pairs of generalized and fresh variables during instantiation
+	size_t copies_size;
+	size_t copies_capacity;
+};
+
+static const char *type_names[TYPE_NAMES_SIZE] = {"α", "β", "γ", "δ", "ε", "ζ", "η", "θ", "ι", "κ", "μ", "ν"};
+
+static struct Type *term_infer(struct Inference *inference, const struct LambdaTerm *term);
+static struct Type *definition_infer(struct Inference *inference, const struct Identifier *identifier);
+static struct Type *unknown_infer(struct Inference *inference, const struct Identifier *identifier);
+
+static struct Type *type_variable(struct Inference *inference);
+static struct Type *type_arrow(struct Inference *inference, struct Type *from, struct Type *to);
+static struct Type *type_resolve(struct Type *type);
+static struct Type *type_instantiate(struct Inference *inference, struct Type *type);
+static struct Type *type_copy(struct Inference *inference, struct Type *type);
+
+static int type_unify(struct Type *left, struct Type *right);
+static int type_occurs(struct Type *variable, struct Type *type);
+
+static void type_print(FILE *stream, const struct Type *type, const struct Type ***names, size_t *names_size, size_t *names_capacity);
+
+static void bindings_push(struct TypeBinding **bindings, size_t *size, size_t *capacity, const struct Identifier *variable, struct Type *type);
+static void *array_grow(void *array, size_t *capacity, size_t element);
+
+struct TypeInference type_infer(struct LambdaHandle lambda, const struct HashMap *definitions)
+{
+	struct TypeInference result = {0};
+
+	result.arena = arena_create();
+	result.closed = 1;
+
+	struct Inference inference = {0};
+
+	inference.result = &result;
+	inference.definitions = definitions;
+
+	struct Type *type = term_infer(&inference, lambda.term);
+
+	result.type = type == NULL ? NULL : type_resolve(type);
+
+	free(inference.scope);
+	free(inference.unknowns);
+	free(inference.typed);
+	free(inference.copies);
+
+	return result;
+}
+
+void type_inference_destroy(struct TypeInference inference)
+{
+	arena_destroy(inference.arena);
+}
+
+enum TypeShape type_shape(const struct TypeInference *inference)
+{
+	if (inference->type == NULL || !inference->closed) {
+		return TYPE_SHAPE_OTHER;
+	}
+
+	// Both shapes have to match exactly: a more general type such as α → α has η-short inhabitants as well
+
+	struct Type *type = type_resolve(inference->type);
+
+	if (type->kind != TYPE_ARROW) {
+		return TYPE_SHAPE_OTHER;
+	}
+
+	struct Type *from = type_resolve(type->arrow.from);
+	struct Type *to = type_resolve(type->arrow.to);
+
+	if (to->kind != TYPE_ARROW) {
+		return TYPE_SHAPE_OTHER;
+	}
+
+	struct Type *argument = type_resolve(to->arrow.from);
+	struct Type *result = type_resolve(to->arrow.to);
+
+	if (argument->kind != TYPE_VARIABLE || argument != result) {
+		return TYPE_SHAPE_OTHER;
+	}
+
+	if (from == argument) {
+		return TYPE_SHAPE_BOOLEAN;
+	}
+
+	if (from->kind == TYPE_ARROW && type_resolve(from->arrow.from) == argument && type_resolve(from->arrow.to) == argument) {
+		return TYPE_SHAPE_NUMERAL;
+	}
+
+	return TYPE_SHAPE_OTHER;
+}
+
+void type_fprint(FILE *stream, const struct Type *type)
+{
+	const struct Type **names = NULL;
+	size_t names_size = 0;
+	size_t names_capacity = 0;
+
+	type_print(stream, type, &names, &names_size, &names_capacity);
+
+	free(names);
+}
+
+struct Type *term_infer(struct Inference *inference, const struct LambdaTerm *term)
+{
+	switch (term->type) {
+	case FREE_VARIABLE:
+		return definition_infer(inference, &term->expression.variable);
+
+	case BOUND_VARIABLE:
+		// Bound variables share the name string of their abstraction, but only the innermost binding of a name counts
+
+		for (size_t i = inference->scope_size; i > inference->scope_base; i--) {
+			const struct Identifier *variable = inference->scope[i - 1].variable;
+
+			if (variable->subscript == term->expression.variable.subscript && strcmp(variable->name, term->expression.variable.name) == 0) {
+				return inference->scope[i - 1].type;
+			}
+		}
+
+		return unknown_infer(inference, &term->expression.variable);
+
+	case ABSTRACTION: {
+		struct Type *from = type_variable(inference);
+
+		bindings_push(&inference->scope, &inference->scope_size, &inference->scope_capacity, &term->expression.abstraction.bound_variable, from);
+
+		struct Type *to = term_infer(inference, term->expression.abstraction.body);
+
+		inference->scope_size--;
+
+		return to == NULL ? NULL : type_arrow(inference, from, to);
+	}
+
+	case APPLICATION: {
+		struct Type *function = term_infer(inference, term->expression.application.function);
+
+		if (function == NULL) {
+			return NULL;
+		}
+
+		struct Type *argument = term_infer(inference, term->expression.application.argument);
+
+		if (argument == NULL) {
+			return NULL;
+		}
+
+		struct Type *result = type_variable(inference);
+
+		if (!type_unify(function, type_arrow(inference, argument, result))) {
+			snprintf(inference->result->error, TYPE_ERROR_SIZE, "a term is applied to itself, which needs an infinite type");
+
+			return NULL;
+		}
+
+		return result;
+	}
+
+	case CHURCH_NUMERAL: {
+		struct Type *type = type_variable(inference);
+		struct Type *function = type_arrow(inference, type, type);
+
+		return type_arrow(inference, function, function);
+	}
+
+	default:
+		snprintf(inference->result->error, TYPE_ERROR_SIZE, "the term is incomplete");
+
+		return NULL;
+	}
+}
+
+struct Type *definition_infer(struct Inference *inference, const struct Identifier *identifier)
+{
+	struct LambdaHandle definition = inference->definitions == NULL ? (struct LambdaHandle){0} : hashmap_get_original(inference->definitions, *identifier);
+
+	if (definition.term == NULL) {
+		return unknown_infer(inference, identifier);
+	}
+
+	for (size_t i = 0; i < inference->typed_size; i++) {
+		struct TypedDefinition *typed = &inference->typed[i];
+
+		if (typed->term != definition.term) {
+			continue;
+		}
+
+		if (typed->typing) {
+			snprintf(inference->result->error, TYPE_ERROR_SIZE, "%s is recursive", identifier->name);
+
+			return NULL;
+		}
+
+		return typed->type == NULL ? NULL : type_instantiate(inference, typed->type);
+	}
+
+	// Definitions are closed over their own abstractions, so the scope of the referrer is hidden while typing one
+
+	if (inference->typed_capacity == inference->typed_size) {
+		inference->typed = array_grow(inference->typed, &inference->typed_capacity, sizeof(*inference->typed));
+	}
+
+	size_t position = inference->typed_size++;
+
+	inference->typed[position] = (struct TypedDefinition){definition.term, NULL, 1};
+
+	size_t scope_base = inference->scope_base;
+
+	inference->scope_base = inference->scope_size;
+
+	struct Type *type = term_infer(inference, definition.term);
+
+	inference->scope_base = scope_base;
+
+	inference->typed[position].type = type;
+	inference->typed[position].typing = 0;
+
+	return type == NULL ? NULL : type_instantiate(inference, type);
+}
+
+struct Type *unknown_infer(struct Inference *inference, const struct Identifier *identifier)
+{
+	inference->result->closed = 0;
+
+	for (size_t i = 0; i < inference->unknowns_size; i++) {
+		const struct Identifier *unknown = inference->unknowns[i].variable;
+
+		if (unknown->subscript == identifier->subscript && strcmp(unknown->name, identifier->name) == 0) {
+			return inference->unknowns[i].type;
+		}
+	}
+
+	struct Type *type = type_variable(inference);
+
+	bindings_push(&inference->unknowns, &inference->unknowns_size, &inference->unknowns_capacity, identifier, type);
+
+	return type;
+}
+
+struct Type *type_variable(struct Inference *inference)
+{
+	struct Type *type = arena_alloc(&inference->result->arena, sizeof(*type));
+
+	type->kind = TYPE_VARIABLE;
+	type->binding = NULL;
+
+	return type;
+}
+
+struct Type *type_arrow(struct Inference *inference, struct Type *from, struct Type *to)
+{
+	struct Type *type = arena_alloc(&inference->result->arena, sizeof(*type));
+
+	type->kind = TYPE_ARROW;
+	type->arrow.from = from;
+	type->arrow.to = to;
+
+	return type;
+}
+
+struct Type *type_resolve(struct Type *type)
+{
+	while (type->kind == TYPE_VARIABLE && type->binding != NULL) {
+		type = type->binding;
+	}
+
+	return type;
+}
+
+struct Type *type_instantiate(struct Inference *inference, struct Type *type)
+{
+	// Every variable left free in the type of a definition is generalized, since definitions have no enclosing scope
+
+	inference->copies_size = 0;
+
+	return type_copy(inference, type);
+}
+
+struct Type *type_copy(struct Inference *inference, struct Type *type)
+{
+	type = type_resolve(type);
+
+	if (type->kind == TYPE_ARROW) {
+		struct Type *from = type_copy(inference, type->arrow.from);
+		struct Type *to = type_copy(inference, type->arrow.to);
+
+		return type_arrow(inference, from, to);
+	}
+
+	for (size_t i = 0; i < inference->copies_size; i += 2) {
+		if (inference->copies[i] == type) {
+			return inference->copies[i + 1];
+		}
+	}
+
+	if (inference->copies_capacity < inference->copies_size + 2) {
+		inference->copies = array_grow(inference->copies, &inference->copies_capacity, sizeof(*inference->copies));
+	}
+
+	struct Type *copy = type_variable(inference);
+
+	inference->copies[inference->copies_size++] = type;
+	inference->copies[inference->copies_size++] = copy;
+
+	return copy;
+}
+
+int type_unify(struct Type *left, struct Type *right)
+{
+	left = type_resolve(left);
+	right = type_resolve(right);
+
+	if (left == right) {
+		return 1;
+	}
+
+	if (left->kind == TYPE_VARIABLE || right->kind == TYPE_VARIABLE) {
+		struct Type *variable = left->kind == TYPE_VARIABLE ? left : right;
+		struct Type *type = variable == left ? right : left;
+
+		if (type_occurs(variable, type)) {
+			return 0;
+		}
+
+		variable->binding = type;
+
+		return 1;
+	}
+
+	return type_unify(left->arrow.from, right->arrow.from) && type_unify(left->arrow.to, right->arrow.to);
+}
+
+int type_occurs(struct Type *variable, struct Type *type)
+{
+	type = type_resolve(type);
+
+	if (type->kind == TYPE_VARIABLE) {
+		return type == variable;
+	}
+
+	return type_occurs(variable, type->arrow.from) || type_occurs(variable, type->arrow.to);
+}
+
+void type_print(FILE *stream, const struct Type *type, const struct Type ***names, size_t *names_size, size_t *names_capacity)
+{
+	type = type_resolve((struct Type *)type);
+
+	if (type->kind == TYPE_ARROW) {
+		// Arrows associate to the right, so only arrows taken as arguments need parentheses
+
+		const struct Type *from = type_resolve(type->arrow.from);
+
+		if (from->kind == TYPE_ARROW) {
+			fprintf(stream, "(");
+			type_print(stream, from, names, names_size, names_capacity);
+			fprintf(stream, ")");
+		} else {
+			type_print(stream, from, names, names_size, names_capacity);
+		}
+
+		fprintf(stream, " → ");
+		type_print(stream, type->arrow.to, names, names_size, names_capacity);
+
+		return;
+	}
+
+	size_t index = 0;
+
+	while (index < *names_size && (*names)[index] != type) {
+		index++;
+	}
+
+	if (index == *names_size) {
+		if (*names_capacity == *names_size) {
+			*names = array_grow(*names, names_capacity, sizeof(**names));
+		}
+
+		(*names)[(*names_size)++] = type;
+	}
+
+	if (index < TYPE_NAMES_SIZE) {
+		fprintf(stream, "%s", type_names[index]);
+	} else {
+		fprintf(stream, "τ%zu", index - TYPE_NAMES_SIZE + 1);
+	}
+}
+
+void bindings_push(struct TypeBinding **bindings, size_t *size, size_t *capacity, const struct Identifier *variable, struct Type *type)
+{
+	if (*capacity == *size) {
+		*bindings = array_grow(*bindings, capacity, sizeof(**bindings));
+	}
+
+	(*bindings)[(*size)++] = (struct TypeBinding){variable, type};
+}
+
+void *array_grow(void *array, size_t *capacity, size_t element)
+{
+	// Scaling factor of 2
+
+	*capacity = *capacity == 0 ? 16 : *capacity << 1;
+
+	array = realloc(array, element * *capacity);
+
+	if (array == NULL) {
+		goto fatal_error;
+	}
+
+	return array;
+
+	fatal_error:
+
+	printf("Fatal error: realloc() returned NULL in function array_grow().\n");
+	exit(1);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <arena.h>
+#include <hashmap.h>
+#include <lambda.h>
+#include <stdio.h>
+
+// Simple type inference
+// Hindley-Milner inference with arrows and type variables only, run on the terms as parsed. Every reference to a
+// definition instantiates the type of the definition with fresh variables, as a let binding would, so that ID can be
+// used at two types in the same term. Recursive definitions and self applications have no simple type, and names which
+// aren't defined get one type variable each, which leaves the term open.
+// Inference never changes how a term is evaluated unless it is asked for, see native.h.
+
+#define TYPE_ERROR_SIZE 128
+
+enum TypeKind {
+	TYPE_VARIABLE,
+	TYPE_ARROW
+};
+
+struct Type {
+	enum TypeKind kind;
+
+	union {
+		struct Type *binding;		// Type a variable was unified with, NULL while it is free
+
+		struct TypeArrow {
+			struct Type *from;
+			struct Type *to;
+		} arrow;
+	};
+};
+
+// Closed terms of these principal types compute Church numerals and booleans, whatever they are made of
+
+enum TypeShape {
+	TYPE_SHAPE_OTHER,
+	TYPE_SHAPE_NUMERAL,	// (α → α) → α → α
+	TYPE_SHAPE_BOOLEAN	// α → α → α
+};
+
+struct TypeInference {
+	struct Arena arena;		// Every type built by the inference
+
+	struct Type *type;		// Principal type of the term, NULL when it has none
+	int closed;			// Every free variable names a definition
+
+	char error[TYPE_ERROR_SIZE];	// Why the term has no type
+};
+
+struct TypeInference type_infer(struct LambdaHandle lambda, const struct HashMap *definitions);	// Infer the principal type of a term, typing the definitions it uses as written
+void type_inference_destroy(struct TypeInference inference);					// Release every type of the inference
+
+enum TypeShape type_shape(const struct TypeInference *inference);	// Shape of the principal type of a closed term
+void type_fprint(FILE *stream, const struct Type *type);		// Print a type with variables named in order of appearance
\ No newline at end of file
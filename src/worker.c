@@ -0,0 +1,193 @@
+#include <worker.h>
+#include <evaluation.h>
+#include <stdio.h>
+
+#ifdef __linux__
+
+#include <malloc.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+// The query being run, shared between the worker thread and the terminal thread under lock
+
+struct Worker {
+	WorkerTask task;
+	struct HashMap *hashmap;
+	char *input;
+	size_t size;
+
+	int result;
+	int done;
+
+	int progress;		// Set while the progress line may be drawn, cleared once the task prints
+	int shown;		// The progress line is on screen
+
+	pthread_mutex_t lock;
+	pthread_cond_t finished;
+};
+
+static struct Worker worker = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.finished = PTHREAD_COND_INITIALIZER
+};
+
+static void *worker_main(void *argument);
+static void interrupt_handle(int signal_number);
+
+static double elapsed_milliseconds(struct timespec begin, struct timespec end);
+
+void worker_install(void)
+{
+	// Restarting system calls keeps the prompt waiting on fgets() when interrupted
+
+	struct sigaction action = {0};
+
+	action.sa_handler = interrupt_handle;
+	action.sa_flags = SA_RESTART;
+
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, NULL);
+}
+
+int worker_run(WorkerTask task, struct HashMap *hashmap, char *input, size_t size)
+{
+	atomic_store(&evaluation_control.cancel, 0);
+	atomic_store(&evaluation_control.beta_steps, 0);
+	atomic_store(&evaluation_control.nodes, 0);
+
+	worker.task = task;
+	worker.hashmap = hashmap;
+	worker.input = input;
+	worker.size = size;
+	worker.done = 0;
+	worker.shown = 0;
+
+	// The progress line only makes sense on a terminal, it would end up in the output otherwise
+
+	worker.progress = isatty(STDERR_FILENO);
+
+	pthread_attr_t attributes;
+	pthread_t thread;
+
+	pthread_attr_init(&attributes);
+	pthread_attr_setstacksize(&attributes, WORKER_STACK_SIZE);
+
+	int created = pthread_create(&thread, &attributes, worker_main, NULL) == 0;
+
+	pthread_attr_destroy(&attributes);
+
+	if (!created) {
+		worker.progress = 0;
+
+		return task(hashmap, input, size);
+	}
+
+	struct timespec begin, now;
+
+	clock_gettime(CLOCK_REALTIME, &begin);
+
+	pthread_mutex_lock(&worker.lock);
+
+	while (!worker.done) {
+		clock_gettime(CLOCK_REALTIME, &now);
+
+		struct timespec deadline = now;
+
+		deadline.tv_nsec += PROGRESS_PERIOD * 1000000L;
+
+		if (deadline.tv_nsec >= 1000000000L) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+
+		pthread_cond_timedwait(&worker.finished, &worker.lock, &deadline);
+
+		clock_gettime(CLOCK_REALTIME, &now);
+
+		if (worker.done || !worker.progress || elapsed_milliseconds(begin, now) < PROGRESS_DELAY) {
+			continue;
+		}
+
+		fprintf(stderr, "\r\033[K(beta: %zu, nodes: %zu%s)",
+			atomic_load(&evaluation_control.beta_steps), atomic_load(&evaluation_control.nodes),
+			atomic_load(&evaluation_control.cancel) ? ", cancelling" : "");
+
+		worker.shown = 1;
+	}
+
+	pthread_mutex_unlock(&worker.lock);
+
+	pthread_join(thread, NULL);
+
+	worker_progress_end();
+
+	// The arena of a cancelled evaluation is already released, this hands it back to the system as well
+
+	if (atomic_load(&evaluation_control.cancel)) {
+		malloc_trim(0);
+	}
+
+	return worker.result;
+}
+
+void worker_progress_end(void)
+{
+	pthread_mutex_lock(&worker.lock);
+
+	if (worker.shown) {
+		fprintf(stderr, "\r\033[K");
+	}
+
+	worker.progress = 0;
+	worker.shown = 0;
+
+	pthread_mutex_unlock(&worker.lock);
+}
+
+void *worker_main(void *argument)
+{
+	(void)argument;
+
+	int result = worker.task(worker.hashmap, worker.input, worker.size);
+
+	pthread_mutex_lock(&worker.lock);
+
+	worker.result = result;
+	worker.done = 1;
+
+	pthread_cond_signal(&worker.finished);
+	pthread_mutex_unlock(&worker.lock);
+
+	return NULL;
+}
+
+void interrupt_handle(int signal_number)
+{
+	(void)signal_number;
+
+	atomic_store(&evaluation_control.cancel, 1);
+}
+
+double elapsed_milliseconds(struct timespec begin, struct timespec end)
+{
+	return (double)(end.tv_sec - begin.tv_sec) * 1e3 + (double)(end.tv_nsec - begin.tv_nsec) / 1e6;
+}
+
+#else
+
+void worker_install(void)
+{
+}
+
+int worker_run(WorkerTask task, struct HashMap *hashmap, char *input, size_t size)
+{
+	return task(hashmap, input, size);
+}
+
+void worker_progress_end(void)
+{
+}
+
+#endif
\ No newline at end of file
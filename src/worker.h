@@ -0,0 +1,18 @@
+#pragma once
+
+#include <hashmap.h>
+
+// Background execution of REPL queries
+// Every query runs on a worker thread with a large stack while the main thread stays on the terminal: SIGINT cancels
+// the running evaluation through evaluation_control instead of ending the session, and a progress line shows the beta
+// steps and nodes of queries that take a while. Elsewhere than on Linux, queries run on the calling thread.
+
+#define WORKER_STACK_SIZE ((size_t)512 << 20)	// Deep graphs are read back and printed recursively
+#define PROGRESS_DELAY 500			// Milliseconds before the progress line shows up
+#define PROGRESS_PERIOD 100			// Milliseconds between two refreshes of the progress line
+
+typedef int (*WorkerTask)(struct HashMap *hashmap, char *input, size_t size);
+
+void worker_install(void);								// Route SIGINT to the cancellation of the running query
+int worker_run(WorkerTask task, struct HashMap *hashmap, char *input, size_t size);	// Run task on the worker thread and return its result
+void worker_progress_end(void);								// Erase the progress line for good, called by tasks before printing
\ No newline at end of file
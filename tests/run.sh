@@ -0,0 +1,17 @@
+#!/bin/sh
+# Feeds every tests/*.lam to the REPL and compares what it prints with the matching tests/*.out
+
+status=0
+
+for input in tests/*.lam; do
+	expected="${input%.lam}.out"
+
+	if ./lambda < "$input" 2>&1 | cmp -s - "$expected"; then
+		echo "PASS $input"
+	else
+		echo "FAIL $input"
+		status=1
+	fi
+done
+
+exit $status